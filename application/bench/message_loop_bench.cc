@@ -0,0 +1,285 @@
+/*
+ * Copyright 2025 wtcat
+ */
+
+// message_loop_bench posts tasks from several threads to one consumer.
+// It measures the incoming queue of MessageLoop against the locked queue it
+// replaced, then the whole PostTask path of a running MessageLoop, with a
+// Closure from base::Bind and with a base::OnceClosure. The result is printed
+// as json.
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/base_time.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/incoming_task_queue.h"
+#include "base/json/json_writer.h"
+#include "base/message_loop.h"
+#include "base/once_closure.h"
+#include "base/pending_task.h"
+#include "base/stl_util.h"
+#include "base/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/threading/thread.h"
+#include "base/values.h"
+
+namespace {
+
+void Noop() {
+}
+
+// The incoming queue of MessageLoop before it became lock-free
+class LockedTaskQueue {
+public:
+    LockedTaskQueue() {}
+
+    bool Push(base::PendingTask* pending_task) {
+        base::AutoLock locked(lock_);
+        bool was_empty = queue_.empty();
+        queue_.push(std::move(*pending_task));
+        return was_empty;
+    }
+
+    bool ReloadWorkQueue(base::TaskQueue* work_queue) {
+        base::AutoLock locked(lock_);
+        if (queue_.empty())
+            return false;
+        queue_.Swap(work_queue);
+        return true;
+    }
+
+private:
+    base::Lock lock_;
+    base::TaskQueue queue_;
+
+    DISALLOW_COPY_AND_ASSIGN(LockedTaskQueue);
+};
+
+// Runs |post| |tasks| times once all the producers are started
+class Producer : public base::DelegateSimpleThread::Delegate {
+public:
+    Producer(const base::Callback<void(const base::Closure&)>& post,
+        int tasks, const std::atomic<bool>* go)
+        : post_(post), tasks_(tasks), go_(go),
+          // Every producer has its own closure, so that they don't share
+          // its reference count
+          task_(base::Bind(&Noop)) {
+    }
+
+    virtual void Run() OVERRIDE {
+        while (!go_->load(std::memory_order_acquire))
+            base::PlatformThread::YieldCurrentThread();
+        for (int i = 0; i < tasks_; i++)
+            post_.Run(task_);
+    }
+
+private:
+    base::Callback<void(const base::Closure&)> post_;
+    int tasks_;
+    const std::atomic<bool>* go_;
+    base::Closure task_;
+};
+
+class ProducerGroup {
+public:
+    ProducerGroup(const base::Callback<void(const base::Closure&)>& post,
+        int producers, int tasks) : go_(false) {
+        for (int i = 0; i < producers; i++) {
+            Producer* producer = new Producer(post, tasks, &go_);
+            producers_.push_back(producer);
+            threads_.push_back(new base::DelegateSimpleThread(producer, "producer"));
+            threads_.back()->Start();
+        }
+    }
+
+    ~ProducerGroup() {
+        for (size_t i = 0; i < threads_.size(); i++)
+            threads_[i]->Join();
+        STLDeleteElements(&threads_);
+        STLDeleteElements(&producers_);
+    }
+
+    void Go() { go_.store(true, std::memory_order_release); }
+
+private:
+    std::atomic<bool> go_;
+    std::vector<Producer*> producers_;
+    std::vector<base::DelegateSimpleThread*> threads_;
+};
+
+template <class Queue>
+class QueueBench {
+public:
+    QueueBench() : wakeups_(0) {}
+
+    // Returns the time to carry all the tasks to the consumer
+    base::TimeDelta Run(int producers, int tasks) {
+        const int64 total = (int64)producers * tasks;
+        base::TaskQueue work_queue;
+        int64 taken = 0;
+
+        wakeups_.store(0);
+        ProducerGroup group(base::Bind(&QueueBench::Post, base::Unretained(this)),
+            producers, tasks);
+
+        base::TimeTicks start = base::TimeTicks::Now();
+        group.Go();
+        while (taken < total) {
+            if (!queue_.ReloadWorkQueue(&work_queue)) {
+                base::PlatformThread::YieldCurrentThread();
+                continue;
+            }
+            while (!work_queue.empty()) {
+                work_queue.pop();
+                taken++;
+            }
+        }
+        return base::TimeTicks::Now() - start;
+    }
+
+    int64 wakeups() const { return wakeups_.load(); }
+
+private:
+    void Post(const base::Closure& task) {
+        base::PendingTask pending_task(FROM_HERE, task);
+        if (queue_.Push(&pending_task))
+            wakeups_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Queue queue_;
+    std::atomic<int64> wakeups_;
+};
+
+// Posts a new task every time, bound with base::Bind() or, if |kOnce|, with
+// base::BindOnce()
+template <bool kOnce>
+class MessageLoopBench {
+public:
+    MessageLoopBench() : done_(false, false), count_(0), total_(0) {}
+
+    base::TimeDelta Run(int producers, int tasks) {
+        base::Thread thread("bench_loop");
+        thread.Start();
+        loop_ = thread.message_loop();
+        count_ = 0;
+        total_ = (int64)producers * tasks;
+
+        base::TimeTicks start;
+        {
+            ProducerGroup group(base::Bind(&MessageLoopBench::Post, base::Unretained(this)),
+                producers, tasks);
+            start = base::TimeTicks::Now();
+            group.Go();
+            done_.Wait();
+        }
+        base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+        thread.Stop();
+        return elapsed;
+    }
+
+    // The wake ups of the pump aren't counted
+    int64 wakeups() const { return -1; }
+
+private:
+    void Post(const base::Closure& task) {
+        if (kOnce)
+            loop_->PostTask(FROM_HERE, base::BindOnce(&MessageLoopBench::Count, this));
+        else
+            loop_->PostTask(FROM_HERE,
+                base::Bind(&MessageLoopBench::Count, base::Unretained(this)));
+    }
+
+    // Runs on the loop
+    void Count() {
+        if (++count_ == total_)
+            done_.Signal();
+    }
+
+    MessageLoop* loop_;
+    base::WaitableEvent done_;
+    int64 count_;
+    int64 total_;
+};
+
+int GetSwitchInt(const CommandLine* cmdline, const char* name, int value) {
+    if (cmdline->HasSwitch(name))
+        base::StringToInt(cmdline->GetSwitchValueASCII(name), &value);
+    return value;
+}
+
+// The fastest of |iterations| runs
+template <class Bench>
+DictionaryValue* Measure(int iterations, int producers, int tasks) {
+    base::TimeDelta best = base::TimeDelta::FromInternalValue(kint64max);
+    int64 wakeups = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        Bench bench;
+        base::TimeDelta elapsed = bench.Run(producers, tasks);
+        if (elapsed < best) {
+            best = elapsed;
+            wakeups = bench.wakeups();
+        }
+    }
+
+    DictionaryValue* result = new DictionaryValue;
+    result->SetDouble("ms", best.InMillisecondsF());
+    result->SetDouble("mtasks_per_s",
+        (double)producers * tasks / std::max(best.InMicroseconds(), (int64)1));
+    if (wakeups >= 0)
+        result->SetDouble("wakeups", (double)wakeups);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    base::AtExitManager atexit;
+
+    if (!CommandLine::Init(argc, argv))
+        return -1;
+
+    CommandLine* cmdline = CommandLine::ForCurrentProcess();
+    if (cmdline->HasSwitch("help")) {
+        printf("Usage: message_loop_bench [--producers=N] [--tasks=N] [--iterations=N]\n"
+               "  --producers   posting threads (default: processors)\n"
+               "  --tasks       tasks posted by every thread (default: 200000)\n"
+               "  --iterations  runs of every bench, the fastest is kept (default: 5)\n");
+        return 0;
+    }
+
+    int producers = GetSwitchInt(cmdline, "producers", base::SysInfo::NumberOfProcessors());
+    int tasks = GetSwitchInt(cmdline, "tasks", 200000);
+    int iterations = GetSwitchInt(cmdline, "iterations", 5);
+    if (producers <= 0 || tasks <= 0 || iterations <= 0) {
+        printf("Invalid arguments\n");
+        return -1;
+    }
+
+    DictionaryValue result;
+    result.SetInteger("producers", producers);
+    result.SetInteger("tasks", tasks);
+    result.Set("locked_queue",
+        Measure<QueueBench<LockedTaskQueue> >(iterations, producers, tasks));
+    result.Set("lock_free_queue",
+        Measure<QueueBench<base::IncomingTaskQueue> >(iterations, producers, tasks));
+    result.Set("message_loop",
+        Measure<MessageLoopBench<false> >(iterations, producers, tasks));
+    result.Set("message_loop_once",
+        Measure<MessageLoopBench<true> >(iterations, producers, tasks));
+
+    std::string json;
+    base::JSONWriter::WriteWithOptions(&result, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+    printf("%s", json.c_str());
+    return 0;
+}
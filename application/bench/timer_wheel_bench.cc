@@ -0,0 +1,257 @@
+/*
+ * Copyright 2025 wtcat
+ */
+
+// timer_wheel_bench measures the two places delayed tasks of MessageLoop may
+// wait in: the priority queue and the timer wheel.  The same timers are
+// added, half of them rescheduled, a quarter cancelled, then the clock is
+// advanced a millisecond at a time until all fired.  The queue can't take a
+// task out, so a rescheduled or cancelled timer leaves an orphan behind as
+// base::Timer does; the wheel moves or unlinks it.  The clock is simulated,
+// only the queues are timed.  The result is printed as json.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/base_time.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/json/json_writer.h"
+#include "base/pending_task.h"
+#include "base/string_number_conversions.h"
+#include "base/string_split.h"
+#include "base/timer_wheel.h"
+#include "base/values.h"
+
+namespace {
+
+void Noop() {
+}
+
+// What happens to the timers, shared by both queues
+struct Workload {
+    Workload(int timers, int span_ms) {
+        std::mt19937 rng(timers);
+        std::uniform_int_distribution<int> deadline(1, span_ms);
+        std::uniform_int_distribution<int> pick(0, timers - 1);
+
+        for (int i = 0; i < timers; i++)
+            deadlines.push_back(deadline(rng));
+        for (int i = 0; i < timers / 2; i++) {
+            rescheduled.push_back(pick(rng));
+            new_deadlines.push_back(deadline(rng));
+        }
+        for (int i = 0; i < timers / 4; i++)
+            cancelled.push_back(pick(rng));
+        end_ms = span_ms;
+    }
+
+    std::vector<int> deadlines;
+    std::vector<int> rescheduled;
+    std::vector<int> new_deadlines;
+    std::vector<int> cancelled;
+    int end_ms;
+};
+
+struct Result {
+    Result() : fired(0), peak_size(0) {}
+
+    base::TimeDelta insert;
+    base::TimeDelta reschedule;
+    base::TimeDelta cancel;
+    base::TimeDelta fire;
+    int64 fired;
+    size_t peak_size;
+};
+
+base::TimeTicks At(base::TimeTicks origin, int ms) {
+    return origin + base::TimeDelta::FromMilliseconds(ms);
+}
+
+// The queue of MessageLoop.  The sequence number of a task identifies the
+// post, a timer only runs the task of its last post.
+class HeapBench {
+public:
+    void Run(const Workload& workload, Result* result) {
+        const base::Closure task = base::Bind(&Noop);
+        const base::TimeTicks origin = base::TimeTicks::Now();
+        base::DelayedTaskQueue queue;
+        std::vector<int> live(workload.deadlines.size());
+        std::vector<int> owner;
+        base::TimeTicks start;
+
+        owner.reserve(workload.deadlines.size() + workload.rescheduled.size());
+
+        start = base::TimeTicks::Now();
+        for (size_t i = 0; i < workload.deadlines.size(); i++)
+            Post(&queue, &live, &owner, (int)i, task, At(origin, workload.deadlines[i]));
+        result->insert = base::TimeTicks::Now() - start;
+
+        start = base::TimeTicks::Now();
+        for (size_t i = 0; i < workload.rescheduled.size(); i++)
+            Post(&queue, &live, &owner, workload.rescheduled[i], task,
+                At(origin, workload.new_deadlines[i]));
+        result->reschedule = base::TimeTicks::Now() - start;
+
+        start = base::TimeTicks::Now();
+        for (size_t i = 0; i < workload.cancelled.size(); i++)
+            live[workload.cancelled[i]] = -1;
+        result->cancel = base::TimeTicks::Now() - start;
+
+        result->peak_size = queue.size();
+        start = base::TimeTicks::Now();
+        for (int ms = 0; ms <= workload.end_ms; ms++) {
+            base::TimeTicks now = At(origin, ms);
+            while (!queue.empty() && queue.top().delayed_run_time <= now) {
+                int sequence_num = queue.top().sequence_num;
+                if (live[owner[sequence_num]] == sequence_num)
+                    result->fired++;
+                queue.pop();
+            }
+        }
+        result->fire = base::TimeTicks::Now() - start;
+    }
+
+private:
+    static void Post(base::DelayedTaskQueue* queue, std::vector<int>* live,
+        std::vector<int>* owner, int timer, const base::Closure& task,
+        base::TimeTicks run_time) {
+        base::PendingTask pending_task(FROM_HERE, task, run_time, true);
+        pending_task.sequence_num = (int)owner->size();
+        owner->push_back(timer);
+        (*live)[timer] = pending_task.sequence_num;
+        queue->push(std::move(pending_task));
+    }
+};
+
+// The timer wheel, every timer owns its task like base::Timer does
+class WheelBench {
+public:
+    void Run(const Workload& workload, Result* result) {
+        const base::Closure task = base::Bind(&Noop);
+        const base::TimeTicks origin = base::TimeTicks::Now();
+        base::TimerWheel wheel(origin);
+        std::vector<base::WheelPendingTask*> timers;
+        base::TimeTicks start;
+
+        for (size_t i = 0; i < workload.deadlines.size(); i++)
+            timers.push_back(new base::WheelPendingTask(base::PendingTask(FROM_HERE, task)));
+
+        start = base::TimeTicks::Now();
+        for (size_t i = 0; i < workload.deadlines.size(); i++)
+            wheel.Schedule(timers[i], At(origin, workload.deadlines[i]));
+        result->insert = base::TimeTicks::Now() - start;
+
+        start = base::TimeTicks::Now();
+        for (size_t i = 0; i < workload.rescheduled.size(); i++)
+            wheel.Schedule(timers[workload.rescheduled[i]],
+                At(origin, workload.new_deadlines[i]));
+        result->reschedule = base::TimeTicks::Now() - start;
+
+        start = base::TimeTicks::Now();
+        for (size_t i = 0; i < workload.cancelled.size(); i++)
+            wheel.Cancel(timers[workload.cancelled[i]]);
+        result->cancel = base::TimeTicks::Now() - start;
+
+        result->peak_size = wheel.size();
+        start = base::TimeTicks::Now();
+        for (int ms = 0; ms <= workload.end_ms; ms++) {
+            wheel.Advance(At(origin, ms));
+            while (wheel.PopExpired())
+                result->fired++;
+        }
+        result->fire = base::TimeTicks::Now() - start;
+
+        for (size_t i = 0; i < timers.size(); i++)
+            delete timers[i];
+    }
+};
+
+// The fastest of |iterations| runs of every step
+template <class Bench>
+DictionaryValue* Measure(const Workload& workload, int iterations) {
+    Result best;
+    best.insert = best.reschedule = best.cancel = best.fire =
+        base::TimeDelta::FromInternalValue(kint64max);
+
+    for (int i = 0; i < iterations; i++) {
+        Result result;
+        Bench bench;
+        bench.Run(workload, &result);
+        best.insert = std::min(best.insert, result.insert);
+        best.reschedule = std::min(best.reschedule, result.reschedule);
+        best.cancel = std::min(best.cancel, result.cancel);
+        best.fire = std::min(best.fire, result.fire);
+        best.fired = result.fired;
+        best.peak_size = result.peak_size;
+    }
+
+    DictionaryValue* result = new DictionaryValue;
+    result->SetDouble("insert_ms", best.insert.InMillisecondsF());
+    result->SetDouble("reschedule_ms", best.reschedule.InMillisecondsF());
+    result->SetDouble("cancel_ms", best.cancel.InMillisecondsF());
+    result->SetDouble("fire_ms", best.fire.InMillisecondsF());
+    result->SetInteger("fired", (int)best.fired);
+    result->SetInteger("peak_size", (int)best.peak_size);
+    return result;
+}
+
+int GetSwitchInt(const CommandLine* cmdline, const char* name, int value) {
+    if (cmdline->HasSwitch(name))
+        base::StringToInt(cmdline->GetSwitchValueASCII(name), &value);
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    base::AtExitManager atexit;
+
+    if (!CommandLine::Init(argc, argv))
+        return -1;
+
+    CommandLine* cmdline = CommandLine::ForCurrentProcess();
+    if (cmdline->HasSwitch("help")) {
+        printf("Usage: timer_wheel_bench [--timers=N,...] [--span=MS] [--iterations=N]\n"
+               "  --timers      pending timers of every run (default: 100000,1000000)\n"
+               "  --span        the deadlines are spread over MS (default: 60000)\n"
+               "  --iterations  runs of every bench, the fastest is kept (default: 3)\n");
+        return 0;
+    }
+
+    std::vector<std::string> counts;
+    base::SplitString(cmdline->HasSwitch("timers") ?
+        cmdline->GetSwitchValueASCII("timers") : "100000,1000000", ',', &counts);
+    int span = GetSwitchInt(cmdline, "span", 60000);
+    int iterations = GetSwitchInt(cmdline, "iterations", 3);
+    if (span <= 0 || iterations <= 0) {
+        printf("Invalid arguments\n");
+        return -1;
+    }
+
+    ListValue runs;
+    for (size_t i = 0; i < counts.size(); i++) {
+        int timers = 0;
+        if (!base::StringToInt(counts[i], &timers) || timers <= 0) {
+            printf("Invalid timer count: %s\n", counts[i].c_str());
+            return -1;
+        }
+
+        Workload workload(timers, span);
+        DictionaryValue* run = new DictionaryValue;
+        run->SetInteger("timers", timers);
+        run->SetInteger("span_ms", span);
+        run->Set("heap", Measure<HeapBench>(workload, iterations));
+        run->Set("wheel", Measure<WheelBench>(workload, iterations));
+        runs.Append(run);
+    }
+
+    std::string json;
+    base::JSONWriter::WriteWithOptions(&runs, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+    printf("%s", json.c_str());
+    return 0;
+}
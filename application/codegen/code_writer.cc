@@ -0,0 +1,200 @@
+/*
+ * Copyright 2025 wtcat 
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/md5.h"
+
+#include "application/codegen/code_writer.h"
+
+namespace app {
+
+//Class CodeWriter
+CodeWriter::CodeWriter(const char* indent_unit) :
+    indent_unit_(indent_unit),
+    size_(0),
+    indent_level_(0),
+    line_start_(true) {
+}
+
+CodeWriter::~CodeWriter() {
+}
+
+CodeWriter& CodeWriter::Append(const char* str, size_t len) {
+    if (len == 0)
+        return *this;
+
+    WriteIndent();
+    while (len > 0) {
+        Chunk* chunk = Reserve(1);
+        size_t n = std::min(len, chunk->capacity - chunk->size);
+        memcpy(chunk->data.get() + chunk->size, str, n);
+        Commit(chunk, n);
+        str += n;
+        len -= n;
+    }
+    return *this;
+}
+
+CodeWriter& CodeWriter::Append(const char* str) {
+    return Append(str, strlen(str));
+}
+
+CodeWriter& CodeWriter::Printf(const char* format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    VPrintf(format, ap);
+    va_end(ap);
+    return *this;
+}
+
+CodeWriter& CodeWriter::VPrintf(const char* format, va_list ap) {
+    va_list ap_copy;
+
+    WriteIndent();
+
+    //Try to format into the free space of the last chunk
+    Chunk* chunk = Reserve(1);
+    size_t avail = chunk->capacity - chunk->size;
+    va_copy(ap_copy, ap);
+    int len = vsnprintf(chunk->data.get() + chunk->size, avail, format, ap_copy);
+    va_end(ap_copy);
+    if (len < 0) {
+        DLOG(ERROR) << "Invalid format string: " << format;
+        return *this;
+    }
+
+    //Not enough space, format again into a chunk that is large enough.
+    //The partial output left in the old chunk is not committed.
+    if ((size_t)len >= avail) {
+        chunk = Reserve((size_t)len + 1);
+        va_copy(ap_copy, ap);
+        vsnprintf(chunk->data.get() + chunk->size, (size_t)len + 1, format, ap_copy);
+        va_end(ap_copy);
+    }
+
+    Commit(chunk, (size_t)len);
+    return *this;
+}
+
+void CodeWriter::Clear() {
+    chunks_.clear();
+    size_ = 0;
+    indent_level_ = 0;
+    line_start_ = true;
+}
+
+std::string CodeWriter::ToString() const {
+    std::string str;
+    str.reserve(size_);
+    ForeachChunk([&](const char* data, size_t len) {
+        str.append(data, len);
+    });
+    return str;
+}
+
+bool CodeWriter::WriteToFile(const FilePath& path) const {
+    FILE* fp = file_util::OpenFile(path, "wb");
+    if (fp == nullptr)
+        return false;
+
+    bool okay = true;
+    ForeachChunk([&](const char* data, size_t len) {
+        if (okay && fwrite(data, 1, len, fp) != len)
+            okay = false;
+    });
+
+    if (!file_util::CloseFile(fp))
+        okay = false;
+    return okay;
+}
+
+void CodeWriter::Digest(base::MD5Digest* digest) const {
+    base::MD5Context ctx;
+    base::MD5Init(&ctx);
+    ForeachChunk([&](const char* data, size_t len) {
+        base::MD5Update(&ctx, base::StringPiece(data, len));
+    });
+    base::MD5Final(digest, &ctx);
+}
+
+bool CodeWriter::SameAsFile(const FilePath& path) const {
+    int64 file_size;
+    if (!file_util::GetFileSize(path, &file_size))
+        return false;
+    if (file_size != static_cast<int64>(size_))
+        return false;
+
+    file_util::ScopedFILE fp(file_util::OpenFile(path, "rb"));
+    if (!fp.get())
+        return false;
+
+    base::MD5Context ctx;
+    base::MD5Init(&ctx);
+    std::unique_ptr<char[]> buffer(new char[kChunkSize]);
+    size_t total = 0;
+    size_t len;
+    while ((len = fread(buffer.get(), 1, kChunkSize, fp.get())) > 0) {
+        base::MD5Update(&ctx, base::StringPiece(buffer.get(), len));
+        total += len;
+    }
+    if (ferror(fp.get()) || total != size_)
+        return false;
+
+    base::MD5Digest file_digest, code_digest;
+    base::MD5Final(&file_digest, &ctx);
+    Digest(&code_digest);
+    return memcmp(file_digest.a, code_digest.a, sizeof(file_digest.a)) == 0;
+}
+
+CodeWriter::Chunk* CodeWriter::Reserve(size_t len) {
+    if (!chunks_.empty()) {
+        Chunk* last = &chunks_.back();
+        if (last->capacity - last->size >= len)
+            return last;
+    }
+
+    Chunk chunk;
+    chunk.capacity = std::max<size_t>(kChunkSize, len);
+    chunk.size = 0;
+    chunk.data.reset(new char[chunk.capacity]);
+    chunks_.push_back(std::move(chunk));
+    return &chunks_.back();
+}
+
+void CodeWriter::Put(char c) {
+    Chunk* chunk = Reserve(1);
+    chunk->data[chunk->size] = c;
+    Commit(chunk, 1);
+}
+
+void CodeWriter::WriteIndent() {
+    if (!line_start_ || indent_level_ == 0)
+        return;
+
+    line_start_ = false;
+    for (int i = 0; i < indent_level_; i++) {
+        const char* str = indent_unit_.data();
+        size_t len = indent_unit_.size();
+        while (len-- > 0)
+            Put(*str++);
+    }
+}
+
+void CodeWriter::Commit(Chunk* chunk, size_t len) {
+    if (len == 0)
+        return;
+
+    chunk->size += len;
+    size_ += len;
+    line_start_ = chunk->data[chunk->size - 1] == '\n';
+}
+
+} //namespace app
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2025 wtcat 
+ */
+#ifndef CODE_WRITER_H_
+#define CODE_WRITER_H_
+
+#include <stdarg.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <version>
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+
+class FilePath;
+
+namespace base {
+struct MD5Digest;
+}
+
+namespace app {
+
+//Class CodeWriter
+// Append-only text buffer for generated source code. The text is kept in
+// a list of fixed size chunks, so appending never moves what has been
+// written and formatted output goes straight into the chunk without any
+// intermediate buffer. WriteToFile() streams the chunks to disk.
+//
+// Indentation: Indent()/Outdent() change the current level, the indent
+// string is inserted before text that is appended at the beginning of a
+// line. Callers that rely on it should write one line per call.
+class CodeWriter {
+public:
+    enum { kChunkSize = 16 * 1024 };
+
+    explicit CodeWriter(const char* indent_unit = "\t");
+    ~CodeWriter();
+
+    CodeWriter(const CodeWriter&) = delete;
+    CodeWriter& operator=(const CodeWriter&) = delete;
+
+    CodeWriter& Append(const char* str, size_t len);
+    CodeWriter& Append(const char* str);
+    CodeWriter& Append(const std::string& str) {
+        return Append(str.data(), str.size());
+    }
+    CodeWriter& Append(char c) {
+        return Append(&c, 1);
+    }
+
+    // printf-style append
+    CodeWriter& Printf(const char* format, ...) PRINTF_FORMAT(2, 3);
+    CodeWriter& VPrintf(const char* format, va_list ap);
+
+#ifdef __cpp_lib_format
+    // std::format-style append
+    template<typename... Args>
+    CodeWriter& Format(std::format_string<Args...> format, Args&&... args) {
+        WriteIndent();
+        std::format_to(Inserter(this), format, std::forward<Args>(args)...);
+        return *this;
+    }
+#endif
+
+    void Indent() {
+        indent_level_++;
+    }
+    void Outdent() {
+        if (indent_level_ > 0)
+            indent_level_--;
+    }
+
+    void Clear();
+    size_t size() const {
+        return size_;
+    }
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    std::string ToString() const;
+    bool WriteToFile(const FilePath& path) const;
+
+    // MD5 of the buffered text
+    void Digest(base::MD5Digest* digest) const;
+
+    // Returns true if |path| exists and holds exactly the buffered text.
+    // The file size is compared first, the contents are only hashed when
+    // the sizes match.
+    bool SameAsFile(const FilePath& path) const;
+
+    // Invoke |callback(data, len)| for every chunk in order
+    template<typename Function>
+    void ForeachChunk(Function&& callback) const {
+        for (const auto& chunk : chunks_)
+            callback(chunk.data.get(), chunk.size);
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+        size_t capacity;
+    };
+
+    // Output iterator used by Format()
+    class Inserter {
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        explicit Inserter(CodeWriter* writer) : writer_(writer) {}
+        Inserter& operator=(char c) {
+            writer_->Put(c);
+            return *this;
+        }
+        Inserter& operator*() { return *this; }
+        Inserter& operator++() { return *this; }
+        Inserter& operator++(int) { return *this; }
+
+    private:
+        CodeWriter* writer_;
+    };
+
+    // Returns a chunk with at least |len| free bytes
+    Chunk* Reserve(size_t len);
+    void Put(char c);
+    void WriteIndent();
+    void Commit(Chunk* chunk, size_t len);
+
+private:
+    std::vector<Chunk> chunks_;
+    std::string indent_unit_;
+    size_t size_;
+    int indent_level_;
+    bool line_start_;
+};
+
+} //namespace app
+
+#endif /* CODE_WRITER_H_ */
@@ -10,32 +10,29 @@
 #include "base/file_path.h"
 #include "base/file_util.h"
 #include "base/bind.h"
+#include "base/json/json_reader.h"
 #include "base/memory/scoped_ptr.h"
-#include "base/threading/simple_thread.h"
+#include "base/threading/task_graph.h"
 
 #include "application/codegen/codegen.h"
 
 namespace app {
 
-class GenerateWork : public base::DelegateSimpleThread::Delegate {
-public:
-    GenerateWork(scoped_refptr<app::CodeBuilder>& builder, bool overwrite) 
-        : builder_(builder), overwrite_(overwrite) {}
-    ~GenerateWork() = default;
-    void Run() OVERRIDE {
-        builder_->GenerateCode(overwrite_);
-        delete this;
-    }
-private:
-    scoped_refptr<app::CodeBuilder> builder_;
-    bool overwrite_;
-};
+static void GenerateWork(scoped_refptr<CodeBuilder> builder,
+    CodeBuilder::WriteMode mode) {
+    if (!builder->GenerateCode(mode))
+        printf("Failed to generate %s\n", builder->filename().AsUTF8Unsafe().c_str());
+}
 
+// The slowest files are listed first
+static bool SlowerFirst(const base::TaskGraph::TaskTiming& l,
+    const base::TaskGraph::TaskTiming& r) {
+    return l.duration > r.duration;
+}
 
 //Class ViewPresenterBuilder
-bool ViewPresenterBuilder::CodeWriteHeader(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
-    snprintf(buffer.get(), BUFFER_SIZE,
+bool ViewPresenterBuilder::CodeWriteHeader(CodeWriter& code) {
+    code.Printf(
         "/*\n"
         " * Copyright wtcat 2025\n"
         " */\n"
@@ -47,37 +44,32 @@ bool ViewPresenterBuilder::CodeWriteHeader(std::string& code) {
         "extern \"C\" {\n"
         "#endif\n"
         "\n", name_.c_str(), name_.c_str());
-    code.append(buffer.get());
     return true;
 }
 
-bool ViewPresenterBuilder::CodeWriteBody(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
-    snprintf(buffer.get(), BUFFER_SIZE,
+bool ViewPresenterBuilder::CodeWriteBody(CodeWriter& code) {
+    code.Printf(
         "typedef struct {\n"
         "\t//TODO: implement\n"
         "}%s_presenter_t\n"
         "\n", name_.c_str());
-    code.append(buffer.get());
     return true;
 }
 
-bool ViewPresenterBuilder::CodeWriteFoot(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
-    snprintf(buffer.get(), BUFFER_SIZE,
+bool ViewPresenterBuilder::CodeWriteFoot(CodeWriter& code) {
+    code.Printf(
         "#ifdef __cplusplus\n"
         "}\n"
         "#endif\n"
         "#endif /* %s_presenter_h_ */\n",
         name_.c_str());
-    code.append(buffer.get());
     return true;
 }
 
 
 //Class CMakeBuilder
-bool CMakeBuiler::CodeWriteHeader(std::string& code) {
-    code.append(
+bool CMakeBuiler::CodeWriteHeader(CodeWriter& code) {
+    code.Append(
         "# UI project files \n\n"
         "zephyr_library_named(NewUI)\n"
         "file(GLOB C_SOURCES \"*.c\")\n\n"
@@ -86,43 +78,46 @@ bool CMakeBuiler::CodeWriteHeader(std::string& code) {
     return true;
 }
 
-bool CMakeBuiler::CodeWriteBody(std::string& code) {
+bool CMakeBuiler::CodeWriteBody(CodeWriter& code) {
     //Add include directories
     AddCMakeOption(code, "zephyr_library_include_directories",
-        [](CMakeBuiler* cls, std::string& xcode) -> std::string& {
-            return xcode.append("\t${CMAKE_CURRENT_SOURCE_DIR}\n");
+        [](CMakeBuiler* cls, CodeWriter& xcode) -> CodeWriter& {
+            return xcode.Append("${CMAKE_CURRENT_SOURCE_DIR}\n");
         });
 
     //Add compile options
     AddCMakeOption(code, "zephyr_library_compile_options",
-        [](CMakeBuiler* cls, std::string& xcode) -> std::string& {
-            return xcode.append("\t-Os\n");
+        [](CMakeBuiler* cls, CodeWriter& xcode) -> CodeWriter& {
+            return xcode.Append("-Os\n");
         });
 
     //Add source files
     AddCMakeOption(code, "zephyr_library_sources",
-        [](CMakeBuiler* cls, std::string& xcode) -> std::string& {
-            xcode.append("\t${C_SOURCES}\n");
-            return xcode;
+        [](CMakeBuiler* cls, CodeWriter& xcode) -> CodeWriter& {
+            return xcode.Append("${C_SOURCES}\n");
         });
 
     return true;
 }
 
-bool CMakeBuiler::CodeWriteFoot(std::string& code) {
+bool CMakeBuiler::CodeWriteFoot(CodeWriter& code) {
     return true;
 }
 
-void CMakeBuiler::AddCMakeOption(std::string& code, const char* function, 
-    std::string& (*fill)(CMakeBuiler *cls, std::string& code)) {
-    code.append(function)
-        .append("(\n");
-    fill(this, code).append(")\n\n");
+void CMakeBuiler::AddCMakeOption(CodeWriter& code, const char* function, 
+    CodeWriter& (*fill)(CMakeBuiler *cls, CodeWriter& code)) {
+    code.Append(function)
+        .Append("(\n");
+    code.Indent();
+    fill(this, code);
+    code.Outdent();
+    code.Append(")\n\n");
 }
 
 
 //Class ViewCodeFactory
-bool ViewCodeFactory::GenerateViewCode(const FilePath &in, bool overwrite) {
+bool ViewCodeFactory::GenerateViewCode(const FilePath &in, 
+    CodeBuilder::WriteMode mode) {
     ResourceParser* re_parser = ResourceParser::GetInstance();
 
     //Parse resource file
@@ -152,22 +147,43 @@ bool ViewCodeFactory::GenerateViewCode(const FilePath &in, bool overwrite) {
         base::Bind(&ViewCodeFactory::CallBack, this)
     );
 
-    //Generate all code
-    base::DelegateSimpleThreadPool thread_pool("codegen", 4);
-    for (auto builder : builders_)
-        thread_pool.AddWork(new GenerateWork(builder, overwrite));
-    thread_pool.Start();
-    
-    //Create cmake project file
+    //Generate all code, the cmake project file is written after every
+    //source file it lists
+    base::TaskGraph graph("codegen", 0);
+    std::vector<base::TaskGraph::TaskId> sources;
+    for (auto builder : builders_) {
+        sources.push_back(graph.AddTask(
+            builder->filename().BaseName().AsUTF8Unsafe(),
+            base::Bind(&GenerateWork, builder, mode)));
+    }
+
     scoped_refptr<CodeBuilder> cmake(
         new CMakeBuiler(
             ResourceParser::GetInstance()->output_path().Append(L"CMakeLists.txt"),
             builders_));
-    cmake->GenerateCode(overwrite);
+    base::TaskGraph::TaskId cmake_task = graph.AddTask(
+        cmake->filename().BaseName().AsUTF8Unsafe(),
+        base::Bind(&GenerateWork, cmake, mode));
+    for (auto id : sources)
+        graph.AddDependency(cmake_task, id);
+
+    if (!graph.Run())
+        return false;
+
+    if (timing_) {
+        std::vector<base::TaskGraph::TaskTiming> timings;
+        graph.GetTimings(&timings);
+        std::sort(timings.begin(), timings.end(), SlowerFirst);
+        printf("Generated %d files with %d threads:\n",
+            (int)timings.size(), graph.num_threads());
+        for (const auto& timing : timings) {
+            printf("  %10.3f ms  (start %10.3f ms)  %s\n",
+                timing.duration.InMillisecondsF(),
+                timing.start.InMillisecondsF(),
+                timing.name.c_str());
+        }
+    }
 
-    //Waiting for worker complete
-    thread_pool.JoinAll();
-    
     return true;
 }
 
@@ -197,48 +213,39 @@ void ViewCodeFactory::CallBack(const ResourceParser::ViewData& view) {
 
 
 //Class ViewCodeBuilder
-void ViewCodeBuilder::AddEnumList(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
-
-
+void ViewCodeBuilder::AddEnumList(CodeWriter& code) {
     //Picture index list
-    code.append(
+    code.Append(
         "/* Picture index list */\n"
         "enum picture_index {\n"
     );
+    code.Indent();
     for (size_t i = 0, size = view_.pictures.size();
         i < size; i++) {
-        snprintf(buffer.get(), BUFFER_SIZE,
-            "\tK_%s,\n",
+        code.Printf("K_%s,\n",
             view_.pictures[i].name.c_str());
-        code.append(buffer.get());
     }
-    code.append("};\n\n");
+    code.Outdent();
+    code.Append("};\n\n");
 
     //String index list
-    code.append(
+    code.Append(
         "/* Text index list */\n"
         "enum text_index {\n"
     );
+    code.Indent();
     for (const auto& iter : view_.strings) {
-        if (iter.alias.size() > 0) {
-            snprintf(buffer.get(), BUFFER_SIZE, "\tK_%s,\n",
-                iter.alias.c_str());
-        } else {
-            snprintf(buffer.get(), BUFFER_SIZE, "\tK_%s,\n",
-                iter.name.c_str());
-        }
-        code.append(buffer.get());
+        if (iter.alias.size() > 0)
+            code.Printf("K_%s,\n", iter.alias.c_str());
+        else
+            code.Printf("K_%s,\n", iter.name.c_str());
     }
-    code.append("};\n\n");
+    code.Outdent();
+    code.Append("};\n\n");
 }
 
-void ViewCodeBuilder::AddHeaderFile(std::string& code) {
-    char buffer[256];
-    snprintf(buffer, sizeof(buffer),
-        "#include \"%s_presenter.h\"\n",
-        view_name_.c_str());
-    code.append(
+void ViewCodeBuilder::AddHeaderFile(CodeWriter& code) {
+    code.Append(
         "/*\n"
         " * Copyright 2025 Code-Generator\n"
         " */\n"
@@ -246,14 +253,12 @@ void ViewCodeBuilder::AddHeaderFile(std::string& code) {
         "#include \"ui_template.h\"\n"
         "#include \"app_ui_view.h\"\n"
     );
-    code.append(buffer).append("\n");
+    code.Printf("#include \"%s_presenter.h\"\n\n",
+        view_name_.c_str());
 }
 
-void ViewCodeBuilder::AddPrivateData(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
-    scoped_ptr<char> font(new char[BUFFER_SIZE]);
-
-    snprintf(buffer.get(), BUFFER_SIZE,
+void ViewCodeBuilder::AddPrivateData(CodeWriter& code) {
+    code.Printf(
         "#define FONT_NAME   %s\n"
         "#define PIC_NUMBERS %d\n"
         "#define STR_NUMBERS %d\n"
@@ -263,49 +268,43 @@ void ViewCodeBuilder::AddPrivateData(std::string& code) {
         (uint32_t)view_.pictures.size(), 
         (uint32_t)view_.strings.size(),
         (uint32_t)view_.picgroups.size());
-    code.append(buffer.get());
 
     AddEnumList(code);
 
-    //Generate font member code
-    int offset = 0;
-    for (auto &iter : view_.fonts) {
-        int len = snprintf(font.get() + offset, 
-            (int)BUFFER_SIZE - offset,
-            "\tui_font_t font%d;\n", atoi(iter.value.c_str()));
-        offset += len;
-    }
-
-    snprintf(buffer.get(), BUFFER_SIZE,
+    code.Printf(
         "typedef struct {\n"
         "\tlv_obj_t* obj;\n"
         "\t\n"
         "\t// Resource objects \n"
         "\t%s\n"
         "\t%s\n"
-        "\t%s\n"
-        "%s"
-        "} %s_t;\n"
-        "\n\n",
+        "\t%s\n",
         view_.pictures.size()?  "lv_img_dsc_t res_img[PIC_NUMBERS];": "",
         view_.strings.size()?   "ui_string_t res_txt[STR_NUMBERS];" : "",
-        view_.picgroups.size()? "ui_picture_set_t res_anim[GRP_NUMBERS];" : "",
-        font.get(),
+        view_.picgroups.size()? "ui_picture_set_t res_anim[GRP_NUMBERS];" : "");
+
+    //Generate font member code
+    code.Indent();
+    for (auto &iter : view_.fonts)
+        code.Printf("ui_font_t font%d;\n", atoi(iter.value.c_str()));
+    code.Outdent();
+
+    code.Printf(
+        "} %s_t;\n"
+        "\n\n",
         view_name_.c_str());
-    code.append(buffer.get());
 }
 
-bool ViewCodeBuilder::CodeWriteHeader(std::string& code) {
+bool ViewCodeBuilder::CodeWriteHeader(CodeWriter& code) {
     AddHeaderFile(code);
     AddPrivateData(code);
     return true;
 }
 
-bool ViewCodeBuilder::CodeWriteFoot(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
+bool ViewCodeBuilder::CodeWriteFoot(CodeWriter& code) {
     const char* pname = view_name_.c_str();
 
-    snprintf(buffer.get(), BUFFER_SIZE,
+    code.Printf(
         "\n\n"
         "UI_VIEW_DEFINE(%s_view) = {\n"
         "    .on_create        = %s_create,\n"
@@ -324,32 +323,25 @@ bool ViewCodeBuilder::CodeWriteFoot(std::string& code) {
         pname,
         pname, 
         ResourceParser::GetInstance()->resource_namespace().c_str());
-    code.append(buffer.get());
 
     char idbuf[256];
     size_t len = StringToUpper(pname, idbuf, sizeof(idbuf));
     idbuf[len] = '\0';
-    snprintf(buffer.get(), BUFFER_SIZE,
+    code.Printf(
         "\n"
         "LVGL_VIEW_DEFINE(uID__%s, &%s_view);\n",
         idbuf,
         pname);
-    code.append(buffer.get());
 
     return true;
 }
 
-bool ViewCodeBuilder::CodeWriteBody(std::string& code) {
-    std::string tcode;
-
+bool ViewCodeBuilder::CodeWriteBody(CodeWriter& code) {
     AddExampleCode(code);
 
-    tcode.reserve(1024);
-    AddResourceCode(tcode);
-    AddMethod(code, "create", 
-        "ui_context_t* ctx", 
-        tcode.c_str()
-    );
+    BeginMethod(code, "create", "ui_context_t* ctx");
+    AddResourceCode(code);
+    EndMethod(code);
 
     AddMethod(code, "focus_change", 
         "ui_context_t* ctx", 
@@ -380,45 +372,47 @@ bool ViewCodeBuilder::CodeWriteBody(std::string& code) {
     return true;
 }
 
-void ViewCodeBuilder::AddMethod(std::string& code, const char* suffix,
+void ViewCodeBuilder::AddMethod(CodeWriter& code, const char* suffix,
     const char* args_list, const char* content) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
+    BeginMethod(code, suffix, args_list);
+    if (content != nullptr)
+        code.Append(content);
+    EndMethod(code);
+}
 
-    snprintf(buffer.get(), BUFFER_SIZE,
+void ViewCodeBuilder::BeginMethod(CodeWriter& code, const char* suffix,
+    const char* args_list) {
+    code.Printf(
         "static int %s_%s(%s) {\n",
         view_name_.c_str(), 
         suffix,
         args_list);
-    code.append(buffer.get());
-
-    if (content != nullptr)
-        code.append(content);
-    code.append("}\n\n");
 }
 
-void ViewCodeBuilder::AddResourceCode(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
+void ViewCodeBuilder::EndMethod(CodeWriter& code) {
+    code.Append("}\n\n");
+}
 
-    snprintf(buffer.get(), BUFFER_SIZE,
+void ViewCodeBuilder::AddResourceCode(CodeWriter& code) {
+    code.Printf(
         "\t%s_t *priv = ui_context_get_user(ctx);\n"
         "\tint err;\n\n",
         view_name_.c_str());
-    code.append(buffer.get());
 
     //Animation resource code
-    AddGroupCode(code, buffer.get(), BUFFER_SIZE);
+    AddGroupCode(code);
 
     //Picture resource code
-    AddPictureCode(code, buffer.get(), BUFFER_SIZE);
+    AddPictureCode(code);
 
     // String resource code
-    AddStringCode(code, buffer.get(), BUFFER_SIZE);
+    AddStringCode(code);
 
     // Font resource get code
-    AddFontCode(code, buffer.get(), BUFFER_SIZE);
+    AddFontCode(code);
 
     // Lvgl widget create code
-    snprintf(buffer.get(), BUFFER_SIZE,
+    code.Printf(
         "\t/*\n"
         "\t * Create lvgl widgets\n"
         "\t */\n"
@@ -432,29 +426,27 @@ void ViewCodeBuilder::AddResourceCode(std::string& code) {
         "\n"
         "\treturn 0;\n",
         view_name_.c_str());
-    code.append(buffer.get());
 }
 
-void ViewCodeBuilder::AddFontCode(std::string& code, char* buf, size_t size) {
-    code.append(
+void ViewCodeBuilder::AddFontCode(CodeWriter& code) {
+    code.Append(
         "\t/* Get font resource */\n"
     );
     for (auto &iter : view_.fonts) {
         int font_size = atoi(iter.value.c_str());
-        snprintf(buf, size,
+        code.Printf(
             "\terr = ui_context_get_font(ctx, FONT_NAME, %d, &priv->font%d);\n"
             "\tif (err)\n"
             "\t\treturn err;\n"
             "\n", 
             font_size, font_size);
-        code.append(buf);
     }
 }
 
-void ViewCodeBuilder::AddPictureCode(std::string& code, char* buf, size_t size) {
+void ViewCodeBuilder::AddPictureCode(CodeWriter& code) {
     int pic_numbers = (int)view_.pictures.size();
     if (pic_numbers > 0) {
-        code.append(
+        code.Append(
             "\t/*\n"
             "\t * Get picture resources\n"
             "\t */\n"
@@ -462,14 +454,13 @@ void ViewCodeBuilder::AddPictureCode(std::string& code, char* buf, size_t size)
         );
 
         for (int i = 0; i < pic_numbers; i++) {
-            snprintf(buf, size,
+            code.Printf(
                 "\t\t__RE(\"%s\")%s //%d\n",
                 view_.pictures.at(i).name.c_str(),
                 (i < pic_numbers - 1) ? "," : ");",
                 i);
-            code.append(buf);
         }
-        code.append(
+        code.Append(
             "\tif (err)\n"
             "\t\treturn err;\n"
             "\n"
@@ -477,10 +468,10 @@ void ViewCodeBuilder::AddPictureCode(std::string& code, char* buf, size_t size)
     }
 }
 
-void ViewCodeBuilder::AddStringCode(std::string& code, char* buf, size_t size) {
+void ViewCodeBuilder::AddStringCode(CodeWriter& code) {
     int str_numbers = (int)view_.strings.size();
     if (str_numbers > 0) {
-        code.append(
+        code.Append(
             "\t/*\n"
             "\t * Get text resources\n"
             "\t */\n"
@@ -488,14 +479,13 @@ void ViewCodeBuilder::AddStringCode(std::string& code, char* buf, size_t size) {
         );
 
         for (int i = 0; i < str_numbers; i++) {
-            snprintf(buf, size,
+            code.Printf(
                 "\t\t__RE(\"%s\")%s //%d\n",
                 view_.strings.at(i).name.c_str(),
                 (i < str_numbers - 1) ? "," : ");",
                 i);
-            code.append(buf);
         }
-        code.append(
+        code.Append(
             "\tif (err)\n"
             "\t\treturn err;\n"
             "\n"
@@ -503,10 +493,10 @@ void ViewCodeBuilder::AddStringCode(std::string& code, char* buf, size_t size) {
     }
 }
 
-void ViewCodeBuilder::AddGroupCode(std::string& code, char* buf, size_t size) {
+void ViewCodeBuilder::AddGroupCode(CodeWriter& code) {
     int grp_numbers = (int)view_.picgroups.size();
     if (grp_numbers > 0) {
-        code.append(
+        code.Append(
             "\t/*\n"
             "\t * Get animation resources\n"
             "\t */\n"
@@ -514,14 +504,13 @@ void ViewCodeBuilder::AddGroupCode(std::string& code, char* buf, size_t size) {
         );
 
         for (int i = 0; i < grp_numbers; i++) {
-            snprintf(buf, size,
+            code.Printf(
                 "\t\t__RE(\"%s\")%s //%d\n",
                 view_.picgroups.at(i).name.c_str(),
                 (i < grp_numbers - 1) ? "," : ");",
                 i);
-            code.append(buf);
         }
-        code.append(
+        code.Append(
             "\tif (err)\n"
             "\t\treturn err;\n"
             "\n"
@@ -529,9 +518,8 @@ void ViewCodeBuilder::AddGroupCode(std::string& code, char* buf, size_t size) {
     }
 }
 
-void ViewCodeBuilder::AddExampleCode(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
-    snprintf(buffer.get(), BUFFER_SIZE,
+void ViewCodeBuilder::AddExampleCode(CodeWriter& code) {
+    code.Printf(
         "#if 0\n"
         "//LVGL event callback example"
         "(Events: LV_EVENT_CLICKED, ...) \n"
@@ -548,7 +536,6 @@ void ViewCodeBuilder::AddExampleCode(std::string& code) {
         "\n",
         view_name_.c_str(), 
         view_name_.c_str());
-    code.append(buffer.get());
 }
 
 
@@ -559,51 +546,43 @@ ViewIDCodeBuilder::ViewIDCodeBuilder(const FilePath& file) :
     StringCopy(guard_name_, org_name.c_str(), kMaxFileName);
 }
 
-bool ViewIDCodeBuilder::CodeWriteHeader(std::string& code) {
-    scoped_ptr<char> buffer(new char[kTempBufferSize]);
-    code.append(
+bool ViewIDCodeBuilder::CodeWriteHeader(CodeWriter& code) {
+    code.Append(
         "/*\n"
         " * Copyright 2025 wtcat (Don't edit it)\n"
         " */\n"
     );
-    snprintf(buffer.get(), kTempBufferSize,
+    code.Printf(
         "#ifndef %s__h_\n"
         "#define %s__h_\n\n",
         guard_name(),
         guard_name()
     );
-    code.append(buffer.get());
     return true;
 }
 
-bool ViewIDCodeBuilder::CodeWriteFoot(std::string& code) {
-    scoped_ptr<char> buffer(new char[kTempBufferSize]);
-    snprintf(buffer.get(), kTempBufferSize,
+bool ViewIDCodeBuilder::CodeWriteFoot(CodeWriter& code) {
+    code.Printf(
         "\n#endif /* %s__h_ */\n",
         guard_name()
     );
-    code.append(buffer.get());
     return true;
 }
 
-bool ViewIDCodeBuilder::CodeWriteBody(std::string& code) {
+bool ViewIDCodeBuilder::CodeWriteBody(CodeWriter& code) {
     ResourceParser* reptr = ResourceParser::GetInstance();
     size_t count = reptr->id_count();
     for (size_t i = 0; i < count; i++) {
-        char idname[8] = {0};
-        itoa((int)i, idname, 10);
-        code.append("#define ")
-            .append(reptr->GetIdName((int)i))
-            .append("  ")
-            .append(itoa((int)i + reptr->id_base(), idname, 10))
-            .append("\n");
+        code.Printf("#define %s  %d\n",
+            reptr->GetIdName((int)i).c_str(),
+            (int)i + reptr->id_base());
     }
     return true;
 }
 
 
 //Class ResourceCodeBuilder
-bool ResourceCodeBuilder::CodeWriteHeader(std::string& code) {
+bool ResourceCodeBuilder::CodeWriteHeader(CodeWriter& code) {
     static const char header[] = {
         "/*\n"
         " * Copyright 2025 wtcat\n"
@@ -619,16 +598,15 @@ bool ResourceCodeBuilder::CodeWriteHeader(std::string& code) {
         "#define SDK_RESOURCE_ITEM(view_id, scene_id, npic, ntxt, nset) \\\n"
         "     { scene_id, view_id, npic, nset, ntxt }\n"
     };
-    code.clear();
-    code.append(header);
+    code.Append(header);
     return true;
 }
 
-bool ResourceCodeBuilder::CodeWriteFoot(std::string& code) {
-    scoped_ptr<char> buffer(new char[BUFFER_SIZE]);
+bool ResourceCodeBuilder::CodeWriteFoot(CodeWriter& code) {
     int id = ResourceParser::GetInstance()->id_base();
 
-    snprintf(buffer.get(), BUFFER_SIZE,
+    ResourceTableFill(code);
+    code.Printf(
         "UI_PUBLIC_API\n"
         "const sdk_resources_t* %s(uint16_t view_id) {\n"
         "    assert(view_id >= %d);\n"
@@ -639,13 +617,10 @@ bool ResourceCodeBuilder::CodeWriteFoot(std::string& code) {
         "}\n",
         ResourceParser::GetInstance()->function_name().c_str(),
         id, id);
-
-    ResourceTableFill(code);
-    code.append(buffer.get());
     return true;
 }
 
-bool ResourceCodeBuilder::CodeWriteBody(std::string& code) {
+bool ResourceCodeBuilder::CodeWriteBody(CodeWriter& code) {
     ResourceParser::GetInstance()->ForeachView(
         base::Bind(&ResourceCodeBuilder::ResourceCallback, this),
         code);
@@ -653,7 +628,7 @@ bool ResourceCodeBuilder::CodeWriteBody(std::string& code) {
 }
 
 void ResourceCodeBuilder::ResourceCallback(const ResourceParser::ViewData& view,
-    std::string& code) {
+    CodeWriter& code) {
     //Collect variable information
     scoped_ptr<ResourceNode> item(new ResourceNode());
 
@@ -666,7 +641,7 @@ void ResourceCodeBuilder::ResourceCallback(const ResourceParser::ViewData& view,
     nodes_.push_back(std::move(item));
 }
 
-void ResourceCodeBuilder::ResourceTableFill(std::string& code) {
+void ResourceCodeBuilder::ResourceTableFill(CodeWriter& code) {
     static const char header[] = {
         "\n\n"
         "/*\n"
@@ -676,146 +651,382 @@ void ResourceCodeBuilder::ResourceTableFill(std::string& code) {
     };
 
     //Append resource table header
-    code.append(header);
+    code.Append(header);
 
     //Sort view ID
     std::sort(nodes_.begin(), nodes_.end(), Less());
 
     //Generate resource table item
     for (const auto& iter : nodes_) {
-        char buffer[32];
-        code.append("\tSDK_RESOURCE_ITEM(")
-            .append(ResourceParser::GetInstance()->GetIdName(iter->view)).append(", ")
-            .append(iter->scene).append(", ")
-            .append(itoa(iter->picture_num, buffer, 10)).append(", ")
-            .append(itoa(iter->text_num, buffer, 10)).append(", ")
-            .append(itoa(iter->anim_num, buffer, 10)).append("),\n");
+        code.Printf("\tSDK_RESOURCE_ITEM(%s, %s, %u, %u, %u),\n",
+            ResourceParser::GetInstance()->GetIdName(iter->view).c_str(),
+            iter->scene.c_str(),
+            iter->picture_num,
+            iter->text_num,
+            iter->anim_num);
     }
 
     //Append resource table foot
-    code.append("};\n\n\n");
+    code.Append("};\n\n\n");
 }
 
 
-//Class ResourceParser
-bool ResourceParser::ParseInput(const FilePath& path) {
-    JSONFileValueSerializer json(path);
-    std::string  err_message;
-    base::Value* value;
+//Class ResourceParser::InputHandler
+// Builds ViewData straight from the parser events. Members may appear in
+// any order, so every object is completed when it ends. Values that are
+// not part of the resource interface are skipped.
+class ResourceParser::InputHandler : public base::JSONSaxHandler {
+public:
+    InputHandler(ResourceParser* parser) :
+        parser_(parser),
+        item_(64, 32),
+        key_(kKeyOther),
+        list_(nullptr),
+        text_list_(false),
+        list_failed_(false),
+        skip_depth_(0),
+        has_name_(false),
+        has_value_(false),
+        view_has_name_(false),
+        view_has_value_(false),
+        has_signature_(false),
+        has_views_(false) {
+        states_.reserve(8);
+    }
 
-    if (valid())
+    bool StartObject() override {
+        if (skip_depth_ > 0) {
+            skip_depth_++;
+            return true;
+        }
+        if (states_.empty()) {
+            states_.push_back(kRoot);
+            return true;
+        }
+        switch (states_.back()) {
+        case kViews:
+            view_ = std::make_unique<ViewData>();
+            view_has_name_ = view_has_value_ = false;
+            states_.push_back(kView);
+            break;
+        case kList:
+            if (list_failed_) {
+                skip_depth_++;
+                break;
+            }
+            item_.Clear();
+            has_name_ = has_value_ = false;
+            states_.push_back(kItem);
+            break;
+        default:
+            skip_depth_++;
+            break;
+        }
+        key_ = kKeyOther;
         return true;
-
-    //Parse resource information file (Generated by resource convert tool)
-    value = json.Deserialize(nullptr, &err_message);
-    if (value == nullptr) {
-        printf("Failed to parse json: %s\n", err_message.c_str());
-        return false;
     }
 
-    //Get root node
-    const base::DictionaryValue* dict_value;
-    const base::ListValue* list_value;
-    if (!value->GetAsDictionary(&dict_value))
-        return false;
+    bool EndObject() override {
+        if (skip_depth_ > 0) {
+            skip_depth_--;
+            return true;
+        }
+        State state = states_.back();
+        states_.pop_back();
+        if (state == kItem)
+            return EndItem();
+        if (state == kView)
+            return EndView();
+        return true;
+    }
 
-    //Check file signature
-    std::string str;
-    str.reserve(128);
+    bool StartArray() override {
+        if (skip_depth_ > 0) {
+            skip_depth_++;
+            return true;
+        }
+        if (states_.empty())
+            return false;
 
-    if (!dict_value->GetString("signature", &str)) {
-        printf("Not found key: \"signature\"\n");
-        return false;
+        switch (states_.back()) {
+        case kRoot:
+            if (key_ == kKeyViews) {
+                parser_->ids_.reserve(80);
+                parser_->resources_.reserve(50);
+                has_views_ = true;
+                states_.push_back(kViews);
+            } else {
+                skip_depth_++;
+            }
+            break;
+        case kViews:
+            printf("Invalid \"views\" value\n");
+            return false;
+        case kView:
+            if (BeginList())
+                states_.push_back(kList);
+            else
+                skip_depth_++;
+            break;
+        case kList:
+            printf("Invalid \"views\" value\n");
+            list_failed_ = true;
+            skip_depth_++;
+            break;
+        default:
+            skip_depth_++;
+            break;
+        }
+        key_ = kKeyOther;
+        return true;
     }
-    if (str != "ResourceInterface") {
-        printf("Invalid resource interface file\n");
-        return false;
+
+    bool EndArray() override {
+        if (skip_depth_ > 0) {
+            skip_depth_--;
+            return true;
+        }
+        states_.pop_back();
+        return true;
     }
 
-    //Parse resource list
-    if (!dict_value->GetList("views", &list_value)) {
-        printf("Not found key: \"views\"\n");
-        return false;
+    bool Key(const base::StringPiece& key) override {
+        if (skip_depth_ == 0)
+            key_ = KeyOf(key);
+        return true;
     }
 
-    //Walk around resource node list
-    TextResourceType text_re(64, 32);
-    ids_.reserve(80);
-    resources_.reserve(50);
-    for (const auto iter: *list_value) {
-        std::unique_ptr<ViewData> view_ptr = std::make_unique<ViewData>();
+    bool String(const base::StringPiece& value) override {
+        return Scalar(&value);
+    }
+    bool Number(const base::StringPiece& value) override {
+        return Scalar(nullptr);
+    }
+    bool Boolean(bool value) override {
+        return Scalar(nullptr);
+    }
+    bool Null() override {
+        return Scalar(nullptr);
+    }
 
-        if (!(iter)->GetAsDictionary(&dict_value)) {
-            printf("Invalid \"views\" value\n");
+    //Checks the document once the parser has finished
+    bool Finish() {
+        if (!has_signature_) {
+            printf("Not found key: \"signature\"\n");
             return false;
         }
-
-        //Get view name
-        if (!dict_value->GetString("name", &view_ptr.get()->name)) {
-            printf("Not found key: \"name\"\n");
+        if (signature_ != "ResourceInterface") {
+            printf("Invalid resource interface file\n");
             return false;
         }
-
-        //Get resource id of the view
-        if (!dict_value->GetString("value", &view_ptr.get()->value)) {
-            printf("Not found key: \"value\"\n");
+        if (!has_views_) {
+            printf("Not found key: \"views\"\n");
             return false;
         }
+        return true;
+    }
 
-        //Get all pictures of the view
-        ForeachListValue(dict_value, "pictures", view_ptr.get()->pictures);
-        std::sort(view_ptr.get()->pictures.begin(), 
-            view_ptr.get()->pictures.end(), ResourceLess());
-
-        //Get all strings of the view
-        ForeachListTemplate(dict_value, "strings", [&](const base::DictionaryValue* dict_value)->bool {
-            text_re.Clear();
-            if (!dict_value->GetString("name", &text_re.name)) {
-                printf("Not found key: \"name\"\n");
-                return false;
-            }
-            if (!dict_value->GetString("value", &text_re.value)) {
-                printf("Not found key: \"value\"\n");
-                return false;
-            }
-            dict_value->GetString("alias", &text_re.alias);
-            view_ptr.get()->strings.push_back(text_re);
-            return true;
-            });
-        std::sort(view_ptr.get()->strings.begin(),
-            view_ptr.get()->strings.end(), ResourceLess());
+private:
+    enum State {
+        kRoot,
+        kViews,
+        kView,
+        kList,
+        kItem
+    };
+    enum KeyId {
+        kKeyOther,
+        kKeySignature,
+        kKeyViews,
+        kKeyName,
+        kKeyValue,
+        kKeyAlias,
+        kKeyPictures,
+        kKeyGroups,
+        kKeyStrings,
+        kKeyFonts
+    };
 
-        //Get all picture groups of the view
-        ForeachListValue(dict_value, "groups", view_ptr.get()->picgroups);
+    static KeyId KeyOf(const base::StringPiece& key) {
+        static const struct {
+            const char* name;
+            KeyId id;
+        } keys[] = {
+            {"name",      kKeyName},
+            {"value",     kKeyValue},
+            {"alias",     kKeyAlias},
+            {"pictures",  kKeyPictures},
+            {"strings",   kKeyStrings},
+            {"groups",    kKeyGroups},
+            {"fonts",     kKeyFonts},
+            {"views",     kKeyViews},
+            {"signature", kKeySignature}
+        };
+        for (const auto& iter : keys) {
+            if (key == iter.name)
+                return iter.id;
+        }
+        return kKeyOther;
+    }
 
-        //Get all fonts
-        ForeachListValue(dict_value, "fonts", view_ptr.get()->fonts);
+    bool Scalar(const base::StringPiece* str) {
+        if (skip_depth_ > 0)
+            return true;
+        if (states_.empty())
+            return false;
 
-        ids_.push_back("uID__" + view_ptr.get()->name);
-        resources_.push_back(std::move(view_ptr));
+        KeyId key = key_;
+        key_ = kKeyOther;
+        switch (states_.back()) {
+        case kRoot:
+            if (key == kKeySignature && str) {
+                str->CopyToString(&signature_);
+                has_signature_ = true;
+            }
+            break;
+        case kViews:
+            printf("Invalid \"views\" value\n");
+            return false;
+        case kView:
+            if (key == kKeyName && str) {
+                str->CopyToString(&view_->name);
+                view_has_name_ = true;
+            } else if (key == kKeyValue && str) {
+                str->CopyToString(&view_->value);
+                view_has_value_ = true;
+            }
+            break;
+        case kList:
+            printf("Invalid \"views\" value\n");
+            list_failed_ = true;
+            break;
+        case kItem:
+            if (key == kKeyName && str) {
+                str->CopyToString(&item_.name);
+                has_name_ = true;
+            } else if (key == kKeyValue && str) {
+                str->CopyToString(&item_.value);
+                has_value_ = true;
+            } else if (key == kKeyAlias && str) {
+                str->CopyToString(&item_.alias);
+            }
+            break;
+        }
+        return true;
     }
 
-    return true;
-}
+    bool BeginList() {
+        list_ = nullptr;
+        text_list_ = false;
+        switch (key_) {
+        case kKeyPictures:
+            list_ = &view_->pictures;
+            break;
+        case kKeyGroups:
+            list_ = &view_->picgroups;
+            break;
+        case kKeyFonts:
+            list_ = &view_->fonts;
+            break;
+        case kKeyStrings:
+            view_->strings.clear();
+            text_list_ = true;
+            list_failed_ = false;
+            return true;
+        default:
+            return false;
+        }
+        list_->clear();
+        list_failed_ = false;
+        return true;
+    }
 
-bool ResourceParser::ForeachListValue(const base::DictionaryValue* value,
-    const std::string& key, std::vector<ResourceType>& vector) {
-    ResourceType re(64, 32);
+    //A failed item drops the rest of its list, but not the view
+    bool EndItem() {
+        if (!has_name_) {
+            printf("Not found key: \"name\"\n");
+            list_failed_ = true;
+            return true;
+        }
+        if (!has_value_) {
+            printf("Not found key: \"value\"\n");
+            list_failed_ = true;
+            return true;
+        }
+        if (text_list_)
+            view_->strings.push_back(item_);
+        else
+            list_->push_back(item_);
+        return true;
+    }
 
-    return ForeachListTemplate(value, key, [&](const base::DictionaryValue* dict_value)->bool {
-        re.Clear();
-        if (!dict_value->GetString("name", &re.name)) {
+    bool EndView() {
+        if (!view_has_name_) {
             printf("Not found key: \"name\"\n");
             return false;
         }
-        if (!dict_value->GetString("value", &re.value)) {
+        if (!view_has_value_) {
             printf("Not found key: \"value\"\n");
             return false;
         }
-        vector.push_back(re);
+        std::sort(view_->pictures.begin(), view_->pictures.end(), 
+            ResourceLess());
+        std::sort(view_->strings.begin(), view_->strings.end(), 
+            ResourceLess());
+        parser_->ids_.push_back("uID__" + view_->name);
+        parser_->resources_.push_back(std::move(view_));
         return true;
-        });
+    }
 
+private:
+    ResourceParser* parser_;
+    std::vector<State> states_;
+    std::unique_ptr<ViewData> view_;
+    TextResourceType item_;
+    std::string signature_;
+    KeyId key_;
+    std::vector<ResourceType>* list_;
+    bool text_list_;
+    bool list_failed_;
+    int skip_depth_;
+    bool has_name_;
+    bool has_value_;
+    bool view_has_name_;
+    bool view_has_value_;
+    bool has_signature_;
+    bool has_views_;
+};
+
+//Class ResourceParser
+bool ResourceParser::ParseInput(const FilePath& path) {
+    std::string content;
+    std::string err_message;
+    int err_code = 0;
+
+    if (valid())
+        return true;
+
+    //Parse resource information file (Generated by resource convert tool)
+    if (!file_util::ReadFileToString(path, &content)) {
+        printf("Failed to read %s\n", path.AsUTF8Unsafe().c_str());
+        return false;
+    }
+
+    InputHandler handler(this);
+    if (!base::JSONReader::ReadWithHandler(content, base::JSON_PARSE_RFC, 
+        &handler, &err_code, &err_message)) {
+        if (err_code != base::JSONReader::JSON_NO_ERROR)
+            printf("Failed to parse json: %s\n", err_message.c_str());
+        resources_.clear();
+        ids_.clear();
+        return false;
+    }
+
+    if (!handler.Finish()) {
+        resources_.clear();
+        ids_.clear();
+        return false;
+    }
     return true;
 }
 
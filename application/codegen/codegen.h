@@ -14,9 +14,9 @@
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/ref_counted.h"
-#include "base/json/json_file_value_serializer.h"
 
 #include "application/helper/helper.h"
+#include "application/codegen/code_writer.h"
 
 namespace app {
 
@@ -86,7 +86,7 @@ public:
 
     template<typename Function>
     void ForeachView(base::Callback<Function> &&callback,
-        std::string &code) {
+        CodeWriter &code) {
         for (const auto &iter : resources_)
             callback.Run(*iter.get(), code);
     }
@@ -131,30 +131,10 @@ public:
     }
 
 private:
-    ResourceParser() = default;
-    bool ForeachListValue(const base::DictionaryValue* value,
-        const std::string& key,
-        std::vector<ResourceType>& vector);
-
-    template<typename Function>
-    bool ForeachListTemplate(const base::DictionaryValue* value,
-        const std::string& key, Function&& process) {
-        const base::ListValue* list_value;
-        if (!value->GetList(key, &list_value))
-            return false;
+    //Fills the resource list from the events of the json parser
+    class InputHandler;
 
-        for (auto iter = list_value->begin();
-            iter != list_value->end(); ++iter) {
-            const base::DictionaryValue* dict_value;
-            if (!(*iter)->GetAsDictionary(&dict_value)) {
-                printf("Invalid \"views\" value\n");
-                return false;
-            }
-            if (!process(dict_value))
-                return false;
-        }
-        return true;
-    }
+    ResourceParser() = default;
 
 private:
     std::vector<std::unique_ptr<ViewData>> resources_;
@@ -167,21 +147,25 @@ private:
 // Class CodeBuilder
 class CodeBuilder: public base::RefCountedThreadSafe<CodeBuilder> {
 public:
-    enum { BUFFER_SIZE = 4096 };
+    enum WriteMode {
+        kSkipExisting,  //Don't touch files that already exist
+        kOverwrite,     //Always rewrite the file
+        kWriteChanged   //Rewrite only when the content has changed
+    };
+
     CodeBuilder(const FilePath& file) : file_(file) {}
     virtual ~CodeBuilder() {}
-    bool GenerateCode(bool overwrite) {
+    bool GenerateCode(WriteMode mode) {
         if (!ResourceParser::GetInstance()->valid())
             return false;
 
         //Don't overwrite file if it exists
-        if (!overwrite) {
+        if (mode == kSkipExisting) {
             if (file_util::PathExists(file_))
                 return true;
         }
 
-        std::string code;
-        code.reserve(40960);
+        CodeWriter code;
 
         if (!CodeWriteHeader(code))
             return false;
@@ -192,16 +176,23 @@ public:
         if (!CodeWriteFoot(code))
             return false;
 
-        return file_util::WriteFile(file_, code.c_str(), (int)code.length()) > 0;
+        if (code.empty())
+            return false;
+
+        //Keep the file (and its mtime) if nothing has changed
+        if (mode == kWriteChanged && code.SameAsFile(file_))
+            return true;
+
+        return code.WriteToFile(file_);
     }
     const FilePath& filename() const {
         return file_;
     }
 
 private:
-    virtual bool CodeWriteHeader(std::string& code) { return true; }
-    virtual bool CodeWriteBody(std::string& code) { return true; }
-    virtual bool CodeWriteFoot(std::string& code) { return true; }
+    virtual bool CodeWriteHeader(CodeWriter& code) { return true; }
+    virtual bool CodeWriteBody(CodeWriter& code) { return true; }
+    virtual bool CodeWriteFoot(CodeWriter& code) { return true; }
 
 private:
     const FilePath file_;
@@ -233,11 +224,11 @@ public:
     ~ResourceCodeBuilder() = default;
 
 private:
-    void ResourceTableFill(std::string& code);
-    void ResourceCallback(const ResourceParser::ViewData& view, std::string& code);
-    bool CodeWriteHeader(std::string& code) override;
-    bool CodeWriteBody(std::string& code) override;
-    bool CodeWriteFoot(std::string& code) override;
+    void ResourceTableFill(CodeWriter& code);
+    void ResourceCallback(const ResourceParser::ViewData& view, CodeWriter& code);
+    bool CodeWriteHeader(CodeWriter& code) override;
+    bool CodeWriteBody(CodeWriter& code) override;
+    bool CodeWriteFoot(CodeWriter& code) override;
 
 private:
     std::vector<scoped_ptr<ResourceNode>> nodes_;
@@ -248,16 +239,15 @@ private:
 class ViewIDCodeBuilder : public CodeBuilder {
 public:
     enum { 
-        kMaxFileName = 256,
-        kTempBufferSize = 1024
+        kMaxFileName = 256
     };
     ViewIDCodeBuilder(const FilePath& file);
     ~ViewIDCodeBuilder() = default;
 
 private:
-    bool CodeWriteHeader(std::string& code) override;
-    bool CodeWriteBody(std::string& code) override;
-    bool CodeWriteFoot(std::string& code) override;
+    bool CodeWriteHeader(CodeWriter& code) override;
+    bool CodeWriteBody(CodeWriter& code) override;
+    bool CodeWriteFoot(CodeWriter& code) override;
     const char* guard_name() const {
         return guard_name_;
     }
@@ -274,21 +264,24 @@ public:
         : CodeBuilder(file), view_(view), view_name_(view_name) {}
 
 private:
-    void AddEnumList(std::string& code);
-    void AddHeaderFile(std::string& code);
-    void AddPrivateData(std::string& code);
-    void AddExampleCode(std::string& code);
-    void AddMethod(std::string& code, const char* suffix, 
+    void AddEnumList(CodeWriter& code);
+    void AddHeaderFile(CodeWriter& code);
+    void AddPrivateData(CodeWriter& code);
+    void AddExampleCode(CodeWriter& code);
+    void AddMethod(CodeWriter& code, const char* suffix, 
         const char *args_list, const char* content);
-    void AddResourceCode(std::string& code);
-    void AddFontCode(std::string& code, char *buf, size_t size);
-    void AddPictureCode(std::string& code, char* buf, size_t size);
-    void AddStringCode(std::string& code, char* buf, size_t size);
-    void AddGroupCode(std::string& code, char* buf, size_t size);
-
-    bool CodeWriteHeader(std::string& code) override;
-    bool CodeWriteBody(std::string& code) override;
-    bool CodeWriteFoot(std::string& code) override;
+    void BeginMethod(CodeWriter& code, const char* suffix,
+        const char* args_list);
+    void EndMethod(CodeWriter& code);
+    void AddResourceCode(CodeWriter& code);
+    void AddFontCode(CodeWriter& code);
+    void AddPictureCode(CodeWriter& code);
+    void AddStringCode(CodeWriter& code);
+    void AddGroupCode(CodeWriter& code);
+
+    bool CodeWriteHeader(CodeWriter& code) override;
+    bool CodeWriteBody(CodeWriter& code) override;
+    bool CodeWriteFoot(CodeWriter& code) override;
 
 private:
     const ResourceParser::ViewData& view_;
@@ -301,9 +294,9 @@ public:
     ViewPresenterBuilder(const FilePath& file, const std::string &view_name)
         : CodeBuilder(file), name_(view_name) {}
 private:
-    bool CodeWriteHeader(std::string& code) override;
-    bool CodeWriteBody(std::string& code) override;
-    bool CodeWriteFoot(std::string& code) override;
+    bool CodeWriteHeader(CodeWriter& code) override;
+    bool CodeWriteBody(CodeWriter& code) override;
+    bool CodeWriteFoot(CodeWriter& code) override;
     DISALLOW_COPY_AND_ASSIGN(ViewPresenterBuilder);
 
 private:
@@ -314,19 +307,25 @@ private:
 class ViewCodeFactory: public base::RefCounted<ViewCodeFactory> {
 public:
     enum { kAppendStringLength = 32 };
-    ViewCodeFactory() {
+    ViewCodeFactory() : timing_(false) {
         builders_.reserve(30); 
     }
     ~ViewCodeFactory() = default;
-    bool GenerateViewCode(const FilePath& in, bool overwrite = false);
+    bool GenerateViewCode(const FilePath& in,
+        CodeBuilder::WriteMode mode = CodeBuilder::kSkipExisting);
     void SetOptions(scoped_refptr<ResourceParser::ResourceOptions> &option) {
         ResourceParser::GetInstance()->SetOptions(option);
     }
+    //Print how long every file took to generate
+    void EnableTiming(bool enable) {
+        timing_ = enable;
+    }
 
 private:
     void CallBack(const ResourceParser::ViewData& view);
 private:
     std::vector<scoped_refptr<CodeBuilder>> builders_;
+    bool timing_;
 };
 
 //Class cmake builer
@@ -336,11 +335,11 @@ public:
         : CodeBuilder(file), src_vector_(src) {}
 
 private:
-    void AddCMakeOption(std::string& code, const char *function, 
-        std::string& (*fill)(CMakeBuiler *cls, std::string& code));
-    bool CodeWriteHeader(std::string& code) override;
-    bool CodeWriteBody(std::string& code) override;
-    bool CodeWriteFoot(std::string& code) override;
+    void AddCMakeOption(CodeWriter& code, const char *function, 
+        CodeWriter& (*fill)(CMakeBuiler *cls, CodeWriter& code));
+    bool CodeWriteHeader(CodeWriter& code) override;
+    bool CodeWriteBody(CodeWriter& code) override;
+    bool CodeWriteFoot(CodeWriter& code) override;
     DISALLOW_COPY_AND_ASSIGN(CMakeBuiler);
 
 private:
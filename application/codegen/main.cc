@@ -31,7 +31,9 @@ int main(int argc, char* argv[]) {
                 "[--resource_namespace = namespace] "
                 "[--resource_ids_cfile = filename] "
                 "[--resource_list_cfile = filename] "
-                "[--overwrite]\n"
+                "[--overwrite] "
+                "[--update] "
+                "[--timing]\n"
                 "Options:\n"
                 "  --view_base               The base ID for views. (default: 0)\n"
                 "  --resource_fnname         The function name that get resource by view ID. (default: _sdk_view_get_resource)\n"
@@ -42,6 +44,8 @@ int main(int argc, char* argv[]) {
                 "  --resource_ids_cfile      Resource IDs c header file name\n"
                 "  --resource_list_cfile     Resource list c source file name\n"
                 "  --overwrite               Overwrite files that has exists\n"
+                "  --update                  Overwrite files only if the content has changed\n"
+                "  --timing                  Print the time spent on every generated file\n"
             );
             return 0;
         }
@@ -49,7 +53,7 @@ int main(int argc, char* argv[]) {
         scoped_refptr<app::ViewCodeFactory> factory(new app::ViewCodeFactory);
         scoped_refptr<app::ResourceParser::ResourceOptions> option(new app::ResourceParser::ResourceOptions);
         FilePath file(L"re_output.json");
-        bool overwrite;
+        app::CodeBuilder::WriteMode mode;
 
         if (cmdline->HasSwitch("input_file")) {
             file.clear();
@@ -89,7 +93,12 @@ int main(int argc, char* argv[]) {
         else
             option->ui_res_filename = "ui_template_resource.c";
 
-        overwrite = cmdline->HasSwitch("overwrite");
+        if (cmdline->HasSwitch("overwrite"))
+            mode = app::CodeBuilder::kOverwrite;
+        else if (cmdline->HasSwitch("update"))
+            mode = app::CodeBuilder::kWriteChanged;
+        else
+            mode = app::CodeBuilder::kSkipExisting;
 
         if (!file_util::PathExists(option->outpath)) {
             if (!file_util::CreateDirectory(option->outpath)) {
@@ -100,9 +109,10 @@ int main(int argc, char* argv[]) {
         
         //Inject generate options
         factory->SetOptions(option);
+        factory->EnableTiming(cmdline->HasSwitch("timing"));
 
         //Generate template code
-        if (!factory->GenerateViewCode(file, overwrite)) {
+        if (!factory->GenerateViewCode(file, mode)) {
             DLOG(ERROR) << "Generate error";
             return -1;
         }
@@ -4,23 +4,63 @@
 
 #include "lvgen_cinsn.h"
 
+#include <cerrno>
 #include <vector>
 #include <filesystem>
+#include <unordered_set>
 
+#include "base/bind.h"
 #include "base/file_path.h"
 #include "base/file_util.h"
+#include "base/files/file_path_watcher.h"
 #include "base/memory/singleton.h"
+#include "base/message_loop.h"
+#include "base/threading/task_graph.h"
 #include "lvgen.h"
 
 namespace app {
 namespace fs = std::filesystem;
 
-LvCodeGenerator::LvCodeGenerator() {
+namespace {
+
+void ParseModuleTask(LvModuleContext* mod, int* result) {
+    *result = lvgen_parse_module(mod);
+}
+
+// The module name that lvgen_add_module() derives from the file path
+std::string ModuleName(const std::string& path) {
+    std::string name = FilePath::FromUTF8Unsafe(path).BaseName().AsUTF8Unsafe();
+    if (name.size() > LV_SYMBOL_LEN - 1)
+        name.resize(LV_SYMBOL_LEN - 1);
+    name.resize(name.size() - 4);
+    return name;
+}
+
+template<typename Func>
+void ForeachModule(Func&& fn) {
+    void* ll_ptr;
+    LV_LL_READ(&lvgen_get_context()->ll_modules, ll_ptr)
+        fn((LvModuleContext*)ll_ptr);
+}
+
+// A module has no files if the shared module generates all its functions
+bool HasOwnFunctions(const LvModuleContext* mod) {
+    void* ll_ptr;
+    LV_LL_READ(&mod->ll_funs, ll_ptr) {
+        if (((LvFunctionContext*)ll_ptr)->alias == nullptr)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+LvCodeGenerator::LvCodeGenerator() : jobs_(0), update_pending_(false) {
     lvgen_context_init();
 }
 
 LvCodeGenerator::~LvCodeGenerator() {
-    for (auto iter : lv_props_)
+    for (auto iter : watchers_)
         delete iter.second;
     lvgen_context_destroy();
 }
@@ -36,110 +76,81 @@ bool LvCodeGenerator::LoadViews(const FilePath& dir) {
     }
 
     // Parse components
+    SourceFileList files;
     FilePath component_dir = dir.Append(L"components");
-    if (file_util::PathExists(component_dir))
-        ScanDirectory(component_dir, 0, false);
+    if (file_util::PathExists(component_dir)) {
+        ScanDirectory(component_dir, 0, false, &files);
+        ParseFiles(files);
+        files.clear();
+    }
 
-    return ScanDirectory(dir, 0, true);
+    bool okay = ScanDirectory(dir, 0, true, &files);
+    return ParseFiles(files) && okay;
 }
 
 bool LvCodeGenerator::Generate(const FilePath &outdir) const{
     if (lvgen_generate()) {
-        std::string buf;
-        buf.reserve(8192);
-
-        LvGlobalContext* ctx = lvgen_get_context();
-        void* ll_ptr;
-        LV_LL_READ(&ctx->ll_modules, ll_ptr) {
-            buf.clear();
-            GenerateModule((const LvModuleContext*)ll_ptr, buf, outdir);
-        }
-
+        EmitModules(outdir);
         return true;
     }
 
     return false;
 }
 
-bool LvCodeGenerator::LoadAttributes(const FilePath& file) {
-    // Make sure the file is valid 
-    if (!file_util::PathExists(file)) {
-        printf("Not found file(%s)\n", file.AsUTF8Unsafe().c_str());
-        return false;
-    }
+void LvCodeGenerator::EmitModules(const FilePath& outdir) const {
+    std::string buf;
+    buf.reserve(8192);
 
-    // Parse doc
-    xml::XMLDocument doc;
-    if (doc.LoadFile(file.AsUTF8Unsafe().c_str()) != xml::XML_SUCCESS) {
-        printf("Failed to parse file(%s)\n", file.AsUTF8Unsafe().c_str());
-        return false;
+    LvGlobalContext* ctx = lvgen_get_context();
+    void* ll_ptr;
+    LV_LL_READ(&ctx->ll_modules, ll_ptr) {
+        buf.clear();
+        GenerateModule((const LvModuleContext*)ll_ptr, buf, outdir);
     }
 
-    // Get root element
-    xml::XMLElement* root_node = doc.RootElement();
+    buf.clear();
+    GenerateModule(lvgen_get_shared_module(), buf, outdir);
+}
 
-    // Parse all types
-    std::vector<const char*> type_vector;
-    type_vector.reserve(15);
+bool LvCodeGenerator::Watch(const FilePath& indir, const FilePath& outdir) {
+    // FilePathWatcher needs an IO message loop and absolute paths
+    MessageLoopForIO loop;
 
-    xml::XMLElement* type_nodes = FindChild(root_node, "types");
-    ForeachChild(type_nodes, [&](xml::XMLElement* e) {
-        type_vector.push_back(e->Name());
-    });
-
-    for (auto iter : type_vector) {
-        LvMap* lvmap = new LvMap(iter);
-        xml::XMLElement* child = FindChild(type_nodes, iter);
-        ForeachChild(child, [&](xml::XMLElement* e) {
-            LvAttribute *attr = new LvAttribute(e->Attribute("name"), e->Attribute("value"), "?");
-            lvmap->container.insert(std::make_pair(attr->name, attr));
-        });
-
-        lv_props_.insert(std::make_pair(lvmap->name, lvmap));
+    indir_ = indir;
+    outdir_ = outdir;
+    if (!file_util::AbsolutePath(&indir_) || !file_util::AbsolutePath(&outdir_)) {
+        printf("Invalid path(%s)\n", indir.AsUTF8Unsafe().c_str());
+        return false;
     }
 
-    // Parse styles
-    xml::XMLElement* styles_node = FindChild(root_node, "styles");
-    LvMap* lvmap = new LvMap("styles");
-    ForeachChild(styles_node, [&](xml::XMLElement* e) {
-        LvAttribute* attr = new LvAttribute(e->Attribute("name"), e->Attribute("value"), e->Attribute("type"));
-        lvmap->container.insert(std::make_pair(attr->name, attr));
-        });
-    lv_props_.insert(std::make_pair(lvmap->name, lvmap));
+    WatchFiles();
+    printf("Watching %s\n", indir_.AsUTF8Unsafe().c_str());
+    fflush(stdout);
+    loop.Run();
 
-    //TODO: remove 
-    const LvAttribute* p = FindAttribute("lv_border_side_t", "bottom");
-    if (p != nullptr) {
-        printf("%s\n", p->value.c_str());
-    }
-    
+    for (auto iter : watchers_)
+        delete iter.second;
+    watchers_.clear();
     return true;
 }
 
-const LvCodeGenerator::LvAttribute* LvCodeGenerator::FindAttribute(const std::string& ns,
-    const std::string& key) {
-    auto ns_iter = lv_props_.find(ns);
-    if (ns_iter != lv_props_.end()) {
-        LvMap* lvmap = ns_iter->second;
-        auto key_iter = lvmap->container.find(key);
-        if (key_iter != lvmap->container.end())
-            return key_iter->second;
+bool LvCodeGenerator::LoadAttributes(const FilePath& file) {
+    // Make sure the file is valid 
+    if (!file_util::PathExists(file)) {
+        printf("Not found file(%s)\n", file.AsUTF8Unsafe().c_str());
+        return false;
     }
-    return nullptr;
+
+    return attributes_.Load(file, file.AddExtension(FILE_PATH_LITERAL("cache")));
 }
 
-xml::XMLElement* LvCodeGenerator::FindChild(xml::XMLElement* parent,
-    const char* elem) {
-    for (xml::XMLElement* node = parent->FirstChildElement();
-        node != nullptr;
-        node = node->NextSiblingElement()) {
-        if (!strcmp(node->Name(), elem))
-            return node;
-    }
-    return nullptr;
+bool LvCodeGenerator::FindAttribute(const char* ns, const char* key,
+    const char** value, const char** type) const {
+    return attributes_.Find(ns, key, value, type);
 }
 
-bool LvCodeGenerator::ScanDirectory(const FilePath& dir, int level, bool ignore_components) {
+bool LvCodeGenerator::ScanDirectory(const FilePath& dir, int level, bool ignore_components,
+    SourceFileList* files) {
     const fs::path root_path(dir.MaybeAsASCII());
     bool okay = false;
     bool view;
@@ -157,18 +168,15 @@ bool LvCodeGenerator::ScanDirectory(const FilePath& dir, int level, bool ignore_
     for (const auto& entry : fs::directory_iterator(root_path)) {
         if (fs::is_directory(entry)) {
             okay = ScanDirectory(FilePath::FromUTF8Unsafe(entry.path().string()), level, 
-                ignore_components);
+                ignore_components, files);
             if (!okay)
                 break;
         }
 
         if (fs::is_regular_file(entry)) {
             if (entry.path().filename().extension() == ".xml") {
-                okay = ParseView(entry.path().string(), view);
-                if (!okay) {
-                    printf("Failed to parse file(%s)\n", entry.path().string().c_str());
-                    break;
-                }
+                files->push_back(LvSourceFile(entry.path().string(), view));
+                okay = true;
             }
         }
     }
@@ -177,13 +185,299 @@ bool LvCodeGenerator::ScanDirectory(const FilePath& dir, int level, bool ignore_
     return okay;
 }
 
+bool LvCodeGenerator::ParseFiles(const SourceFileList& files) {
+    std::unordered_set<std::string> names;
+    size_t begin = 0;
+
+    // Files are parsed in batches whose module names are unique, so that every
+    // parser thread owns its module. The globals file is shared by all the
+    // components and is parsed alone between two batches.
+    for (size_t i = 0; i < files.size(); i++) {
+        std::string name = ModuleName(files[i].path);
+        bool globals = (name == "globals");
+
+        if (globals || !names.insert(name).second) {
+            if (!ParseBatch(files, begin, i))
+                return false;
+            names.clear();
+            begin = i;
+            if (!globals) {
+                names.insert(name);
+                continue;
+            }
+
+            if (!ParseView(files[i].path, files[i].is_view)) {
+                printf("Failed to parse file(%s)\n", files[i].path.c_str());
+                return false;
+            }
+            begin = i + 1;
+        }
+    }
+
+    return ParseBatch(files, begin, files.size());
+}
+
+bool LvCodeGenerator::ParseBatch(const SourceFileList& files, size_t begin, size_t end) {
+    if (end - begin < 2 || jobs_ == 1) {
+        for (size_t i = begin; i < end; i++) {
+            if (!ParseView(files[i].path, files[i].is_view)) {
+                printf("Failed to parse file(%s)\n", files[i].path.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Modules are created and merged on this thread in the order of the files,
+    // only the parsing of the xml runs on the workers
+    std::vector<LvModuleContext*> modules(end - begin);
+    std::vector<int> results(end - begin, 0);
+    base::TaskGraph graph("lvgen", jobs_);
+
+    for (size_t i = begin; i < end; i++) {
+        LvModuleContext* mod = lvgen_add_module(files[i].path.c_str(), files[i].is_view);
+        if (mod == nullptr) {
+            printf("Failed to parse file(%s)\n", files[i].path.c_str());
+            return false;
+        }
+        modules[i - begin] = mod;
+        graph.AddTask(files[i].path, 
+            base::Bind(&ParseModuleTask, mod, &results[i - begin]));
+    }
+
+    graph.Run();
+
+    bool okay = true;
+    for (size_t i = 0; i < modules.size(); i++) {
+        if (!okay) {
+            lvgen_merge_module(modules[i], -ECANCELED);
+            continue;
+        }
+        if (lvgen_merge_module(modules[i], results[i]) < 0) {
+            printf("Failed to parse file(%s)\n", files[begin + i].path.c_str());
+            okay = false;
+        }
+    }
+
+    return okay;
+}
+
 bool LvCodeGenerator::ParseView(const std::string& file, bool is_view) {
     return lvgen_parse(file.c_str(), is_view) == 0;
 }
 
+void LvCodeGenerator::WatchFiles() {
+    // The directories are watched for added and removed files
+    std::vector<FilePath> paths;
+    paths.push_back(indir_);
+    FilePath component_dir = indir_.Append(L"components");
+    if (file_util::PathExists(component_dir)) {
+        paths.push_back(component_dir);
+        SourceFileList files;
+        ScanDirectory(component_dir, 0, false, &files);
+        for (const auto& file : files)
+            paths.push_back(FilePath::FromUTF8Unsafe(file.path));
+    }
+
+    SourceFileList files;
+    ScanDirectory(indir_, 0, true, &files);
+    for (const auto& file : files)
+        paths.push_back(FilePath::FromUTF8Unsafe(file.path));
+
+    std::unordered_map<std::string, base::files::FilePathWatcher*> watchers;
+    for (const auto& path : paths) {
+        std::string key = path.AsUTF8Unsafe();
+        auto iter = watchers_.find(key);
+        if (iter != watchers_.end()) {
+            watchers.insert(*iter);
+            watchers_.erase(iter);
+            continue;
+        }
+
+        base::files::FilePathWatcher* watcher = new base::files::FilePathWatcher;
+        if (!watcher->Watch(path, base::Bind(&LvCodeGenerator::OnFileChanged,
+            base::Unretained(this)))) {
+            printf("Failed to watch file(%s)\n", key.c_str());
+            delete watcher;
+            continue;
+        }
+        watchers.insert(std::make_pair(key, watcher));
+    }
+
+    // Stop watching the removed files
+    for (auto iter : watchers_)
+        delete iter.second;
+    watchers_.swap(watchers);
+}
+
+void LvCodeGenerator::OnFileChanged(const FilePath& path, bool error) {
+    if (error) {
+        printf("Failed to watch file(%s)\n", path.AsUTF8Unsafe().c_str());
+        return;
+    }
+
+    // An editor usually writes a file several times in a row, handle them
+    // all at once after a while
+    changed_files_.insert(path.AsUTF8Unsafe());
+    if (!update_pending_) {
+        update_pending_ = true;
+        MessageLoop::current()->PostDelayedTask(FROM_HERE,
+            base::Bind(&LvCodeGenerator::Update, base::Unretained(this)),
+            base::TimeDelta::FromMilliseconds(kUpdateDelayMs));
+    }
+}
+
+void LvCodeGenerator::Update() {
+    std::unordered_set<std::string> changed;
+
+    update_pending_ = false;
+    changed.swap(changed_files_);
+
+    // Collect the files that exist now
+    SourceFileList files;
+    FilePath component_dir = indir_.Append(L"components");
+    if (file_util::PathExists(component_dir))
+        ScanDirectory(component_dir, 0, false, &files);
+    ScanDirectory(indir_, 0, true, &files);
+
+    std::unordered_set<std::string> names;
+    for (const auto& file : files)
+        names.insert(ModuleName(file.path));
+
+    // A new or removed file can change the meaning of every other file, the
+    // global scope is used by every file too. Otherwise only the modules of
+    // the changed files and the modules that depend on them are affected.
+    std::unordered_set<LvModuleContext*> affected;
+    std::vector<LvModuleContext*> removed;
+    bool rebuild = false;
+
+    ForeachModule([&](LvModuleContext* mod) {
+        if (names.erase(mod->name) == 0) {
+            removed.push_back(mod);
+            rebuild = true;
+        }
+    });
+    if (!names.empty())
+        rebuild = true;
+
+    for (const auto& path : changed) {
+        FilePath file = FilePath::FromUTF8Unsafe(path);
+        if (file.Extension() != FILE_PATH_LITERAL(".xml"))
+            continue;
+
+        std::string name = ModuleName(path);
+        printf("%s updated\n", path.c_str());
+        if (name == "globals")
+            rebuild = true;
+
+        LvModuleContext* mod = lvgen_get_module_by_name(name.c_str());
+        if (mod != nullptr)
+            affected.insert(mod);
+    }
+
+    if (rebuild) {
+        ForeachModule([&](LvModuleContext* mod) {
+            affected.insert(mod);
+        });
+    } else {
+        CollectDependents(&affected);
+    }
+    if (affected.empty() && names.empty())
+        return;
+
+    // Drop the affected modules first, they may refer to each other
+    ForeachModule([&](LvModuleContext* mod) {
+        if (affected.count(mod))
+            lvgen_reset_module(mod);
+    });
+    for (auto iter : removed) {
+        printf("%s removed\n", iter->path);
+        RemoveModuleFiles(iter->name);
+        affected.erase(iter);
+        lvgen_remove_module(iter);
+    }
+
+    // Parse them again in the original order, then the new files
+    ForeachModule([&](LvModuleContext* mod) {
+        if (affected.count(mod))
+            lvgen_reparse_module(mod);
+    });
+    for (const auto& file : files) {
+        std::string name = ModuleName(file.path);
+        if (names.count(name) && lvgen_get_module_by_name(name.c_str()) == nullptr) {
+            printf("%s added\n", file.path.c_str());
+            if (ParseView(file.path, file.is_view))
+                affected.insert(lvgen_get_module_by_name(name.c_str()));
+            else
+                printf("Failed to parse file(%s)\n", file.path.c_str());
+        }
+    }
+
+    ForeachModule([&](LvModuleContext* mod) {
+        if (affected.count(mod))
+            lvgen_generate_module(mod);
+    });
+
+    // The shared functions are named after their bodies, so the modules
+    // which aren't affected still find theirs
+    lvgen_share_funcs();
+
+    std::string buf;
+    buf.reserve(8192);
+    auto emit = [&](LvModuleContext* mod) {
+        buf.clear();
+        if (!HasOwnFunctions(mod))
+            RemoveModuleFiles(mod->name);
+        else
+            GenerateModule(mod, buf, outdir_);
+    };
+    ForeachModule([&](LvModuleContext* mod) {
+        if (affected.count(mod))
+            emit(mod);
+    });
+    emit(lvgen_get_shared_module());
+    printf("Regenerated %d module(s)\n", (int)affected.size());
+    fflush(stdout);
+
+    if (rebuild)
+        WatchFiles();
+}
+
+void LvCodeGenerator::CollectDependents(std::unordered_set<LvModuleContext*>* modules) const {
+    std::unordered_map<LvModuleContext*, std::vector<LvModuleContext*>> dependents;
+
+    // Reverse the ll_deps and ll_uses edges
+    ForeachModule([&](LvModuleContext* mod) {
+        void* ll_ptr;
+        LV_LL_READ(&mod->ll_deps, ll_ptr)
+            dependents[((LvModuleDepend*)ll_ptr)->mod].push_back(mod);
+        LV_LL_READ(&mod->ll_uses, ll_ptr)
+            dependents[((LvModuleDepend*)ll_ptr)->mod].push_back(mod);
+    });
+
+    std::vector<LvModuleContext*> pending(modules->begin(), modules->end());
+    while (!pending.empty()) {
+        LvModuleContext* mod = pending.back();
+        pending.pop_back();
+
+        auto iter = dependents.find(mod);
+        if (iter == dependents.end())
+            continue;
+        for (auto user : iter->second) {
+            if (modules->insert(user).second)
+                pending.push_back(user);
+        }
+    }
+}
+
+void LvCodeGenerator::RemoveModuleFiles(const std::string& name) const {
+    file_util::Delete(outdir_.Append(FilePath::FromUTF8Unsafe(name + ".h")), false);
+    file_util::Delete(outdir_.Append(FilePath::FromUTF8Unsafe(name + ".c")), false);
+}
+
 bool LvCodeGenerator::GenerateModule(const LvModuleContext* mod, std::string &buf,
     const FilePath &outdir) const {
-    if (lv_ll_get_head(&mod->ll_funs) != nullptr) {
+    if (HasOwnFunctions(mod)) {
 
         //Generate module header file
         if (GenerateModuleHeader(mod, buf)) {
@@ -224,8 +518,8 @@ bool LvCodeGenerator::GenerateModuleHeader(const LvModuleContext* mod, std::stri
     void* ll_ptr;
     LV_LL_READ(&mod->ll_funs, ll_ptr) {
         LvFunctionContext* fn = (LvFunctionContext*)ll_ptr;
-        if (fn->export_cnt > 0 && GenerateFunctionSignature(fn, tbuf, sizeof(tbuf)))
-            buf.append(tbuf).append(";\n");
+        if (fn->alias == nullptr && fn->export_cnt > 0 && GenerateFunctionSignature(fn, buf))
+            buf.append(";\n");
     }
     buf.append("\n");
 
@@ -252,6 +546,8 @@ bool LvCodeGenerator::GenerateModuleSource(const LvModuleContext* mod, std::stri
     buf.append("#include \"lvgen_cdefs.h\"\n");
     LV_LL_READ(&mod->ll_deps, ll_ptr) {
         LvModuleDepend* mdep = (LvModuleDepend*)ll_ptr;
+        if (!HasOwnFunctions(mdep->mod))
+            continue;
         snprintf(strbuf.get(), kStringBufferSize, "#include \"%s.h\"\n", mdep->mod->name);
         buf.append(strbuf.get());
     }
@@ -268,6 +564,10 @@ bool LvCodeGenerator::GenerateModuleSource(const LvModuleContext* mod, std::stri
         //if (!mod->is_view && fn->ref_cnt == 0)
         //    continue;
 
+        // The shared module generates it
+        if (fn->alias != nullptr)
+            continue;
+
         GenerateFunction(fn, fn_text);
         if (fn->style_num > max_styles)
             max_styles = fn->style_num;
@@ -311,12 +611,10 @@ bool LvCodeGenerator::GenerateModuleSource(const LvModuleContext* mod, std::stri
 }
 
 bool LvCodeGenerator::GenerateFunction(const LvFunctionContext* fn, std::string& buf) const  {
-    char tbuf[256];
-
-    if (!GenerateFunctionSignature(fn, tbuf, sizeof(tbuf)))
+    if (!GenerateFunctionSignature(fn, buf))
         return false;
 
-    buf.append(tbuf).append(" {\n");
+    buf.append(" {\n");
 
     GenerateFunctionInstruction(fn, buf, "\t");
 
@@ -325,175 +623,84 @@ bool LvCodeGenerator::GenerateFunction(const LvFunctionContext* fn, std::string&
     return true;
 }
 
-bool LvCodeGenerator::GenerateFunctionSignature(const LvFunctionContext* fn, char* tbuf, 
-    size_t maxsize) const  {
-    if (fn == nullptr || tbuf == nullptr)
+bool LvCodeGenerator::GenerateFunctionSignature(const LvFunctionContext* fn,
+    std::string& buf) const  {
+    if (fn == nullptr)
         return false;
 
     // Format function signature
-    int remain = (int)maxsize;
-    int offset = 0;
-
     if (fn->export_cnt == 0)
-        offset += snprintf(tbuf + offset, remain - offset, "static ");
-
-    offset += snprintf(tbuf + offset, remain - offset, "%s %s",
-        lv_type_to_name(fn->rtype), fn->signature);
-
-    switch (fn->args_num) {
-    case 0:
-        offset += snprintf(tbuf + offset, remain - offset, "(void)");
-        break;
-    case 1:
-        offset += snprintf(tbuf + offset, remain - offset, "(%s %s)",
-            fn->args[0].type, fn->args[0].name
-        );
-        break;
-    case 2:
-        offset += snprintf(tbuf + offset, remain - offset, "(%s %s, %s %s)",
-            fn->args[0].type, fn->args[0].name,
-            fn->args[1].type, fn->args[1].name
-        );
-        break;
-    case 3:
-        offset += snprintf(tbuf + offset, remain - offset, "(%s %s, %s %s, %s %s)",
-            fn->args[0].type, fn->args[0].name,
-            fn->args[1].type, fn->args[1].name,
-            fn->args[2].type, fn->args[2].name
-        );
-        break;
-    case 4:
-        offset += snprintf(tbuf + offset, remain - offset, "(%s %s, %s %s, %s %s, %s %s)",
-            fn->args[0].type, fn->args[0].name,
-            fn->args[1].type, fn->args[1].name,
-            fn->args[2].type, fn->args[2].name,
-            fn->args[3].type, fn->args[3].name
-        );
-        break;
-    case 5:
-        offset += snprintf(tbuf + offset, remain - offset, "(%s %s, %s %s, %s %s, %s %s, %s %s)",
-            fn->args[0].type, fn->args[0].name,
-            fn->args[1].type, fn->args[1].name,
-            fn->args[2].type, fn->args[2].name,
-            fn->args[3].type, fn->args[3].name,
-            fn->args[4].type, fn->args[4].name
-        );
-        break;
-    case 6:
-        offset += snprintf(tbuf + offset, remain - offset, "(%s %s, %s %s, %s %s, %s %s, %s %s, %s %s)",
-            fn->args[0].type, fn->args[0].name,
-            fn->args[1].type, fn->args[1].name,
-            fn->args[2].type, fn->args[2].name,
-            fn->args[3].type, fn->args[3].name,
-            fn->args[4].type, fn->args[4].name,
-            fn->args[5].type, fn->args[5].name
-        );
-        break;
-    default:
-        return false;
+        buf.append("static ");
+
+    buf.append(lv_type_to_name(fn->rtype)).append(" ").append(fn->signature);
+    if (fn->args_num == 0) {
+        buf.append("(void)");
+        return true;
+    }
+
+    buf.append("(");
+    for (int i = 0; i < fn->args_num; i++) {
+        if (i > 0)
+            buf.append(", ");
+        buf.append(fn->args[i].type).append(" ").append(fn->args[i].name);
     }
+    buf.append(")");
 
     return true;
 }
 
 bool LvCodeGenerator::GenerateFunctionInstruction(const LvFunctionContext* fn, std::string &buf, 
     const char *indent) const  {
-    char tbuf[512];
+    int depth = 0;
     void* ll_ptr;
 
-    // Format function instruction
-    LV_LL_READ(&fn->ll_insn, ll_ptr) {
-        LvFunctionCallInsn* ins = (LvFunctionCallInsn*)ll_ptr;
-        int remain = sizeof(tbuf);
-        int offset = 0;
-
+    auto append_indent = [&]() {
         if (indent) {
-            if (!LV_IS_EXPR(ins->rtype) && ins->lvalue != nullptr)
-                offset += snprintf(tbuf + offset, remain - offset, "\n");
-            offset += snprintf(tbuf + offset, remain - offset, indent);
+            for (int i = 0; i <= depth; i++)
+                buf.append(indent);
         }
+    };
 
-        if (!LV_IS_EXPR(ins->rtype)) {
-            if (ins->lvalue != nullptr) {
-                offset += snprintf(tbuf + offset, remain - offset, "%s %s = ",
-                    lv_type_to_name(ins->rtype), ins->lvalue);
-            }
+    // Render every instruction in one pass, the blocks opened by the
+    // expressions are indented
+    LV_LL_READ(&fn->ll_insn, ll_ptr) {
+        const LvFunctionCallInsn* ins = (const LvFunctionCallInsn*)ll_ptr;
+
+        if (LV_IS_EXPR(ins->rtype)) {
+            size_t len = strlen(ins->expr);
+            if (ins->expr[0] == '}' && depth > 0)
+                depth--;
+            append_indent();
+            buf.append(ins->expr, len).append("\n");
+            if (len > 0 && ins->expr[len - 1] == '{')
+                depth++;
+            continue;
+        }
 
-            switch (ins->args_num) {
-            case 0:
-                offset += snprintf(tbuf + offset, remain - offset, "%s();\n",
-                    ins->insn);
-                break;
-            case 1:
-                offset += snprintf(tbuf + offset, remain - offset, "%s(%s);\n",
-                    ins->insn,
-                    ins->args[0]
-                );
-                break;
-            case 2:
-                offset += snprintf(tbuf + offset, remain - offset, "%s(%s, %s);\n",
-                    ins->insn,
-                    ins->args[0],
-                    ins->args[1]
-                );
-                break;
-            case 3:
-                offset += snprintf(tbuf + offset, remain - offset, "%s(%s, %s, %s);\n",
-                    ins->insn,
-                    ins->args[0],
-                    ins->args[1],
-                    ins->args[2]
-                );
-                break;
-            case 4:
-                offset += snprintf(tbuf + offset, remain - offset, "%s(%s, %s, %s, %s);\n",
-                    ins->insn,
-                    ins->args[0],
-                    ins->args[1],
-                    ins->args[2],
-                    ins->args[3]
-                );
-                break;
-            case 5:
-                offset += snprintf(tbuf + offset, remain - offset, "%s(%s, %s, %s, %s, %s);\n",
-                    ins->insn,
-                    ins->args[0],
-                    ins->args[1],
-                    ins->args[2],
-                    ins->args[3],
-                    ins->args[4]
-                );
-                break;
-            case 6:
-                offset += snprintf(tbuf + offset, remain - offset, "%s(%s, %s, %s, %s, %s, %s);\n",
-                    ins->insn,
-                    ins->args[0],
-                    ins->args[1],
-                    ins->args[2],
-                    ins->args[3],
-                    ins->args[4],
-                    ins->args[5]
-                );
-                break;
-            default:
-                return false;
-            }
-        } else {
-            offset += snprintf(tbuf + offset, remain - offset, "%s\n", ins->expr);
+        if (indent && ins->lvalue != nullptr)
+            buf.append("\n");
+        append_indent();
+
+        if (ins->lvalue != nullptr) {
+            buf.append(lv_type_to_name(ins->rtype)).append(" ")
+                .append(ins->lvalue).append(" = ");
+        }
+
+        buf.append(lvgen_insn_callee(ins)).append("(");
+        for (int i = 0; i < ins->args_num; i++) {
+            if (i > 0)
+                buf.append(", ");
+            buf.append(ins->args[i]);
         }
-        
-        buf.append(tbuf);
+        buf.append(");\n");
     }
 
     // Generate return instruction
     if (fn->rvar != nullptr) {
-        int offset = 0;
-
-        tbuf[offset++] = '\n';
+        buf.append("\n");
         if (indent != nullptr)
-            offset += snprintf(tbuf + offset, sizeof(tbuf) - offset, "%s", indent);
-        snprintf(tbuf + offset, sizeof(tbuf) - offset, "return %s;\n", fn->rvar);
-        buf.append(tbuf);
+            buf.append(indent);
+        buf.append("return ").append(fn->rvar).append(";\n");
     }
 
     return true;
@@ -10,78 +10,94 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "base/file_path.h"
-#include "thirdparty/tinyxml2/tinyxml2.h"
+#include "lvgen_db.h"
 
 template<typename Type>
 struct DefaultSingletonTraits;
 
+namespace base {
+namespace files {
+class FilePathWatcher;
+} // namespace files
+} // namespace base
+
 namespace app {
-namespace xml = tinyxml2;
 
 class LvCodeGenerator {
 public:
     enum { kStringBufferSize = 1024 };
-    struct LvAttribute {
-        LvAttribute(const char* n, const char* v, const char *t) :
-            name(n), value(v), type(t) {
-        }
-        std::string name;
-        std::string value;
-        std::string type;
-    };
-
-    using AttributeMap = std::unordered_map<std::string, LvAttribute*>;
-
-    struct LvMap {
-        LvMap(const char* n) : name(n) {}
-        ~LvMap() {
-            for (auto iter : container)
-                delete iter.second;
-        }
-        std::string name;
-        AttributeMap container;
-    };
 
     ~LvCodeGenerator();
 
 
     static LvCodeGenerator* GetInstance();
+
+    // Load the attribute database, it is compiled into |file|.cache which
+    // is reused while |file| doesn't change
     bool LoadAttributes(const FilePath& file);
-    const LvAttribute* FindAttribute(const std::string& ns, const std::string& key);
+    bool FindAttribute(const char* ns, const char* key, const char** value,
+        const char** type) const;
     bool LoadViews(const FilePath& dir);
     bool Generate(const FilePath& outdir) const;
 
+    // Write the files of the modules analyzed by lvgen_generate()
+    void EmitModules(const FilePath& outdir) const;
+
+    // Number of threads that parse the xml files, 0 means one per processor
+    void SetJobs(int jobs) { jobs_ = jobs; }
+
+    // Keep the parsed modules and regenerate the modules affected by every
+    // change of the xml files in |indir|. It never returns unless it fails.
+    bool Watch(const FilePath& indir, const FilePath& outdir);
+
 private:
     LvCodeGenerator();
 
-    bool ScanDirectory(const FilePath& dir, int level, bool ignore_components);
+    struct LvSourceFile {
+        LvSourceFile(const std::string& p, bool v) : path(p), is_view(v) {}
+        std::string path;
+        bool is_view;
+    };
+    using SourceFileList = std::vector<LvSourceFile>;
+
+    bool ScanDirectory(const FilePath& dir, int level, bool ignore_components,
+        SourceFileList* files);
+    bool ParseFiles(const SourceFileList& files);
+    bool ParseBatch(const SourceFileList& files, size_t begin, size_t end);
     bool ParseView(const std::string& file, bool is_view);
 
+    void WatchFiles();
+    void OnFileChanged(const FilePath& path, bool error);
+    void Update();
+    void CollectDependents(std::unordered_set<LvModuleContext*>* modules) const;
+    void RemoveModuleFiles(const std::string& name) const;
+
     bool GenerateModule(const LvModuleContext *mod, std::string& buf, 
         const FilePath& outdir) const;
     bool GenerateModuleHeader(const LvModuleContext* mod, std::string &buf) const;
     bool GenerateModuleSource(const LvModuleContext* mod, std::string &buf) const;
     bool GenerateFunction(const LvFunctionContext* fn, std::string& buf) const;
-    bool GenerateFunctionSignature(const LvFunctionContext* fn, char* tbuf, size_t maxsize) const;
+    bool GenerateFunctionSignature(const LvFunctionContext* fn, std::string& buf) const;
     bool GenerateFunctionInstruction(const LvFunctionContext* fn, std::string &buf, const char* indent) const;
     void GenerateCopyright(std::string& buf) const;
 
-    xml::XMLElement* FindChild(xml::XMLElement* parent, const char* elem);
-    template<typename Func>
-    void ForeachChild(xml::XMLElement* parent, Func&& fn) {
-        for (xml::XMLElement* node = parent->FirstChildElement();
-            node != nullptr;
-            node = node->NextSiblingElement()) {
-            fn(node);
-        }
-    }
     friend struct DefaultSingletonTraits<LvCodeGenerator>;
 
     // Private data
 private:
-    std::unordered_map<std::string, LvMap*> lv_props_;
+    LvAttributeDb attributes_;
+    int jobs_;
+
+    // Watch mode
+    enum { kUpdateDelayMs = 100 };
+    FilePath indir_;
+    FilePath outdir_;
+    std::unordered_map<std::string, base::files::FilePathWatcher*> watchers_;
+    std::unordered_set<std::string> changed_files_;
+    bool update_pending_;
 };
 
 
@@ -0,0 +1,454 @@
+/*
+ * Copyright 2025 wtcat
+ */
+
+// lvgen_bench writes a synthetic UI project and runs every phase of the code
+// generator on it. A process runs the generator once, so that its peak RSS
+// belongs to that run. The result is printed as json.
+
+#include <atomic>
+#include <new>
+#include <string>
+
+#include "base/at_exit.h"
+#include "base/base_time.h"
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/process_util.h"
+#include "base/string_number_conversions.h"
+#include "base/stringprintf.h"
+#include "base/values.h"
+
+#include "lvgen.h"
+#include "parser/lib/lv_mem.h"
+
+namespace {
+
+// Allocations of the C++ side, the parser allocates with lv_malloc
+std::atomic<uint64> cxx_new_count(0);
+std::atomic<uint64> cxx_delete_count(0);
+
+struct ProjectOptions {
+    int views;
+    int components;
+    int depth;          //Nesting depth of the containers of a view
+    int styles;         //Styles of every view and component
+    int widgets;        //Leaf widgets of a view
+    double reuse;       //Ratio of the leaves which are component instances
+    uint32 seed;
+};
+
+// Writes view_*.xml and components/comp_*.xml. The project only depends on the
+// options, the same options always give the same files.
+class ProjectGenerator {
+public:
+    explicit ProjectGenerator(const ProjectOptions& options)
+        : options_(options), random_(options.seed), files_(0), bytes_(0) {}
+
+    bool Write(const FilePath& dir);
+
+    int files() const { return files_; }
+    int64 bytes() const { return bytes_; }
+
+private:
+    uint32 Next() {
+        random_ = random_ * 1103515245u + 12345u;
+        return random_ >> 8;
+    }
+    int Next(int range) { return range > 0 ? (int)(Next() % (uint32)range) : 0; }
+    std::string NextColor() { return base::StringPrintf("0x%06x", Next() & 0xffffff); }
+
+    void WriteComponent(int index, std::string* xml);
+    void WriteView(int index, std::string* xml);
+    void WriteStyles(bool gradient, std::string* xml);
+    void WriteLeaf(int index, const std::string& indent, std::string* xml);
+    bool WriteFile(const FilePath& file, const std::string& xml);
+
+    ProjectOptions options_;
+    uint32 random_;
+    int files_;
+    int64 bytes_;
+};
+
+bool ProjectGenerator::Write(const FilePath& dir) {
+    FilePath component_dir = dir.Append(FILE_PATH_LITERAL("components"));
+    if (!file_util::CreateDirectory(component_dir))
+        return false;
+
+    std::string xml;
+    for (int i = 0; i < options_.components; i++) {
+        xml.clear();
+        WriteComponent(i, &xml);
+        if (!WriteFile(component_dir.AppendASCII(base::StringPrintf("comp_%d.xml", i)), xml))
+            return false;
+    }
+
+    for (int i = 0; i < options_.views; i++) {
+        xml.clear();
+        WriteView(i, &xml);
+        if (!WriteFile(dir.AppendASCII(base::StringPrintf("view_%d.xml", i)), xml))
+            return false;
+    }
+
+    return true;
+}
+
+void ProjectGenerator::WriteComponent(int index, std::string* xml) {
+    xml->append("<component>\n");
+    xml->append("\t<gradients>\n\t\t<horizontal name=\"grad\">\n");
+    base::StringAppendF(xml, "\t\t\t<stop color=\"%s\" frac=\"30%%\" opa=\"100%%\"/>\n",
+        NextColor().c_str());
+    base::StringAppendF(xml, "\t\t\t<stop color=\"%s\" frac=\"200\" opa=\"100%%\"/>\n",
+        NextColor().c_str());
+    xml->append("\t\t</horizontal>\n\t</gradients>\n\n");
+
+    xml->append("\t<consts>\n");
+    base::StringAppendF(xml, "\t\t<px name=\"size\" value=\"%d\"/>\n", 40 + Next(200));
+    base::StringAppendF(xml, "\t\t<color name=\"accent\" value=\"%s\"/>\n", NextColor().c_str());
+    xml->append("\t</consts>\n\n");
+
+    xml->append("\t<api>\n");
+    base::StringAppendF(xml, "\t\t<prop name=\"title\" type=\"string\" default=\"Component %d\"/>\n",
+        index);
+    base::StringAppendF(xml, "\t\t<prop name=\"bg_color\" type=\"color\" default=\"%s\"/>\n",
+        NextColor().c_str());
+    xml->append("\t</api>\n\n");
+
+    WriteStyles(true, xml);
+
+    xml->append("\t<view extends=\"lv_obj\" width=\"#size\" height=\"content\" "
+        "style_bg_color=\"$bg_color\"");
+    if (options_.styles > 0)
+        base::StringAppendF(xml, " styles=\"style_%d\"", Next(options_.styles));
+    xml->append(">\n");
+    xml->append("\t\t<lv_label text=\"$title\" style_text_color=\"#accent\"/>\n");
+
+    // Components only use the components before them, so there is no cycle
+    if (index > 0 && Next(1000) < (int)(options_.reuse * 1000)) {
+        base::StringAppendF(xml, "\t\t<comp_%d title=\"$title\" align=\"right_mid\"/>\n",
+            Next(index));
+    }
+    xml->append("\t</view>\n</component>\n");
+}
+
+void ProjectGenerator::WriteView(int index, std::string* xml) {
+    xml->append("<component>\n");
+    xml->append("\t<consts>\n");
+    base::StringAppendF(xml, "\t\t<color name=\"background\" value=\"%s\"/>\n",
+        NextColor().c_str());
+    xml->append("\t</consts>\n\n");
+
+    WriteStyles(false, xml);
+
+    xml->append("\t<view extends=\"lv_obj\" width=\"480\" height=\"480\" "
+        "style_bg_color=\"#background\">\n");
+
+    // Every group of leaves is put at the bottom of its own chain of containers
+    const int kLeavesPerGroup = 8;
+    int leaf = 0;
+    while (leaf < options_.widgets) {
+        std::string indent("\t\t");
+        for (int level = 0; level < options_.depth; level++) {
+            base::StringAppendF(xml, "%s<lv_obj width=\"100%%\" height=\"content\"",
+                indent.c_str());
+            if (options_.styles > 0)
+                base::StringAppendF(xml, " styles=\"style_%d\"", Next(options_.styles));
+            xml->append(">\n");
+            indent.push_back('\t');
+        }
+
+        for (int i = 0; i < kLeavesPerGroup && leaf < options_.widgets; i++, leaf++)
+            WriteLeaf(leaf, indent, xml);
+
+        for (int level = 0; level < options_.depth; level++) {
+            indent.resize(indent.size() - 1);
+            base::StringAppendF(xml, "%s</lv_obj>\n", indent.c_str());
+        }
+    }
+    xml->append("\t</view>\n</component>\n");
+}
+
+void ProjectGenerator::WriteStyles(bool gradient, std::string* xml) {
+    if (options_.styles <= 0)
+        return;
+
+    xml->append("\t<styles>\n");
+    for (int i = 0; i < options_.styles; i++) {
+        base::StringAppendF(xml, "\t\t<style name=\"style_%d\" bg_color=\"%s\" "
+            "bg_opa=\"%d\" border_width=\"%d\" border_color=\"%s\" pad_all=\"%d\"",
+            i, NextColor().c_str(), 128 + Next(128), Next(4), NextColor().c_str(), Next(16));
+        if (gradient && i == 0)
+            xml->append(" bg_grad=\"grad\"");
+        xml->append("/>\n");
+    }
+    xml->append("\t</styles>\n\n");
+}
+
+void ProjectGenerator::WriteLeaf(int index, const std::string& indent, std::string* xml) {
+    if (options_.components > 0 && Next(1000) < (int)(options_.reuse * 1000)) {
+        base::StringAppendF(xml, "%s<comp_%d title=\"Item %d\" bg_color=\"%s\"/>\n",
+            indent.c_str(), Next(options_.components), index, NextColor().c_str());
+        return;
+    }
+
+    switch (Next(3)) {
+    case 0:
+        base::StringAppendF(xml, "%s<lv_label text=\"Label %d\" align=\"center\" "
+            "long_mode=\"scroll_circular\"/>\n", indent.c_str(), index);
+        break;
+    case 1:
+        base::StringAppendF(xml, "%s<lv_button width=\"%d\" height=\"40\">\n",
+            indent.c_str(), 60 + Next(100));
+        base::StringAppendF(xml, "%s\t<lv_label text=\"Button %d\" align=\"center\"/>\n",
+            indent.c_str(), index);
+        base::StringAppendF(xml, "%s</lv_button>\n", indent.c_str());
+        break;
+    default:
+        base::StringAppendF(xml, "%s<lv_obj width=\"%d\" height=\"%d\" style_bg_color=\"%s\"/>\n",
+            indent.c_str(), 10 + Next(100), 10 + Next(100), NextColor().c_str());
+        break;
+    }
+}
+
+bool ProjectGenerator::WriteFile(const FilePath& file, const std::string& xml) {
+    if (file_util::WriteFile(file, xml.data(), (int)xml.size()) != (int)xml.size()) {
+        printf("Failed to write file(%s)\n", file.AsUTF8Unsafe().c_str());
+        return false;
+    }
+
+    files_++;
+    bytes_ += xml.size();
+    return true;
+}
+
+// Time and allocations of every phase
+class PhaseRecorder {
+public:
+    PhaseRecorder() : phases_(new ListValue) {}
+
+    void Begin(const char* name) {
+        name_ = name;
+        lv_mem_monitor(&lv_start_);
+        new_start_ = cxx_new_count.load(std::memory_order_relaxed);
+        delete_start_ = cxx_delete_count.load(std::memory_order_relaxed);
+        start_ = base::TimeTicks::HighResNow();
+    }
+
+    void End(bool okay) {
+        base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start_;
+        lv_mem_monitor_t lv_end;
+        lv_mem_monitor(&lv_end);
+
+        // The counters don't fit in the int of the json values
+        DictionaryValue* phase = new DictionaryValue;
+        phase->SetString("name", name_);
+        phase->SetBoolean("okay", okay);
+        phase->SetDouble("ms", elapsed.InMillisecondsF());
+        phase->SetDouble("lv_allocs", (double)(lv_end.alloc_cnt - lv_start_.alloc_cnt));
+        phase->SetDouble("lv_reallocs", (double)(lv_end.realloc_cnt - lv_start_.realloc_cnt));
+        phase->SetDouble("lv_frees", (double)(lv_end.free_cnt - lv_start_.free_cnt));
+        phase->SetDouble("cxx_allocs",
+            (double)(cxx_new_count.load(std::memory_order_relaxed) - new_start_));
+        phase->SetDouble("cxx_frees",
+            (double)(cxx_delete_count.load(std::memory_order_relaxed) - delete_start_));
+        phases_->Append(phase);
+        total_ += elapsed;
+    }
+
+    ListValue* Release() { return phases_.release(); }
+    base::TimeDelta total() const { return total_; }
+
+private:
+    scoped_ptr<ListValue> phases_;
+    std::string name_;
+    base::TimeTicks start_;
+    base::TimeDelta total_;
+    lv_mem_monitor_t lv_start_;
+    uint64 new_start_;
+    uint64 delete_start_;
+};
+
+int GetSwitchInt(const CommandLine* cmdline, const char* name, int value) {
+    if (cmdline->HasSwitch(name))
+        base::StringToInt(cmdline->GetSwitchValueASCII(name), &value);
+    return value;
+}
+
+size_t GetPeakMemory() {
+#if defined(OS_MACOSX)
+    scoped_ptr<base::ProcessMetrics> metrics(
+        base::ProcessMetrics::CreateProcessMetrics(base::GetCurrentProcessHandle(), NULL));
+#else
+    scoped_ptr<base::ProcessMetrics> metrics(
+        base::ProcessMetrics::CreateProcessMetrics(base::GetCurrentProcessHandle()));
+#endif
+    return metrics->GetPeakWorkingSetSize();
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    cxx_new_count.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+// The standard library asks for temporary buffers without exceptions
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    cxx_new_count.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    if (p) {
+        cxx_delete_count.fetch_add(1, std::memory_order_relaxed);
+        free(p);
+    }
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    operator delete(p);
+}
+
+int main(int argc, char* argv[]) {
+    base::AtExitManager atexit;
+
+    if (!CommandLine::Init(argc, argv))
+        return -1;
+
+    CommandLine* cmdline = CommandLine::ForCurrentProcess();
+    if (cmdline->HasSwitch("help")) {
+        printf("lvgen_bench [--views=N] [--components=N] [--depth=N] [--styles=N] "
+            "[--widgets=widgets per view] [--reuse=percent of component instances] "
+            "[--seed=N] [--jobs=N] [--db=lvdb.xml] [--cold-db] "
+            "[--workdir=directory, the project goes to lvgen_bench.<seed> in it] "
+            "[--output=json file]\n");
+        return 0;
+    }
+
+    ProjectOptions options;
+    options.views = GetSwitchInt(cmdline, "views", 100);
+    options.components = GetSwitchInt(cmdline, "components", 50);
+    options.depth = GetSwitchInt(cmdline, "depth", 3);
+    options.styles = GetSwitchInt(cmdline, "styles", 4);
+    options.widgets = GetSwitchInt(cmdline, "widgets", 40);
+    options.reuse = GetSwitchInt(cmdline, "reuse", 30) / 100.0;
+    options.seed = (uint32)GetSwitchInt(cmdline, "seed", 1);
+
+    FilePath workdir(FILE_PATH_LITERAL("."));
+    if (cmdline->HasSwitch("workdir"))
+        workdir = cmdline->GetSwitchValuePath("workdir");
+
+    FilePath db(FILE_PATH_LITERAL("lvdb.xml"));
+    if (cmdline->HasSwitch("db"))
+        db = cmdline->GetSwitchValuePath("db");
+
+    // The project is written again by every run, the runs never mix. Only
+    // the directories of the bench are deleted, never the workdir itself.
+    FilePath benchdir = workdir.AppendASCII(base::StringPrintf("lvgen_bench.%u", options.seed));
+    FilePath indir = benchdir.Append(FILE_PATH_LITERAL("project"));
+    FilePath outdir = benchdir.Append(FILE_PATH_LITERAL("code"));
+    file_util::Delete(indir, true);
+    file_util::Delete(outdir, true);
+    if (!file_util::CreateDirectory(outdir)) {
+        printf("Failed to create path(%s)\n", outdir.AsUTF8Unsafe().c_str());
+        return -1;
+    }
+
+    ProjectGenerator generator(options);
+    if (!generator.Write(indir))
+        return -1;
+
+    // Measure the compilation of the attribute database instead of its cache
+    if (cmdline->HasSwitch("cold-db"))
+        file_util::Delete(db.AddExtension(FILE_PATH_LITERAL("cache")), false);
+
+    app::LvCodeGenerator* lvgen = app::LvCodeGenerator::GetInstance();
+    if (cmdline->HasSwitch("jobs"))
+        lvgen->SetJobs(GetSwitchInt(cmdline, "jobs", 0));
+
+    PhaseRecorder recorder;
+    bool okay;
+
+    recorder.Begin("load_attributes");
+    okay = lvgen->LoadAttributes(db);
+    recorder.End(okay);
+
+    if (okay) {
+        recorder.Begin("parse");
+        okay = lvgen->LoadViews(indir);
+        recorder.End(okay);
+    }
+
+    if (okay) {
+        recorder.Begin("analyze");
+        okay = lvgen_generate();
+        recorder.End(okay);
+    }
+
+    if (okay) {
+        recorder.Begin("emit");
+        lvgen->EmitModules(outdir);
+        recorder.End(true);
+    }
+
+    DictionaryValue result;
+    DictionaryValue* project = new DictionaryValue;
+    project->SetInteger("views", options.views);
+    project->SetInteger("components", options.components);
+    project->SetInteger("depth", options.depth);
+    project->SetInteger("styles", options.styles);
+    project->SetInteger("widgets", options.widgets);
+    project->SetDouble("reuse", options.reuse);
+    project->SetInteger("seed", (int)options.seed);
+    project->SetInteger("files", generator.files());
+    project->SetDouble("bytes", (double)generator.bytes());
+    result.Set("project", project);
+    result.Set("phases", recorder.Release());
+    result.SetBoolean("okay", okay);
+    result.SetDouble("total_ms", recorder.total().InMillisecondsF());
+    result.SetDouble("peak_rss_kb", (double)(GetPeakMemory() / 1024));
+
+    std::string json;
+    base::JSONWriter::WriteWithOptions(&result, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+    if (cmdline->HasSwitch("output")) {
+        FilePath output = cmdline->GetSwitchValuePath("output");
+        if (file_util::WriteFile(output, json.data(), (int)json.size()) != (int)json.size()) {
+            printf("Failed to write file(%s)\n", output.AsUTF8Unsafe().c_str());
+            return -1;
+        }
+    } else {
+        printf("%s", json.c_str());
+    }
+
+    return !okay;
+}
@@ -6,14 +6,5 @@
 
 bool lvgen_cc_find_sym(const char* ns, const char* key, 
     const char **pv, const char **pt) {
-    const app::LvCodeGenerator::LvAttribute* attr;
-    attr = app::LvCodeGenerator::GetInstance()->FindAttribute(ns, key);
-    if (attr != nullptr) {
-        if (pv)
-            *pv = attr->value.c_str();
-        if (pt)
-            *pt = attr->type.c_str();
-        return true;
-    }
-    return false;
+    return app::LvCodeGenerator::GetInstance()->FindAttribute(ns, key, pv, pt);
 }
\ No newline at end of file
@@ -13,34 +13,91 @@
 #include "parser/lib/lv_mem.h"
 #include "parser/lib/lv_string.h"
 #include "parser/lv_xml_component.h"
+#include "parser/lv_xml_component_private.h"
 #include "parser/lv_xml.h"
 
 #include "parser/lib/lv_stdio.h"
 
 static struct global_context lvgen_context;
 
+/* The module being parsed on this thread */
+static LV_THREAD_LOCAL struct module_context* lvgen_module;
+
 static void lvgen_func_clear(lv_ll_t* fn_ll) {
     struct func_context* fn;
 
     LV_LL_READ(fn_ll, fn) {
         lv_ll_clear(&fn->ll_insn);
         lv_ll_clear(&fn->ll_objs);
+        lv_hash_clear(&fn->obj_index);
     }
     lv_ll_clear(fn_ll);
 }
 
 static void lvgen_module_clear(struct module_context* mod) {
     lvgen_func_clear(&mod->ll_funs);
+    lv_hash_clear(&mod->fn_index);
     lv_ll_clear(&mod->ll_fdecls);
     lv_ll_clear(&mod->ll_deps);
+    lv_ll_clear(&mod->ll_uses);
+    lv_strtab_clear(&mod->strtab);
+    lv_arena_release(&mod->arena);
+}
+
+static void lvgen_module_remove(struct module_context* mod) {
+    struct global_context* ctx = lvgen_get_context();
+
+    lvgen_module_clear(mod);
+    lv_hash_remove(&ctx->mod_index, mod->name);
+    lv_ll_remove(&ctx->ll_modules, mod);
+    lv_free(mod);
 }
 
 struct global_context* lvgen_get_context(void) {
     return &lvgen_context;
 }
 
-static struct module_context* lvgen_new_module(const char* file, bool is_view) {
-    lv_ll_t* ll_modules = &lvgen_get_context()->ll_modules;
+static lv_hash_t* lvgen_func_index(struct module_context* mod) {
+    return mod != NULL ? &mod->fn_index : &lvgen_get_context()->fn_index;
+}
+
+static lv_arena_t* lvgen_arena(struct module_context* mod) {
+    return mod != NULL ? &mod->arena : &lvgen_get_context()->arena;
+}
+
+static lv_strtab_t* lvgen_strtab(struct module_context* mod) {
+    return mod != NULL ? &mod->strtab : &lvgen_get_context()->strtab;
+}
+
+/* Take a function out of its module, its nodes stay in the arena */
+static void lvgen_func_remove(struct func_context* fn) {
+    lv_hash_t* index = lvgen_func_index(fn->owner);
+
+    if (lv_hash_find(index, fn->signature) == fn)
+        lv_hash_remove(index, fn->signature);
+    lv_ll_clear(&fn->ll_insn);
+    lv_ll_clear(&fn->ll_objs);
+    lv_hash_clear(&fn->obj_index);
+    lv_ll_remove(fn->owner != NULL ? &fn->owner->ll_funs : &lvgen_get_context()->ll_funs, fn);
+}
+
+static void lvgen_module_init(struct module_context* mod, const char* name,
+    const char* path, bool is_view) {
+    lv_strlcpy(mod->name, name, LV_SYMBOL_LEN);
+    lv_strlcpy(mod->path, path, sizeof(mod->path));
+    lv_arena_init(&mod->arena, 0);
+    lv_strtab_init(&mod->strtab, &mod->arena);
+    lv_ll_init_arena(&mod->ll_fdecls, sizeof(struct forward_declare), &mod->arena);
+    lv_ll_init_arena(&mod->ll_funs, sizeof(struct func_context), &mod->arena);
+    lv_ll_init_arena(&mod->ll_deps, sizeof(struct module_depend), &mod->arena);
+    lv_ll_init_arena(&mod->ll_uses, sizeof(struct module_depend), &mod->arena);
+    lv_hash_init(&mod->fn_index);
+    mod->is_view = is_view;
+    mod->scope = NULL;
+}
+
+struct module_context* lvgen_add_module(const char* file, bool is_view) {
+    struct global_context* ctx = lvgen_get_context();
     struct module_context* mod;
     char modname[LV_SYMBOL_LEN];
 
@@ -50,40 +107,41 @@ static struct module_context* lvgen_new_module(const char* file, bool is_view) {
 
     mod = lvgen_get_module_by_name(modname);
     if (mod == NULL) {
-        mod = lv_ll_ins_tail(ll_modules);
+        mod = lv_ll_ins_tail(&ctx->ll_modules);
         if (mod != NULL) {
-            lv_strlcpy(mod->name, modname, LV_SYMBOL_LEN);
-            lv_strlcpy(mod->path, file, sizeof(mod->path));
-            lv_ll_init(&mod->ll_fdecls, sizeof(struct forward_declare));
-            lv_ll_init(&mod->ll_funs, sizeof(struct func_context));
-            lv_ll_init(&mod->ll_deps, sizeof(struct module_depend));
-            mod->is_view = is_view;
+            lv_hash_entry_t* entry;
+
+            lvgen_module_init(mod, modname, file, is_view);
+            entry = lv_hash_insert(&ctx->mod_index, mod->name);
+            if (entry == NULL) {
+                lv_ll_remove(&ctx->ll_modules, mod);
+                lv_free(mod);
+                mod = NULL;
+            } else {
+                entry->key = mod->name;
+                entry->value = mod;
+            }
         }
     }
 
-    lvgen_get_context()->module = mod;
+    lvgen_module = mod;
     return mod;
 }
 
 struct module_context* lvgen_get_module(void) {
-    return lvgen_get_context()->module;
+    return lvgen_module;
 }
 
 struct module_context* lvgen_get_module_by_name(const char *name) {
-    struct module_context* mod;
-
-    LV_LL_READ(&lvgen_get_context()->ll_modules, mod) {
-        if (!lv_strcmp(mod->name, name))
-            return mod;
-    }
-    return NULL;
+    return lv_hash_find(&lvgen_get_context()->mod_index, name);
 }
 
 struct module_depend *lvgen_new_module_depend(struct module_context* mod, 
     struct func_context* depfn) {
     struct module_depend* dep;
 
-    if (mod == depfn->owner) {
+    /* Global functions are generated by the shared module */
+    if (mod == depfn->owner || depfn->owner == NULL) {
         depfn->ref_cnt++;
         return NULL;
     }
@@ -103,6 +161,25 @@ struct module_depend *lvgen_new_module_depend(struct module_context* mod,
     return dep;
 }
 
+struct module_depend* lvgen_new_module_use(struct module_context* mod,
+    struct module_context* used) {
+    struct module_depend* use;
+
+    if (mod == used || used == NULL)
+        return NULL;
+
+    LV_LL_READ(&mod->ll_uses, use) {
+        if (use->mod == used)
+            return use;
+    }
+
+    use = lv_ll_ins_tail(&mod->ll_uses);
+    if (use != NULL)
+        use->mod = used;
+
+    return use;
+}
+
 struct func_context* lvgen_new_global_func(void) {
     return lvgen_new_func(&lvgen_get_context()->ll_funs, NULL, NULL);
 }
@@ -129,37 +206,66 @@ struct func_context* lvgen_new_func(lv_ll_t *fn_ll, struct module_context *mod,
     struct func_context* fn;
 
     if (signature != NULL) {
-        LV_LL_READ(fn_ll, fn) {
-            if (!lv_strcmp(signature, fn->signature))
-                return fn;
-        }
+        fn = lv_hash_find(lvgen_func_index(mod), signature);
+        if (fn != NULL)
+            return fn;
     }
 
     fn = lv_ll_ins_tail(fn_ll);
     if (fn != NULL) {
+        lv_arena_t* arena = lvgen_arena(mod);
+
         lv_memset(fn, 0, sizeof(*fn));
-        lv_ll_init(&fn->ll_insn, sizeof(struct func_callinsn));
-        lv_ll_init(&fn->ll_objs, sizeof(lv_obj_t));
+        lv_ll_init_arena(&fn->ll_insn, sizeof(struct func_callinsn), arena);
+        lv_ll_init_arena(&fn->ll_objs, sizeof(lv_obj_t), arena);
         fn->owner = mod;
         if (signature != NULL)
-            lv_strlcpy(fn->signature, signature, sizeof(fn->signature));
+            lvgen_set_func_signature(fn, "%s", signature);
     }
 
     return fn;
 }
 
+void lvgen_set_func_signature(struct func_context* fn, const char* fmt, ...) {
+    lv_hash_t* index = lvgen_func_index(fn->owner);
+    lv_hash_entry_t* entry;
+    va_list ap;
+
+    if (fn->signature[0] != '\0' && lv_hash_find(index, fn->signature) == fn)
+        lv_hash_remove(index, fn->signature);
+
+    va_start(ap, fmt);
+    lv_vsnprintf(fn->signature, sizeof(fn->signature), fmt, ap);
+    va_end(ap);
+
+    /* The first function with a signature keeps it */
+    entry = lv_hash_insert(index, fn->signature);
+    if (entry != NULL && entry->value == NULL)
+        entry->value = fn;
+}
+
 lv_obj_t* lvgen_new_lvalue(struct func_context* fn, const char *name, 
     struct func_callinsn *insn) {
+    lv_hash_entry_t* entry;
     lv_obj_t* obj;
-    int no = 0;
+    int no;
 
-    LV_LL_READ(&fn->ll_objs, obj) {
-        if (!lv_memcmp(obj->base.name, name, lv_strlen(name)))
-            no++;
+    /* The counter is stored in the value, the key lives in the string table */
+    entry = lv_hash_insert(&fn->obj_index, name);
+    if (entry == NULL)
+        return NULL;
+    if (entry->value == NULL) {
+        entry->key = lv_strtab_intern(lvgen_strtab(fn->owner), name);
+        if (entry->key == NULL) {
+            lv_hash_remove(&fn->obj_index, name);
+            return NULL;
+        }
     }
+    no = (int)(uintptr_t)entry->value;
 
     obj = lv_ll_ins_tail(&fn->ll_objs);
     if (obj != NULL) {
+        entry->value = (void*)(uintptr_t)(no + 1);
         lv_snprintf(obj->base.name, sizeof(obj->base.name), "%s_%d", name, no);
 
         /* Attach left-value to instruction */
@@ -182,42 +288,105 @@ void lvgen_set_func_rettype(struct func_context* fn, int type) {
     fn->rtype = type;
 }
 
-struct func_callinsn* lvgen_new_callinsn(struct func_context* fn,
-    int retype, const char *insn, ...) {
+static struct func_callinsn* lvgen_new_callinsn_va(struct func_context* fn,
+    int retype, const char *insn, va_list ap) {
     struct func_callinsn* pins = lv_ll_ins_tail(&fn->ll_insn);
     if (pins != NULL) {
-        va_list ap;
+        lv_strtab_t* strtab = lvgen_strtab(fn->owner);
+        const char* args[LV_MAX_ARGS];
+        bool failed = false;
+        int args_num = 0;
 
         lv_memset(pins, 0, sizeof(*pins));
-        va_start(ap, insn);
-        for (int i = 0; i < LV_MAX_ARGS; i++) {
+        for (; args_num < LV_MAX_ARGS; args_num++) {
             const char* parg = va_arg(ap, const char*);
-            if (parg == NULL) {
-                lv_strlcpy(pins->insn, insn, sizeof(pins->insn));
-                pins->rtype = retype;
+            if (parg == NULL)
+                break;
+
+            args[args_num] = lv_strtab_intern(strtab, parg);
+            if (args[args_num] == NULL) {
+                failed = true;
                 break;
             }
+        }
 
-            lv_strlcpy(pins->args[i], parg, sizeof(pins->args[0]));
-            pins->args_num++;
+        if (!failed) {
+            pins->insn = lv_strtab_intern(strtab, insn);
+            pins->args = lv_arena_alloc(lvgen_arena(fn->owner), args_num * sizeof(args[0]));
+            failed = pins->insn == NULL || pins->args == NULL;
         }
-        va_end(ap);
+
+        if (failed) {
+            lv_ll_remove(&fn->ll_insn, pins);
+            return NULL;
+        }
+
+        lv_memcpy(pins->args, args, args_num * sizeof(args[0]));
+        pins->args_num = args_num;
+        pins->rtype = retype;
         return pins;
     }
 
     return NULL;
 }
 
+struct func_callinsn* lvgen_new_callinsn(struct func_context* fn,
+    int retype, const char *insn, ...) {
+    struct func_callinsn* pins;
+    va_list ap;
+
+    va_start(ap, insn);
+    pins = lvgen_new_callinsn_va(fn, retype, insn, ap);
+    va_end(ap);
+    return pins;
+}
+
+struct func_callinsn* lvgen_new_funcinsn(struct func_context* fn,
+    struct func_context* callee, ...) {
+    struct func_callinsn* pins;
+    va_list ap;
+
+    va_start(ap, callee);
+    pins = lvgen_new_callinsn_va(fn, callee->rtype, callee->signature, ap);
+    va_end(ap);
+
+    if (pins != NULL)
+        pins->callee = callee;
+    return pins;
+}
+
+const char* lvgen_insn_callee(const struct func_callinsn* insn) {
+    if (insn->callee == NULL)
+        return insn->insn;
+    if (insn->callee->alias != NULL)
+        return insn->callee->alias->signature;
+    return insn->callee->signature;
+}
+
 struct func_callinsn* lvgen_new_exprinsn(struct func_context* fn, 
     const char* insn, ...) {
     struct func_callinsn* pins = lv_ll_ins_tail(&fn->ll_insn);
     if (pins != NULL) {
-        va_list ap;
+        va_list ap, aq;
+        char* expr;
+        int len;
 
-        pins->rtype = type__lv_expr;
         va_start(ap, insn);
-        lv_vsnprintf(pins->expr, sizeof(pins->expr), insn, ap);
+        va_copy(aq, ap);
+        len = lv_vsnprintf(NULL, 0, insn, aq);
+        va_end(aq);
+
+        expr = lv_arena_alloc(lvgen_arena(fn->owner), len + 1);
+        if (expr != NULL)
+            lv_vsnprintf(expr, len + 1, insn, ap);
         va_end(ap);
+
+        if (expr == NULL) {
+            lv_ll_remove(&fn->ll_insn, pins);
+            return NULL;
+        }
+        pins->rtype = type__lv_expr;
+        pins->expr = expr;
     }
     return pins;
 }
@@ -226,35 +395,470 @@ int lvgen_parse(const char* file, bool is_view) {
     struct module_context* mod;
     int ret;
 
-    mod = lvgen_new_module(file, is_view);
+    mod = lvgen_add_module(file, is_view);
     if (mod == NULL)
         return -ENOMEM;
     
     ret = lv_xml_component_register_from_file(file);
-    if (ret < 0 && mod) {
-        lvgen_module_clear(mod);
-        lv_ll_remove(&lvgen_get_context()->ll_modules, mod);
-        lv_free(mod);
+    if (ret < 0) {
+        lvgen_module_remove(mod);
+        lvgen_module = NULL;
     }
 
     return ret;
 }
 
+int lvgen_parse_module(struct module_context* mod) {
+    lv_xml_component_scope_t* scope;
+    int ret;
+
+    scope = lv_malloc(sizeof(*scope));
+    if (scope == NULL)
+        return -ENOMEM;
+
+    lvgen_module = mod;
+    ret = lv_xml_component_parse_file(mod->path, scope);
+    lvgen_module = NULL;
+    if (ret < 0) {
+        lv_free(scope);
+        return ret;
+    }
+
+    mod->scope = scope;
+    return 0;
+}
+
+int lvgen_merge_module(struct module_context* mod, int result) {
+    if (mod->scope != NULL) {
+        if (result == 0)
+            result = lv_xml_component_register_scope(mod->scope);
+        /* Free the parsed data unless the registered scope took it over */
+        if (result != 0)
+            lv_xml_component_scope_deinit(mod->scope);
+        lv_free(mod->scope);
+        mod->scope = NULL;
+    }
+
+    /* Leave the same current module as lvgen_parse() does */
+    lvgen_module = mod;
+    if (result < 0) {
+        lvgen_module_remove(mod);
+        lvgen_module = NULL;
+    }
+
+    return result;
+}
+
+void lvgen_reset_module(struct module_context* mod) {
+    if (lv_streq(mod->name, "globals"))
+        lv_xml_component_reset_globals();
+    else
+        lv_xml_component_unregister(mod->name);
+    lvgen_module_clear(mod);
+}
+
+int lvgen_reparse_module(struct module_context* mod) {
+    int ret;
+
+    lvgen_module = mod;
+    ret = lv_xml_component_register_from_file(mod->path);
+    if (ret < 0)
+        printf("Failed to parse module(%s@ %s)\n", mod->name, mod->path);
+
+    return ret;
+}
+
+void lvgen_remove_module(struct module_context* mod) {
+    lvgen_reset_module(mod);
+    if (lvgen_module == mod)
+        lvgen_module = NULL;
+    lvgen_module_remove(mod);
+}
+
+/* A property written by a later setter, see lvgen_optimize_func() */
+struct setter_write {
+    const char* insn;
+    const char* selector;
+    struct setter_write* next;
+};
+
+/* 
+ * `lv_obj_set_<prop>(obj, value)` and `lv_obj_set_style_<prop>(obj, value, selector)`
+ * replace the property, its previous value is lost.
+ */
+static bool lvgen_is_setter(const struct func_callinsn* ins, const char** selector) {
+    if (ins->lvalue != NULL)
+        return false;
+
+    if (ins->args_num == 2 && !lv_strncmp(ins->insn, "lv_obj_set_", 11)) {
+        *selector = NULL;
+        return true;
+    }
+    if (ins->args_num == 3 && !lv_strncmp(ins->insn, "lv_obj_set_style_", 17)) {
+        *selector = ins->args[2];
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Calls which don't read the properties of their objects: creating a child
+ * doesn't read its parent and the layout is only updated later. Changing the
+ * state may start transitions from the current values, so it isn't here.
+ */
+static bool lvgen_is_blind(const struct func_callinsn* ins) {
+    static const char* const blind_calls[] = {
+        "lv_obj_add_style",
+        "lv_obj_add_flag",
+        "lv_obj_remove_flag",
+        "lv_obj_set_flag",
+    };
+    size_t len;
+
+    if (ins->lvalue != NULL) {
+        len = lv_strlen(ins->insn);
+        return len > 7 && lv_streq(ins->insn + len - 7, "_create");
+    }
+
+    for (size_t i = 0; i < sizeof(blind_calls) / sizeof(blind_calls[0]); i++) {
+        if (lv_streq(ins->insn, blind_calls[i]))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Walk the function backwards and remember the properties written by the
+ * setters of every object. A setter is dropped if the property is written
+ * again before anything else uses the object.
+ */
+static int lvgen_optimize_func(struct func_context* fn) {
+    struct func_callinsn* ins;
+    struct func_callinsn* prev;
+    lv_hash_t writes;   /* Object name -> list of setter_write */
+    lv_arena_t arena;
+    int dropped = 0;
+
+    lv_hash_init(&writes);
+    lv_arena_init(&arena, 4096);
+
+    for (ins = lv_ll_get_tail(&fn->ll_insn); ins != NULL; ins = prev) {
+        const char* selector;
+        int first = 0;
+
+        prev = lv_ll_get_prev(&fn->ll_insn, ins);
+
+        /* An expression may use any object */
+        if (LV_IS_EXPR(ins->rtype)) {
+            lv_hash_clear(&writes);
+            continue;
+        }
+
+        if (lvgen_is_setter(ins, &selector)) {
+            lv_hash_entry_t* entry = lv_hash_insert(&writes, ins->args[0]);
+            struct setter_write* w;
+
+            if (entry == NULL)
+                break;
+
+            for (w = entry->value; w != NULL; w = w->next) {
+                if (w->insn == ins->insn && w->selector == selector)
+                    break;
+            }
+            if (w != NULL) {
+                lv_ll_remove(&fn->ll_insn, ins);
+                dropped++;
+                continue;
+            }
+
+            w = lv_arena_alloc(&arena, sizeof(*w));
+            if (w == NULL)
+                break;
+            w->insn = ins->insn;
+            w->selector = selector;
+            w->next = entry->value;
+            entry->value = w;
+            first = 1;
+        } else if (lvgen_is_blind(ins)) {
+            continue;
+        }
+
+        /* Any other use of an object keeps the setters before it */
+        for (int i = first; i < ins->args_num; i++)
+            lv_hash_remove(&writes, ins->args[i]);
+    }
+
+    lv_hash_clear(&writes);
+    lv_arena_release(&arena);
+    return dropped;
+}
+
+bool lvgen_generate_module(struct module_context* mod) {
+    struct func_context* fn;
+
+    /* The global scope has no view even if it is next to the views */
+    if (lv_streq(mod->name, "globals"))
+        return true;
+
+    if (mod->is_view && !lv_xml_create(NULL, mod->name, NULL)) {
+        printf("Failed to generate moudle(%s@ %s)\n", mod->name, mod->path);
+        return false;
+    }
+
+    LV_LL_READ(&mod->ll_funs, fn) {
+        lvgen_optimize_func(fn);
+    }
+    return true;
+}
+
 bool lvgen_generate(void) {
     struct global_context* ctx = lvgen_get_context();
     struct module_context* mod;
 
     LV_LL_READ(&ctx->ll_modules, mod) {
-        if (mod->is_view && !lv_xml_create(NULL, mod->name, NULL)) {
-            printf("Failed to generate moudle(%s@ %s)\n", mod->name, mod->path);
+        lvgen_generate_module(mod);
+    }
+    lvgen_share_funcs();
+    return true;
+}
+
+/* The terminating zero separates the strings */
+static uint32_t lvgen_hash_append(uint32_t hash, const char* str) {
+    return lv_hash_bytes(hash, str, lv_strlen(str) + 1);
+}
+
+/* The hash of the body, the name of the function isn't part of it */
+static uint32_t lvgen_func_hash(const struct func_context* fn) {
+    const struct func_callinsn* ins;
+    uint32_t hash = LV_HASH_SEED;
+
+    hash = lvgen_hash_append(hash, lv_type_to_name(fn->rtype));
+    for (int i = 0; i < fn->args_num; i++) {
+        hash = lvgen_hash_append(hash, fn->args[i].type);
+        hash = lvgen_hash_append(hash, fn->args[i].name);
+    }
+
+    LV_LL_READ(&fn->ll_insn, ins) {
+        if (LV_IS_EXPR(ins->rtype)) {
+            hash = lvgen_hash_append(hash, ins->expr);
+            continue;
         }
+
+        hash = lvgen_hash_append(hash, lv_type_to_name(ins->rtype));
+        hash = lvgen_hash_append(hash, ins->lvalue != NULL ? ins->lvalue : "");
+        hash = lvgen_hash_append(hash, lvgen_insn_callee(ins));
+        for (int i = 0; i < ins->args_num; i++)
+            hash = lvgen_hash_append(hash, ins->args[i]);
+    }
+
+    return hash;
+}
+
+static bool lvgen_insn_equal(const struct func_callinsn* a, const struct func_callinsn* b) {
+    if (a->rtype != b->rtype)
+        return false;
+    if (LV_IS_EXPR(a->rtype))
+        return lv_streq(a->expr, b->expr);
+
+    if (a->args_num != b->args_num || (a->lvalue == NULL) != (b->lvalue == NULL))
+        return false;
+    if (a->lvalue != NULL && !lv_streq(a->lvalue, b->lvalue))
+        return false;
+    if (!lv_streq(lvgen_insn_callee(a), lvgen_insn_callee(b)))
+        return false;
+
+    for (int i = 0; i < a->args_num; i++) {
+        if (!lv_streq(a->args[i], b->args[i]))
+            return false;
     }
     return true;
 }
 
+static bool lvgen_func_equal(const struct func_context* a, const struct func_context* b) {
+    const struct func_callinsn* ia;
+    const struct func_callinsn* ib;
+
+    if (a->rtype != b->rtype || a->args_num != b->args_num)
+        return false;
+
+    for (int i = 0; i < a->args_num; i++) {
+        if (!lv_streq(a->args[i].type, b->args[i].type) ||
+            !lv_streq(a->args[i].name, b->args[i].name))
+            return false;
+    }
+
+    ia = lv_ll_get_head(&a->ll_insn);
+    ib = lv_ll_get_head(&b->ll_insn);
+    while (ia != NULL && ib != NULL) {
+        if (!lvgen_insn_equal(ia, ib))
+            return false;
+        ia = lv_ll_get_next(&a->ll_insn, ia);
+        ib = lv_ll_get_next(&b->ll_insn, ib);
+    }
+    return ia == NULL && ib == NULL;
+}
+
+/* Copy the instructions of a function into the shared module */
+static bool lvgen_share_body(struct func_context* copy, const struct func_context* fn) {
+    struct module_context* shared = copy->owner;
+    const struct func_callinsn* ins;
+
+    LV_LL_READ(&fn->ll_insn, ins) {
+        struct func_callinsn* pins = lv_ll_ins_tail(&copy->ll_insn);
+        if (pins == NULL)
+            return false;
+
+        lv_memset(pins, 0, sizeof(*pins));
+        pins->rtype = ins->rtype;
+        if (LV_IS_EXPR(ins->rtype)) {
+            pins->expr = lv_strtab_intern(&shared->strtab, ins->expr);
+            if (pins->expr == NULL)
+                return false;
+            continue;
+        }
+
+        /* The functions called are shared before their callers */
+        pins->callee = ins->callee != NULL && ins->callee->alias != NULL ?
+            ins->callee->alias : ins->callee;
+        pins->insn = lv_strtab_intern(&shared->strtab, lvgen_insn_callee(ins));
+        pins->args = lv_arena_alloc(&shared->arena, ins->args_num * sizeof(ins->args[0]));
+        if (pins->insn == NULL || pins->args == NULL)
+            return false;
+
+        for (int i = 0; i < ins->args_num; i++) {
+            pins->args[i] = lv_strtab_intern(&shared->strtab, ins->args[i]);
+            if (pins->args[i] == NULL)
+                return false;
+        }
+        pins->args_num = ins->args_num;
+
+        if (ins->lvalue != NULL) {
+            pins->lvalue = lv_strtab_intern(&shared->strtab, ins->lvalue);
+            if (pins->lvalue == NULL)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/* Copy the body of a function into a new function of the shared module */
+static struct func_context* lvgen_share_func(const struct func_context* fn,
+    const char* signature) {
+    struct module_context* shared = lvgen_get_shared_module();
+    struct func_context* copy;
+
+    copy = lvgen_new_module_func_named(shared, signature);
+    if (copy == NULL)
+        return NULL;
+
+    lv_memcpy(copy->args, fn->args, sizeof(fn->args));
+    copy->args_num = fn->args_num;
+    copy->rtype = fn->rtype;
+    copy->kind = fn->kind;
+    copy->grad_cnt = fn->grad_cnt;
+    copy->export_cnt = 1;
+
+    /* A truncated body must not be emitted or matched by the next probes */
+    if (!lvgen_share_body(copy, fn)) {
+        lvgen_func_remove(copy);
+        return NULL;
+    }
+
+    return copy;
+}
+
+static void lvgen_share_list(lv_ll_t* fn_ll, int kind, const char* prefix) {
+    struct module_context* shared = lvgen_get_shared_module();
+    struct func_context* fn;
+
+    LV_LL_READ(fn_ll, fn) {
+        char signature[LV_SYMBOL_LEN];
+        uint32_t hash;
+
+        if (fn->kind != kind)
+            continue;
+
+        /* Probe the next names if two different bodies have the same hash */
+        for (hash = lvgen_func_hash(fn); ; hash++) {
+            struct func_context* found;
+
+            lv_snprintf(signature, sizeof(signature), LV_FN_PREFIX "%s_%08x_init", prefix, hash);
+            found = lv_hash_find(&shared->fn_index, signature);
+            if (found == NULL) {
+                fn->alias = lvgen_share_func(fn, signature);
+                break;
+            }
+            if (lvgen_func_equal(fn, found)) {
+                fn->alias = found;
+                break;
+            }
+        }
+    }
+}
+
+static void lvgen_share_kind(int kind, const char* prefix) {
+    struct global_context* ctx = lvgen_get_context();
+    struct module_context* mod;
+
+    lvgen_share_list(&ctx->ll_funs, kind, prefix);
+    LV_LL_READ(&ctx->ll_modules, mod) {
+        lvgen_share_list(&mod->ll_funs, kind, prefix);
+    }
+}
+
+static void lvgen_unshare_list(lv_ll_t* fn_ll) {
+    struct func_context* fn;
+
+    LV_LL_READ(fn_ll, fn) {
+        fn->alias = NULL;
+    }
+}
+
+struct module_context* lvgen_get_shared_module(void) {
+    return &lvgen_get_context()->shared;
+}
+
+void lvgen_share_funcs(void) {
+    struct global_context* ctx = lvgen_get_context();
+    struct module_context* mod;
+    struct func_context* fn;
+    struct func_callinsn* ins;
+
+    lvgen_module_clear(&ctx->shared);
+
+    lvgen_unshare_list(&ctx->ll_funs);
+    LV_LL_READ(&ctx->ll_modules, mod) {
+        lvgen_unshare_list(&mod->ll_funs);
+    }
+
+    /* The style init functions call the gradient init functions */
+    lvgen_share_kind(LV_FUNC_GRAD_INIT, "grad");
+    lvgen_share_kind(LV_FUNC_STYLE_INIT, "style");
+
+    /* Include the shared module where a shared function is called */
+    LV_LL_READ(&ctx->ll_modules, mod) {
+        LV_LL_READ(&mod->ll_funs, fn) {
+            if (fn->alias != NULL)
+                continue;
+
+            LV_LL_READ(&fn->ll_insn, ins) {
+                if (!LV_IS_EXPR(ins->rtype) && ins->callee != NULL && ins->callee->alias != NULL)
+                    lvgen_new_module_depend(mod, ins->callee->alias);
+            }
+        }
+    }
+}
+
 void lvgen_context_init(void) {
-    lv_ll_init(&lvgen_context.ll_funs, sizeof(struct func_context));
+    lv_arena_init(&lvgen_context.arena, 0);
+    lv_strtab_init(&lvgen_context.strtab, &lvgen_context.arena);
+    lv_ll_init_arena(&lvgen_context.ll_funs, sizeof(struct func_context),
+        &lvgen_context.arena);
     lv_ll_init(&lvgen_context.ll_modules, sizeof(struct module_context));
+    lv_hash_init(&lvgen_context.fn_index);
+    lv_hash_init(&lvgen_context.mod_index);
+    lvgen_module_init(&lvgen_context.shared, "lvgen_shared", "", false);
     lv_xml_init();
 }
 
@@ -270,4 +874,11 @@ void lvgen_context_destroy(void) {
         }
         lv_ll_clear(&ctx->ll_modules);
     }
+    lv_hash_clear(&ctx->fn_index);
+    lv_hash_clear(&ctx->mod_index);
+    lvgen_module_clear(&ctx->shared);
+
+    /* Release all functions and instructions at once */
+    lv_strtab_clear(&ctx->strtab);
+    lv_arena_release(&ctx->arena);
 }
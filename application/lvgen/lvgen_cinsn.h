@@ -6,6 +6,7 @@
 
 #include <stdbool.h>
 #include <parser/lib/lv_types.h>
+#include <parser/lib/lv_mem.h>
 
 
 #ifdef __cplusplus
@@ -71,6 +72,8 @@ const char* lv_type_to_name(int type) {
 #endif /* _LV_SOURCE_CODE */
 
 struct module_context;
+struct func_context;
+
 enum var_scope {
     LV_VAR_SCOPE_FUN_LOCAL,
     LV_VAR_SCOPE_FUN_STATIC,
@@ -78,17 +81,24 @@ enum var_scope {
     LV_VAR_SCOPE_MOD_GLOBAL,
 };
 
+/* 
+ * The strings of an instruction live in the arena of its module.
+ * The callee and the arguments are interned in the string table of the
+ * module, so within a module they compare equal by pointer and the callee
+ * works as the opcode. The argument vector is allocated with its exact size.
+ */
 struct func_callinsn {
 #define LV_MAX_ARGS 7
     int   rtype;
     union {
         struct {
-            char* lvalue;
-            char  insn[LV_SYMBOL_LEN];
-            char  args[LV_MAX_ARGS][LV_SYMBOL_LEN];
-            int   args_num;
+            const char*  lvalue;
+            const char*  insn;
+            const char** args;
+            int          args_num;
+            struct func_context* callee; /* The generated function called by insn */
         };
-        char expr[(LV_MAX_ARGS + 1) * LV_SYMBOL_LEN];
+        const char* expr;
     };
 };
 
@@ -116,7 +126,26 @@ struct module_context {
     lv_ll_t  ll_fdecls;
     lv_ll_t  ll_funs;
     lv_ll_t  ll_deps;
+    lv_ll_t  ll_uses;     /* Components expanded inline, they aren't included */
+    lv_hash_t fn_index;   /* Named functions of ll_funs by signature */
     bool     is_view;
+
+    /*
+     * Storage of the functions and instructions of the module, every module
+     * has its own so that modules can be parsed on different threads.
+     */
+    lv_arena_t  arena;
+    lv_strtab_t strtab;
+
+    /* Component scope parsed by lvgen_parse_module() */
+    void*    scope;
+};
+
+/* Functions whose bodies are shared between the modules */
+enum func_kind {
+    LV_FUNC_NORMAL,
+    LV_FUNC_STYLE_INIT,
+    LV_FUNC_GRAD_INIT,
 };
 
 struct func_context {
@@ -133,15 +162,29 @@ struct func_context {
     int             grad_cnt;
     lv_ll_t         ll_insn;
     lv_ll_t         ll_objs;
+    lv_hash_t       obj_index; /* Number of lvalues created per name */
+    int             kind;
 
+    /* The function of the shared module generated instead of this one */
+    struct func_context* alias;
     struct module_context* owner;
 };
 
 struct global_context {
     lv_ll_t ll_funs;
     lv_ll_t ll_modules;
+    lv_hash_t fn_index;   /* Named functions of ll_funs by signature */
+    lv_hash_t mod_index;  /* Modules by name */
+
+    /* Storage of the global functions and their instructions */
+    lv_arena_t  arena;
+    lv_strtab_t strtab;
 
-    struct module_context* module;
+    /*
+     * Style and gradient init functions of all the modules, it isn't in
+     * ll_modules because it has no file.
+     */
+    struct module_context shared;
 };
 
 /* Just only for C++ declare */
@@ -165,21 +208,63 @@ struct func_context* lvgen_new_module_func_named(struct module_context* mod,
     const char* fn_name);
 struct func_context* lvgen_new_global_func(void);
 struct func_context* lvgen_new_global_func_named(const char* fn_name);
+void lvgen_set_func_signature(struct func_context* fn, const char* fmt, ...);
 struct func_callinsn* lvgen_new_callinsn(struct func_context* fn, int retype, const char* insn, ...);
 struct func_callinsn* lvgen_new_exprinsn(struct func_context* fn, const char* insn, ...);
+struct func_callinsn* lvgen_new_funcinsn(struct func_context* fn,
+    struct func_context* callee, ...);
+const char* lvgen_insn_callee(const struct func_callinsn* insn);
 void lvgen_add_func_argument(struct func_context* fn, const char* type, const char* var);
 void lvgen_set_func_rettype(struct func_context* fn, int type);
 lv_obj_t* lvgen_new_lvalue(struct func_context* fn, const char* name,
     struct func_callinsn* insn);
 struct module_depend* lvgen_new_module_depend(struct module_context* mod,
     struct func_context* depfn);
+struct module_depend* lvgen_new_module_use(struct module_context* mod,
+    struct module_context* used);
 bool lvgen_func_initialized(struct func_context* fn);
 
 void lvgen_context_init(void);
 void lvgen_context_destroy(void);
 int lvgen_parse(const char* file, bool is_view);
+
+/*
+ * Parse in parallel: add the modules in file order, parse each of them on
+ * any thread and merge them back in the same order on one thread.
+ * The output is the same as calling lvgen_parse() for each file.
+ * The "globals" component extends the global scope, it has to be
+ * parsed with lvgen_parse() while no other module is being parsed.
+ */
+struct module_context* lvgen_add_module(const char* file, bool is_view);
+int lvgen_parse_module(struct module_context* mod);
+int lvgen_merge_module(struct module_context* mod, int result);
+
+/*
+ * Incremental update: a module that depends on a reset module through
+ * ll_deps or ll_uses must be reset too. Reparse the reset modules in the
+ * order of ll_modules, then generate them again.
+ */
+void lvgen_reset_module(struct module_context* mod);
+int lvgen_reparse_module(struct module_context* mod);
+void lvgen_remove_module(struct module_context* mod);
+
+/*
+ * Generating a module also drops the `lv_obj_set_*` calls of its functions
+ * which are overwritten by a later call of the same setter on the same
+ * object before anything else uses the object.
+ */
+bool lvgen_generate_module(struct module_context* mod);
 bool lvgen_generate(void);
 
+/*
+ * Replace the style and gradient init functions of all the modules with
+ * functions of the shared module named after their bodies, so identical
+ * functions of different views are generated once. The shared module is
+ * built again from scratch, lvgen_generate() does it after the modules.
+ */
+void lvgen_share_funcs(void);
+struct module_context* lvgen_get_shared_module(void);
+
 bool lvgen_cc_find_sym(const char* ns, const char* key,
     const char** pv, const char** pt);
 
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2025 wtcat
+ */
+
+#include "lvgen_db.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "base/hash.h"
+#include "base/platform_file.h"
+#include "thirdparty/tinyxml2/tinyxml2.h"
+
+namespace app {
+namespace xml = tinyxml2;
+
+namespace {
+
+const uint32 kMagic = 0x4244564c; // "LVDB"
+
+} // namespace
+
+struct LvAttributeDb::Header {
+    uint32 magic;
+    uint32 version;
+    uint32 count;
+    uint32 strings_size;
+    int64  source_size;
+    int64  source_mtime;
+    uint32 source_hash;
+    uint32 reserved;
+};
+
+// Offsets into the string table
+struct LvAttributeDb::Entry {
+    uint32 ns;
+    uint32 key;
+    uint32 value;
+    uint32 type;
+};
+
+LvAttributeDb::LvAttributeDb() 
+    : entries_(nullptr), strings_(nullptr), count_(0) {
+}
+
+LvAttributeDb::~LvAttributeDb() {
+}
+
+bool LvAttributeDb::Load(const FilePath& xml, const FilePath& cache) {
+    if (file_util::PathExists(cache)) {
+        int64 mtime;
+        file_.reset(new file_util::MemoryMappedFile);
+        if (file_->Initialize(cache) && file_->length() >= sizeof(Header) &&
+            IsCompiledFrom(xml, (const Header*)file_->data(), &mtime) &&
+            Attach(file_->data(), file_->length())) {
+            if (((const Header*)file_->data())->source_mtime == mtime)
+                return true;
+
+            // The xml was touched but has the same content, record its time
+            // so that the next runs don't read and hash it again
+            image_.assign((const char*)file_->data(), file_->length());
+            ((Header*)&image_[0])->source_mtime = mtime;
+            file_.reset();
+            WriteCache(cache);
+            return Attach((const uint8*)image_.data(), image_.size());
+        }
+        file_.reset();
+    }
+
+    if (!Compile(xml, &image_))
+        return false;
+
+    WriteCache(cache);
+    return Attach((const uint8*)image_.data(), image_.size());
+}
+
+bool LvAttributeDb::Find(const char* ns, const char* key, const char** value,
+    const char** type) const {
+    const Entry* end = entries_ + count_;
+    const Entry* entry = std::lower_bound(entries_, end, 0, 
+        [&](const Entry& e, int) {
+            int diff = strcmp(strings_ + e.ns, ns);
+            return diff < 0 || (diff == 0 && strcmp(strings_ + e.key, key) < 0);
+        });
+
+    if (entry == end || strcmp(strings_ + entry->ns, ns) ||
+        strcmp(strings_ + entry->key, key))
+        return false;
+
+    if (value)
+        *value = strings_ + entry->value;
+    if (type)
+        *type = strings_ + entry->type;
+    return true;
+}
+
+bool LvAttributeDb::Attach(const uint8* data, size_t length) {
+    const Header* header = (const Header*)data;
+
+    if (length < sizeof(Header) || header->magic != kMagic || 
+        header->version != kVersion)
+        return false;
+
+    size_t entries_size = (size_t)header->count * sizeof(Entry);
+    if (header->strings_size == 0 ||
+        length != sizeof(Header) + entries_size + header->strings_size)
+        return false;
+
+    const Entry* entries = (const Entry*)(data + sizeof(Header));
+    const char* strings = (const char*)(data + sizeof(Header) + entries_size);
+    if (strings[header->strings_size - 1] != '\0')
+        return false;
+
+    for (uint32 i = 0; i < header->count; i++) {
+        const Entry& e = entries[i];
+        if (e.ns >= header->strings_size || e.key >= header->strings_size ||
+            e.value >= header->strings_size || e.type >= header->strings_size)
+            return false;
+    }
+
+    entries_ = entries;
+    strings_ = strings;
+    count_ = header->count;
+    return true;
+}
+
+void LvAttributeDb::WriteCache(const FilePath& cache) const {
+    // Replace the cache at once, another lvgen may be mapping it
+    FilePath temp = cache.AddExtension(FILE_PATH_LITERAL("tmp"));
+    if (file_util::WriteFile(temp, image_.data(), (int)image_.size()) != (int)image_.size() ||
+        !file_util::ReplaceFile(temp, cache)) {
+        printf("Failed to write file(%s)\n", cache.AsUTF8Unsafe().c_str());
+        file_util::Delete(temp, false);
+    }
+}
+
+bool LvAttributeDb::IsCompiledFrom(const FilePath& xml, const Header* header,
+    int64* mtime) const {
+    base::PlatformFileInfo info;
+    if (!file_util::GetFileInfo(xml, &info) || info.size != header->source_size)
+        return false;
+
+    *mtime = info.last_modified.ToInternalValue();
+    if (*mtime == header->source_mtime)
+        return true;
+
+    // The file was touched, it may still have the same content
+    std::string content;
+    return file_util::ReadFileToString(xml, &content) &&
+        base::Hash(content) == header->source_hash;
+}
+
+bool LvAttributeDb::Compile(const FilePath& file, std::string* image) const {
+    base::PlatformFileInfo info;
+    std::string content;
+
+    if (!file_util::GetFileInfo(file, &info) || 
+        !file_util::ReadFileToString(file, &content)) {
+        printf("Not found file(%s)\n", file.AsUTF8Unsafe().c_str());
+        return false;
+    }
+
+    xml::XMLDocument doc;
+    if (doc.Parse(content.data(), content.size()) != xml::XML_SUCCESS) {
+        printf("Failed to parse file(%s)\n", file.AsUTF8Unsafe().c_str());
+        return false;
+    }
+
+    std::string strings;
+    std::unordered_map<std::string, uint32> string_offsets;
+    auto intern = [&](const char* str) -> uint32 {
+        if (str == nullptr)
+            str = "";
+        auto iter = string_offsets.find(str);
+        if (iter != string_offsets.end())
+            return iter->second;
+        uint32 offset = (uint32)strings.size();
+        strings.append(str, strlen(str) + 1);
+        string_offsets.insert(std::make_pair(str, offset));
+        return offset;
+    };
+
+    // Types are listed by name under <types>, style properties under <styles>
+    std::vector<Entry> entries;
+    std::unordered_set<std::string> namespaces;
+    auto add_group = [&](xml::XMLElement* group, const char* ns, bool typed) {
+        if (group == nullptr || !namespaces.insert(ns).second)
+            return;
+        for (xml::XMLElement* e = group->FirstChildElement(); e != nullptr;
+            e = e->NextSiblingElement()) {
+            Entry entry;
+            entry.ns = intern(ns);
+            entry.key = intern(e->Attribute("name"));
+            entry.value = intern(e->Attribute("value"));
+            entry.type = intern(typed ? e->Attribute("type") : "?");
+            entries.push_back(entry);
+        }
+    };
+
+    xml::XMLElement* root = doc.RootElement();
+    if (root == nullptr) {
+        printf("Failed to parse file(%s)\n", file.AsUTF8Unsafe().c_str());
+        return false;
+    }
+
+    xml::XMLElement* types = root->FirstChildElement("types");
+    if (types != nullptr) {
+        for (xml::XMLElement* group = types->FirstChildElement(); group != nullptr;
+            group = group->NextSiblingElement())
+            add_group(group, group->Name(), false);
+    }
+    add_group(root->FirstChildElement("styles"), "styles", true);
+
+    // Sort for the binary search, the first one of duplicated keys wins
+    auto less = [&](const Entry& a, const Entry& b) {
+        int diff = strcmp(strings.data() + a.ns, strings.data() + b.ns);
+        return diff < 0 || (diff == 0 && strcmp(strings.data() + a.key, strings.data() + b.key) < 0);
+    };
+    std::stable_sort(entries.begin(), entries.end(), less);
+    entries.erase(std::unique(entries.begin(), entries.end(), 
+        [&](const Entry& a, const Entry& b) {
+            return !less(a, b) && !less(b, a);
+        }), entries.end());
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.count = (uint32)entries.size();
+    header.strings_size = (uint32)strings.size();
+    header.source_size = info.size;
+    header.source_mtime = info.last_modified.ToInternalValue();
+    header.source_hash = base::Hash(content);
+
+    image->clear();
+    image->reserve(sizeof(header) + entries.size() * sizeof(Entry) + strings.size());
+    image->append((const char*)&header, sizeof(header));
+    if (!entries.empty())
+        image->append((const char*)&entries[0], entries.size() * sizeof(Entry));
+    image->append(strings);
+    return true;
+}
+
+} // namespace app
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2025 wtcat
+ */
+
+#ifndef LVGEN_DB_H_
+#define LVGEN_DB_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/memory/scoped_ptr.h"
+
+namespace app {
+
+// The attribute database (lvdb.xml) compiled into a flat image:
+//
+//   Header | Entry[count] sorted by (ns, key) | string table
+//
+// The image is written next to the xml file and mapped by the next runs
+// while the xml file doesn't change, so looking up a symbol never allocates.
+class LvAttributeDb {
+public:
+    enum { kVersion = 1 };
+
+    LvAttributeDb();
+    ~LvAttributeDb();
+
+    // Load |xml| from |cache|, the cache is compiled again if it doesn't
+    // belong to the current |xml|.
+    bool Load(const FilePath& xml, const FilePath& cache);
+
+    // |value| and |type| live as long as the database.
+    bool Find(const char* ns, const char* key, const char** value,
+        const char** type) const;
+
+    size_t size() const { return count_; }
+    bool from_cache() const { return file_.get() != nullptr; }
+
+private:
+    struct Header;
+    struct Entry;
+
+    // Set the image after checking it is complete
+    bool Attach(const uint8* data, size_t length);
+    // |mtime| is set to the modification time of |xml|
+    bool IsCompiledFrom(const FilePath& xml, const Header* header, int64* mtime) const;
+    bool Compile(const FilePath& xml, std::string* image) const;
+    void WriteCache(const FilePath& cache) const;
+
+    // The image is either the mapped cache or compiled in memory
+    scoped_ptr<file_util::MemoryMappedFile> file_;
+    std::string image_;
+
+    const Entry* entries_;
+    const char* strings_;
+    size_t count_;
+
+    DISALLOW_COPY_AND_ASSIGN(LvAttributeDb);
+};
+
+} // namespace app
+
+#endif //LVGEN_DB_H_
@@ -19,7 +19,9 @@ int main(int argc, char* argv[]) {
         CommandLine* cmdline = CommandLine::ForCurrentProcess();
 
         if (cmdline->HasSwitch("help")) {
-            printf("lvgen [--indir=input directory] [--outdir=output directory]\n");
+            printf("lvgen [--indir=input directory] [--outdir=output directory] "
+                "[--jobs=parser threads, 0 for one per processor] "
+                "[--watch]\n");
             return 0;
         }
 
@@ -40,9 +42,16 @@ int main(int argc, char* argv[]) {
             file_util::CreateDirectory(outdir);
 
         app::LvCodeGenerator *lvgen = app::LvCodeGenerator::GetInstance();
+        if (cmdline->HasSwitch("jobs"))
+            lvgen->SetJobs(atoi(cmdline->GetSwitchValueASCII("jobs").c_str()));
+
         if (lvgen->LoadAttributes(FilePath(L"lvdb.xml"))) {
-            if (lvgen->LoadViews(indir))
-                return !lvgen->Generate(outdir);
+            if (lvgen->LoadViews(indir)) {
+                bool okay = lvgen->Generate(outdir);
+                if (okay && cmdline->HasSwitch("watch"))
+                    okay = lvgen->Watch(indir, outdir);
+                return !okay;
+            }
         }
     }
 
@@ -0,0 +1,167 @@
+/**
+ * @file lv_hash.c
+ * Open addressing hash index with linear probing.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_hash.h"
+#include "lv_mem.h"
+#include "lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LV_HASH_MIN_SIZE 16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_hash_entry_t * hash_lookup(const lv_hash_t * table, const char * key, uint32_t hash);
+static bool hash_grow(lv_hash_t * table);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_hash_init(lv_hash_t * table)
+{
+    table->entries = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+uint32_t lv_hash_bytes(uint32_t hash, const void * data, size_t size)
+{
+    const uint8_t * p = data;
+    const uint8_t * end = p + size;
+
+    while(p < end) {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t lv_hash_string(const char * str, size_t * len)
+{
+    size_t n = lv_strlen(str);
+
+    if(len) *len = n;
+    return lv_hash_bytes(LV_HASH_SEED, str, n);
+}
+
+void * lv_hash_find(const lv_hash_t * table, const char * key)
+{
+    if(table->count == 0) return NULL;
+
+    lv_hash_entry_t * entry = hash_lookup(table, key, lv_hash_string(key, NULL));
+    return entry->key ? entry->value : NULL;
+}
+
+lv_hash_entry_t * lv_hash_insert(lv_hash_t * table, const char * key)
+{
+    uint32_t hash = lv_hash_string(key, NULL);
+
+    if(table->count > 0) {
+        lv_hash_entry_t * entry = hash_lookup(table, key, hash);
+        if(entry->key) return entry;
+    }
+
+    /*Keep the load factor below 3/4*/
+    if((table->count + 1) * 4 > table->capacity * 3) {
+        if(!hash_grow(table)) return NULL;
+    }
+
+    lv_hash_entry_t * entry = hash_lookup(table, key, hash);
+    entry->key = key;
+    entry->value = NULL;
+    entry->hash = hash;
+    table->count++;
+    return entry;
+}
+
+bool lv_hash_remove(lv_hash_t * table, const char * key)
+{
+    if(table->count == 0) return false;
+
+    lv_hash_entry_t * entry = hash_lookup(table, key, lv_hash_string(key, NULL));
+    if(entry->key == NULL) return false;
+
+    /*Shift the following entries of the probe sequence back instead of leaving a tombstone*/
+    uint32_t mask = table->capacity - 1;
+    uint32_t i = (uint32_t)(entry - table->entries);
+    uint32_t j = i;
+    while(1) {
+        j = (j + 1) & mask;
+        if(table->entries[j].key == NULL) break;
+
+        uint32_t home = table->entries[j].hash & mask;
+        bool keep = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if(!keep) {
+            table->entries[i] = table->entries[j];
+            i = j;
+        }
+    }
+
+    table->entries[i].key = NULL;
+    table->entries[i].value = NULL;
+    table->count--;
+    return true;
+}
+
+void lv_hash_clear(lv_hash_t * table)
+{
+    lv_free(table->entries);
+    lv_hash_init(table);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Return the entry of the key or the empty entry where it would be inserted*/
+static lv_hash_entry_t * hash_lookup(const lv_hash_t * table, const char * key, uint32_t hash)
+{
+    uint32_t mask = table->capacity - 1;
+    uint32_t i = hash & mask;
+
+    while(table->entries[i].key != NULL) {
+        if(table->entries[i].hash == hash && lv_strcmp(table->entries[i].key, key) == 0) break;
+        i = (i + 1) & mask;
+    }
+    return &table->entries[i];
+}
+
+static bool hash_grow(lv_hash_t * table)
+{
+    uint32_t capacity = table->capacity ? table->capacity * 2 : LV_HASH_MIN_SIZE;
+    lv_hash_entry_t * entries = lv_calloc(capacity, sizeof(lv_hash_entry_t));
+    if(entries == NULL) return false;
+
+    uint32_t mask = capacity - 1;
+    for(uint32_t i = 0; i < table->capacity; i++) {
+        if(table->entries[i].key == NULL) continue;
+        uint32_t j = table->entries[i].hash & mask;
+        while(entries[j].key != NULL) j = (j + 1) & mask;
+        entries[j] = table->entries[i];
+    }
+
+    lv_free(table->entries);
+    table->entries = entries;
+    table->capacity = capacity;
+    return true;
+}
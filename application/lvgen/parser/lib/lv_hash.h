@@ -0,0 +1,117 @@
+/**
+ * @file lv_hash.h
+ * Open addressing hash index from strings to pointers. It is kept next to
+ * a linked list to find its nodes by name without walking the list.
+ */
+
+#ifndef LV_HASH_H
+#define LV_HASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**The hash of no byte, an incremental hash starts from it*/
+#define LV_HASH_SEED 2166136261u
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    const char * key;           /**< Not copied, it has to live as long as the entry*/
+    void * value;
+    uint32_t hash;
+} lv_hash_entry_t;
+
+/**
+ * A zeroed table is a valid empty table, so it can be embedded in structures
+ * which are cleared with `lv_memzero`.
+ */
+typedef struct {
+    lv_hash_entry_t * entries;
+    uint32_t capacity;          /**< 0 or a power of 2*/
+    uint32_t count;
+} lv_hash_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize an empty table, no memory is allocated until the first insertion
+ * @param table     pointer to a table
+ */
+void lv_hash_init(lv_hash_t * table);
+
+/**
+ * Continue a hash (FNV-1a) with more bytes. Hashing the pieces of some data
+ * one after the other gives the hash of the whole data.
+ * @param hash      `LV_HASH_SEED` or the hash of the bytes before
+ * @param data      the bytes
+ * @param size      number of bytes
+ * @return          the hash of the bytes before and these ones
+ */
+uint32_t lv_hash_bytes(uint32_t hash, const void * data, size_t size);
+
+/**
+ * Hash a string (FNV-1a), the same as `lv_hash_bytes` from `LV_HASH_SEED`
+ * @param str       the string
+ * @param len       store the length of the string here if not NULL
+ * @return          the hash of the string
+ */
+uint32_t lv_hash_string(const char * str, size_t * len);
+
+/**
+ * Find the value stored for a key
+ * @param table     pointer to a table
+ * @param key       the key to look for
+ * @return          the value or NULL if the key is not in the table
+ */
+void * lv_hash_find(const lv_hash_t * table, const char * key);
+
+/**
+ * Find the entry of a key or add a new one.
+ * A new entry has a NULL value, its key can be replaced with an equal
+ * string which lives longer.
+ * @param table     pointer to a table
+ * @param key       the key to look for
+ * @return          the entry of the key or NULL if the table couldn't grow
+ */
+lv_hash_entry_t * lv_hash_insert(lv_hash_t * table, const char * key);
+
+/**
+ * Remove a key from the table
+ * @param table     pointer to a table
+ * @param key       the key to remove
+ * @return          true if the key was in the table
+ */
+bool lv_hash_remove(lv_hash_t * table, const char * key);
+
+/**
+ * Remove every entry and free the memory of the table. The table remains valid.
+ * @param table     pointer to a table
+ */
+void lv_hash_clear(lv_hash_t * table);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_HASH_H*/
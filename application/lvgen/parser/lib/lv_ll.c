@@ -32,6 +32,7 @@ enum { ARCH_POINTER_SIZE = sizeof(void*) };
  **********************/
 static void node_set_prev(lv_ll_t * ll_p, lv_ll_node_t * act, lv_ll_node_t * prev);
 static void node_set_next(lv_ll_t * ll_p, lv_ll_node_t * act, lv_ll_node_t * next);
+static lv_ll_node_t * node_alloc(lv_ll_t * ll_p);
 
 /**********************
  *  STATIC VARIABLES
@@ -58,13 +59,20 @@ void lv_ll_init(lv_ll_t * ll_p, uint32_t node_size)
 #endif
 
     ll_p->n_size = node_size;
+    ll_p->arena = NULL;
+}
+
+void lv_ll_init_arena(lv_ll_t * ll_p, uint32_t node_size, struct _lv_arena_t * arena)
+{
+    lv_ll_init(ll_p, node_size);
+    ll_p->arena = arena;
 }
 
 void * lv_ll_ins_head(lv_ll_t * ll_p)
 {
     lv_ll_node_t * n_new;
 
-    n_new = lv_malloc(ll_p->n_size + LL_NODE_META_SIZE);
+    n_new = node_alloc(ll_p);
 
     if(n_new != NULL) {
         node_set_prev(ll_p, n_new, NULL);       /*No prev. before the new head*/
@@ -94,7 +102,7 @@ void * lv_ll_ins_prev(lv_ll_t * ll_p, void * n_act)
         if(n_new == NULL) return NULL;
     }
     else {
-        n_new = lv_malloc(ll_p->n_size + LL_NODE_META_SIZE);
+        n_new = node_alloc(ll_p);
         if(n_new == NULL) return NULL;
 
         lv_ll_node_t * n_prev;
@@ -112,7 +120,7 @@ void * lv_ll_ins_tail(lv_ll_t * ll_p)
 {
     lv_ll_node_t * n_new;
 
-    n_new = lv_malloc(ll_p->n_size + LL_NODE_META_SIZE);
+    n_new = node_alloc(ll_p);
 
     if(n_new != NULL) {
         node_set_next(ll_p, n_new, NULL);       /*No next after the new tail*/
@@ -168,6 +176,13 @@ void lv_ll_clear_custom(lv_ll_t * ll_p, void(*cleanup)(void *))
     void * i;
     void * i_next;
 
+    /*Arena nodes are freed with the arena*/
+    if(ll_p->arena != NULL && cleanup == NULL) {
+        ll_p->head = NULL;
+        ll_p->tail = NULL;
+        return;
+    }
+
     i      = lv_ll_get_head(ll_p);
     i_next = NULL;
 
@@ -343,3 +358,16 @@ static void node_set_next(lv_ll_t * ll_p, lv_ll_node_t * act, lv_ll_node_t * nex
 
     *act_node_p = *next_node_p;
 }
+
+/**
+ * Allocate a node for a linked list
+ * @param ll_p pointer to linked list
+ * @return pointer to the uninitialized node, or NULL on failure
+ */
+static lv_ll_node_t * node_alloc(lv_ll_t * ll_p)
+{
+    if(ll_p->arena != NULL)
+        return lv_arena_alloc(ll_p->arena, ll_p->n_size + LL_NODE_META_SIZE);
+
+    return lv_malloc(ll_p->n_size + LL_NODE_META_SIZE);
+}
@@ -1,6 +1,7 @@
 /**
  * @file lv_ll.h
- * Handle linked lists. The nodes are dynamically allocated by the 'lv_mem' module.
+ * Handle linked lists. The nodes are dynamically allocated by the 'lv_mem' module,
+ * either one by one or from an arena.
  */
 
 #ifndef LV_LL_H
@@ -28,11 +29,14 @@ extern "C" {
 /** Dummy type to make handling easier*/
 typedef uint8_t lv_ll_node_t;
 
+struct _lv_arena_t;
+
 /** Description of a linked list*/
 typedef struct {
     uint32_t n_size;
     lv_ll_node_t * head;
     lv_ll_node_t * tail;
+    struct _lv_arena_t * arena; /**< Nodes are allocated from here if not NULL*/
 } lv_ll_t;
 
 /**********************
@@ -46,6 +50,16 @@ typedef struct {
  */
 void lv_ll_init(lv_ll_t * ll_p, uint32_t node_size);
 
+/**
+ * Initialize a linked list whose nodes are allocated from an arena.
+ * The nodes are never freed one by one, `lv_ll_clear` only empties the list
+ * and the memory is given back when the arena is released.
+ * @param ll_p pointer to lv_ll_t variable
+ * @param node_size the size of 1 node in bytes
+ * @param arena the arena to allocate the nodes from
+ */
+void lv_ll_init_arena(lv_ll_t * ll_p, uint32_t node_size, struct _lv_arena_t * arena);
+
 /**
  * Add a new head to a linked list
  * @param ll_p pointer to linked list
@@ -9,6 +9,10 @@
 #include "lv_string.h"
 #include "lv_mem.h"
 
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
 
 /*********************
  *      DEFINES
@@ -20,13 +24,37 @@
 
 static unsigned int zero_mem;
 
+/*Default size of the arena blocks*/
+#define LV_ARENA_BLOCK_SIZE (64 * 1024)
+
+/*Allocations larger than this get a block of their own*/
+#define LV_ARENA_LARGE(arena) ((arena)->block_size / 4)
+
+#define LV_ARENA_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+/*The counters are shared by the parser threads*/
+#if defined(_MSC_VER)
+    #define LV_MEM_COUNT(cnt) _InterlockedIncrement64((volatile __int64 *)&(cnt))
+    #define LV_MEM_LOAD(cnt) ((uint64_t)_InterlockedOr64((volatile __int64 *)&(cnt), 0))
+#else
+    #define LV_MEM_COUNT(cnt) __atomic_fetch_add(&(cnt), 1, __ATOMIC_RELAXED)
+    #define LV_MEM_LOAD(cnt) __atomic_load_n(&(cnt), __ATOMIC_RELAXED)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
 
+struct _lv_arena_block_t {
+    lv_arena_block_t * next;
+    size_t size;
+    size_t used;
+};
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static lv_arena_block_t * arena_new_block(size_t size);
 
 /**********************
  *  GLOBAL PROTOTYPES
@@ -38,6 +66,7 @@ void lv_free_core(void * p);
 /**********************
  *  STATIC VARIABLES
  **********************/
+static lv_mem_monitor_t mem_monitor;
 
 /**********************
  *      MACROS
@@ -61,6 +90,7 @@ void * lv_malloc(size_t size)
     }
 
     void * alloc = lv_malloc_core(size);
+    LV_MEM_COUNT(mem_monitor.alloc_cnt);
 
     if(alloc == NULL) {
         printf("couldn't allocate memory (%lu bytes)\n", (unsigned long)size);
@@ -80,6 +110,7 @@ void * lv_malloc_zeroed(size_t size)
     }
 
     void * alloc = lv_malloc_core(size);
+    LV_MEM_COUNT(mem_monitor.alloc_cnt);
     if(alloc == NULL) {
         printf("couldn't allocate memory (%lu bytes)", (unsigned long)size);
         return NULL;
@@ -109,6 +140,7 @@ void lv_free(void * data)
     if(data == NULL) return;
 
     lv_free_core(data);
+    LV_MEM_COUNT(mem_monitor.free_cnt);
 }
 
 void * lv_reallocf(void * data_p, size_t new_size)
@@ -132,6 +164,7 @@ void * lv_realloc(void * data_p, size_t new_size)
     if(data_p == &zero_mem) return lv_malloc(new_size);
 
     void * new_p = lv_realloc_core(data_p, new_size);
+    LV_MEM_COUNT(mem_monitor.realloc_cnt);
 
     if(new_p == NULL) {
         printf("couldn't reallocate memory\n");
@@ -141,3 +174,123 @@ void * lv_realloc(void * data_p, size_t new_size)
     LV_TRACE_MEM("reallocated at %p", new_p);
     return new_p;
 }
+
+void lv_mem_monitor(lv_mem_monitor_t * mon_p)
+{
+    mon_p->alloc_cnt = LV_MEM_LOAD(mem_monitor.alloc_cnt);
+    mon_p->realloc_cnt = LV_MEM_LOAD(mem_monitor.realloc_cnt);
+    mon_p->free_cnt = LV_MEM_LOAD(mem_monitor.free_cnt);
+}
+
+void lv_arena_init(lv_arena_t * arena, size_t block_size)
+{
+    arena->blocks = NULL;
+    arena->block_size = block_size ? LV_ARENA_ALIGN(block_size) : LV_ARENA_BLOCK_SIZE;
+    arena->used = 0;
+}
+
+void * lv_arena_alloc(lv_arena_t * arena, size_t size)
+{
+    lv_arena_block_t * block = arena->blocks;
+
+    size = LV_ARENA_ALIGN(size ? size : 1);
+    if(block == NULL || block->size - block->used < size) {
+        if(size > LV_ARENA_LARGE(arena)) {
+            /*Keep using the current block for the small allocations*/
+            lv_arena_block_t * large = arena_new_block(size);
+            if(large == NULL) return NULL;
+            if(block != NULL) {
+                large->next = block->next;
+                block->next = large;
+            }
+            else {
+                arena->blocks = large;
+            }
+            block = large;
+        }
+        else {
+            block = arena_new_block(arena->block_size);
+            if(block == NULL) return NULL;
+            block->next = arena->blocks;
+            arena->blocks = block;
+        }
+    }
+
+    void * p = (uint8_t *)block + LV_ARENA_ALIGN(sizeof(lv_arena_block_t)) + block->used;
+    block->used += size;
+    arena->used += size;
+    return p;
+}
+
+void * lv_arena_zalloc(lv_arena_t * arena, size_t size)
+{
+    void * p = lv_arena_alloc(arena, size);
+    if(p != NULL) lv_memzero(p, size);
+    return p;
+}
+
+char * lv_arena_strdup(lv_arena_t * arena, const char * str)
+{
+    size_t len = lv_strlen(str);
+    char * p = lv_arena_alloc(arena, len + 1);
+    if(p != NULL) lv_memcpy(p, str, len + 1);
+    return p;
+}
+
+void lv_arena_release(lv_arena_t * arena)
+{
+    lv_arena_block_t * block = arena->blocks;
+
+    while(block != NULL) {
+        lv_arena_block_t * next = block->next;
+        lv_free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+    arena->used = 0;
+}
+
+void lv_strtab_init(lv_strtab_t * tab, lv_arena_t * arena)
+{
+    tab->arena = arena;
+    lv_hash_init(&tab->index);
+}
+
+const char * lv_strtab_intern(lv_strtab_t * tab, const char * str)
+{
+    lv_hash_entry_t * entry = lv_hash_insert(&tab->index, str);
+    if(entry == NULL) return NULL;
+    if(entry->value != NULL) return entry->value;
+
+    size_t len = lv_strlen(str);
+    char * copy = lv_arena_alloc(tab->arena, len + 1);
+    if(copy == NULL) {
+        lv_hash_remove(&tab->index, str);
+        return NULL;
+    }
+    lv_memcpy(copy, str, len + 1);
+
+    entry->key = copy;
+    entry->value = copy;
+    return copy;
+}
+
+void lv_strtab_clear(lv_strtab_t * tab)
+{
+    lv_hash_clear(&tab->index);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_arena_block_t * arena_new_block(size_t size)
+{
+    lv_arena_block_t * block = lv_malloc(LV_ARENA_ALIGN(sizeof(lv_arena_block_t)) + size);
+    if(block == NULL) return NULL;
+
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
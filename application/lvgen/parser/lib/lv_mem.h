@@ -14,6 +14,7 @@ extern "C" {
  *      INCLUDES
  *********************/
 #include "lv_string.h"
+#include "lv_hash.h"
 
 /*********************
  *      DEFINES
@@ -23,6 +24,37 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+typedef struct _lv_arena_block_t lv_arena_block_t;
+
+/**
+ * Bump-pointer allocator. Memory is carved from large blocks and is only
+ * given back all at once with `lv_arena_release`.
+ */
+typedef struct _lv_arena_t {
+    lv_arena_block_t * blocks;  /**< Current block first*/
+    size_t block_size;          /**< Size of a regular block*/
+    size_t used;                /**< Bytes handed out since the last release*/
+} lv_arena_t;
+
+/**
+ * Interned string table. Every distinct string is stored once in an arena,
+ * equal strings are returned as the same pointer.
+ */
+typedef struct {
+    lv_arena_t * arena;
+    lv_hash_t index;            /**< Maps a string to its copy in the arena*/
+} lv_strtab_t;
+
+/**
+ * Number of calls to the allocator since the start, arena allocations are
+ * only counted when they need a new block.
+ */
+typedef struct {
+    uint64_t alloc_cnt;         /**< `lv_malloc`, `lv_malloc_zeroed`, `lv_calloc` and `lv_zalloc`*/
+    uint64_t realloc_cnt;
+    uint64_t free_cnt;
+} lv_mem_monitor_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -86,6 +118,12 @@ void * lv_realloc(void * data_p, size_t new_size);
  */
 void * lv_reallocf(void * data_p, size_t new_size);
 
+/**
+ * Read the allocation counters. They are updated by every thread.
+ * @param mon_p     store the counters here
+ */
+void lv_mem_monitor(lv_mem_monitor_t * mon_p);
+
 /**
  * Used internally to execute a plain `malloc` operation
  * @param size      size in bytes to `malloc`
@@ -105,6 +143,65 @@ void lv_free_core(void * p);
  */
 void * lv_realloc_core(void * p, size_t new_size);
 
+/**
+ * Initialize an arena, no memory is allocated until the first allocation
+ * @param arena         pointer to an arena
+ * @param block_size    size of the blocks requested from `lv_malloc`, 0 to use the default
+ */
+void lv_arena_init(lv_arena_t * arena, size_t block_size);
+
+/**
+ * Allocate memory from an arena. The memory is aligned to 8 bytes and can't be freed one by one.
+ * @param arena     pointer to an arena
+ * @param size      requested size in bytes
+ * @return pointer to allocated uninitialized memory, or NULL on failure
+ */
+void * lv_arena_alloc(lv_arena_t * arena, size_t size);
+
+/**
+ * Allocate zeroed memory from an arena
+ * @param arena     pointer to an arena
+ * @param size      requested size in bytes
+ * @return pointer to allocated zeroed memory, or NULL on failure
+ */
+void * lv_arena_zalloc(lv_arena_t * arena, size_t size);
+
+/**
+ * Copy a string into an arena
+ * @param arena     pointer to an arena
+ * @param str       the string to copy
+ * @return pointer to the copy, or NULL on failure
+ */
+char * lv_arena_strdup(lv_arena_t * arena, const char * str);
+
+/**
+ * Free every block of an arena. All memory allocated from the arena becomes invalid,
+ * the arena itself can be used again.
+ * @param arena     pointer to an arena
+ */
+void lv_arena_release(lv_arena_t * arena);
+
+/**
+ * Initialize a string table
+ * @param tab       pointer to a string table
+ * @param arena     the arena that stores the strings
+ */
+void lv_strtab_init(lv_strtab_t * tab, lv_arena_t * arena);
+
+/**
+ * Return the interned copy of a string, adding it to the table if needed
+ * @param tab       pointer to a string table
+ * @param str       the string to look up
+ * @return pointer to the interned string, or NULL on failure
+ */
+const char * lv_strtab_intern(lv_strtab_t * tab, const char * str);
+
+/**
+ * Free the table. The strings live in the arena and are freed with it.
+ * @param tab       pointer to a string table
+ */
+void lv_strtab_clear(lv_strtab_t * tab);
+
 /**********************
  *      MACROS
  **********************/
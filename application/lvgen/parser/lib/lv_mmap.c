@@ -0,0 +1,159 @@
+/**
+ * @file lv_mmap.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+
+#include "lv_mmap.h"
+#include "lv_string.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if defined(_WIN32)
+
+bool lv_mmap_open(lv_mmap_t * map, const char * path)
+{
+    LARGE_INTEGER size;
+
+    lv_memzero(map, sizeof(lv_mmap_t));
+    map->data = "";
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) return false;
+
+    if(!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    /*A mapping of 0 bytes can't be created*/
+    if(size.QuadPart == 0) {
+        CloseHandle(file);
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(mapping == NULL) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(data == NULL) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    map->data = data;
+    map->size = (size_t)size.QuadPart;
+    map->file = file;
+    map->mapping = mapping;
+    return true;
+}
+
+void lv_mmap_close(lv_mmap_t * map)
+{
+    if(map->size > 0) {
+        UnmapViewOfFile(map->data);
+        CloseHandle(map->mapping);
+        CloseHandle(map->file);
+    }
+    lv_memzero(map, sizeof(lv_mmap_t));
+}
+
+#else
+
+bool lv_mmap_open(lv_mmap_t * map, const char * path)
+{
+    struct stat st;
+
+    map->data = "";
+    map->size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+
+    if(fstat(fd, &st) < 0) {
+        close(fd);
+        return false;
+    }
+
+    /*A mapping of 0 bytes can't be created*/
+    if(st.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void * data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /*The mapping keeps the file open*/
+    if(data == MAP_FAILED) return false;
+
+    map->data = data;
+    map->size = (size_t)st.st_size;
+    return true;
+}
+
+void lv_mmap_close(lv_mmap_t * map)
+{
+    if(map->size > 0) munmap((void *)map->data, map->size);
+    map->data = NULL;
+    map->size = 0;
+}
+
+#endif
+
+const char * lv_mmap_find(const char * start, const char * end, const char * str)
+{
+    size_t len = lv_strlen(str);
+    if(len == 0) return start;
+
+    while((size_t)(end - start) >= len) {
+        const char * p = memchr(start, str[0], (size_t)(end - start) - len + 1);
+        if(p == NULL) return NULL;
+        if(lv_memcmp(p, str, len) == 0) return p;
+        start = p + 1;
+    }
+
+    return NULL;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
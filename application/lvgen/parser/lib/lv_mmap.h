@@ -0,0 +1,75 @@
+/**
+ * @file lv_mmap.h
+ * Read-only memory mapping of a whole file.
+ */
+
+#ifndef LV_MMAP_H
+#define LV_MMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * The content of a mapped file. It is not null terminated, always use `size`.
+ */
+typedef struct {
+    const char * data;
+    size_t size;
+#if defined(_WIN32)
+    void * file;                /**< HANDLE of the file*/
+    void * mapping;             /**< HANDLE of the file mapping*/
+#endif
+} lv_mmap_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Map a file into the memory
+ * @param map       store the mapping here
+ * @param path      path of the file
+ * @return          true on success. An empty file is mapped with `size` 0.
+ */
+bool lv_mmap_open(lv_mmap_t * map, const char * path);
+
+/**
+ * Unmap a file. The data of the mapping becomes invalid.
+ * @param map       pointer to a mapping opened with `lv_mmap_open`
+ */
+void lv_mmap_close(lv_mmap_t * map);
+
+/**
+ * Find the first occurrence of a string in a memory range
+ * @param start     start of the range
+ * @param end       end of the range (exclusive)
+ * @param str       the null terminated string to look for
+ * @return          pointer to the first occurrence or NULL if not found
+ */
+const char * lv_mmap_find(const char * start, const char * end, const char * str);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_MMAP_H*/
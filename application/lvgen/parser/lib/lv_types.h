@@ -26,6 +26,15 @@ extern "C"{
 #define LV_LOG_INFO(...)
 #define LV_UNUSED(x) (void)(x)
 
+/*Components are parsed on several threads, so the static buffers must be per thread*/
+#if defined(__cplusplus)
+#define LV_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define LV_THREAD_LOCAL __declspec(thread)
+#else
+#define LV_THREAD_LOCAL _Thread_local
+#endif
+
 
 #define LV_MIN(a, b) ((a) < (b) ? (a) : (b))
 #define LV_MIN3(a, b, c) (LV_MIN(LV_MIN(a,b), c))
@@ -95,6 +95,7 @@ void* lv_xml_default_widget_create(lv_xml_parser_state_t* state, const char** at
 void lv_xml_init(void)
 {
     lv_xml_component_init();
+    lv_xml_style_props_init();
 
     lv_xml_widget_register("lv_obj", lv_xml_obj_create, lv_xml_obj_apply);
     lv_xml_widget_register("lv_label", lv_xml_label_create, lv_xml_label_apply);
@@ -166,7 +167,7 @@ void * lv_xml_create_in_scope(lv_obj_t * parent, lv_xml_component_scope_t * pare
     XML_SetElementHandler(parser, view_start_element_handler, view_end_element_handler);
 
     /* Parse the XML */
-    if(XML_Parse(parser, scope->view_def, (int)lv_strlen(scope->view_def), XML_TRUE) == XML_STATUS_ERROR) {
+    if(XML_Parse(parser, scope->view_def, (int)scope->view_len, XML_TRUE) == XML_STATUS_ERROR) {
         LV_LOG_WARN("XML parsing error: %s on line %lu", XML_ErrorString(XML_GetErrorCode(parser)),
                     XML_GetCurrentLineNumber(parser));
         XML_ParserFree(parser);
@@ -197,7 +198,7 @@ void * lv_xml_create(lv_obj_t * parent, const char * name, const char ** attrs)
 
     lvgen_add_func_argument(fn, "lv_obj_t*", "parent");
     lvgen_add_func_argument(fn, "lv_view__private_t*", LV_VFN_PARAM2);
-    lv_snprintf(fn->signature, sizeof(fn->signature), LV_FN_PREFIX "%s_create", name);
+    lvgen_set_func_signature(fn, LV_FN_PREFIX "%s_create", name);
     fn->rtype = LV_PTYPE(lv_obj_t);
 
     /* Select the widget specific parser type based on the name */
@@ -348,18 +349,19 @@ lv_result_t lv_xml_register_const(lv_xml_component_scope_t * scope, const char *
         return LV_RESULT_INVALID;
     }
 
-    lv_xml_const_t * cnst;
-    LV_LL_READ(&scope->const_ll, cnst) {
-        if(lv_streq(cnst->name, name)) {
-            LV_LOG_INFO("Const %s is already registered. Don't register it again.", name);
-            return LV_RESULT_OK;
-        }
+    lv_hash_entry_t * entry = lv_hash_insert(&scope->const_index, name);
+    if(entry == NULL) return LV_RESULT_INVALID;
+    if(entry->value) {
+        LV_LOG_INFO("Const %s is already registered. Don't register it again.", name);
+        return LV_RESULT_OK;
     }
 
-    cnst = lv_ll_ins_head(&scope->const_ll);
+    lv_xml_const_t * cnst = lv_ll_ins_head(&scope->const_ll);
 
     cnst->name = lv_strdup(name);
     cnst->value = lv_strdup(value);
+    entry->key = cnst->name;
+    entry->value = cnst;
 
     return LV_RESULT_OK;
 }
@@ -370,20 +372,15 @@ const char * lv_xml_get_const(lv_xml_component_scope_t * scope, const char * nam
     if(scope == NULL) scope = lv_xml_component_get_scope("globals");
     if(scope == NULL) return NULL;
 
-    lv_xml_const_t * cnst;
-    if(scope) {
-        LV_LL_READ(&scope->const_ll, cnst) {
-            if(lv_streq(cnst->name, name)) return cnst->value;
-        }
-    }
+    lv_xml_const_t * cnst = lv_hash_find(&scope->const_index, name);
+    if(cnst) return cnst->value;
 
     /*If not found in the component check the global space*/
-    if((scope == NULL || scope->name == NULL) || !lv_streq(scope->name, "globals")) {
+    if(scope->name == NULL || !lv_streq(scope->name, "globals")) {
         scope = lv_xml_component_get_scope("globals");
         if(scope) {
-            LV_LL_READ(&scope->const_ll, cnst) {
-                if(lv_streq(cnst->name, name)) return cnst->value;
-            }
+            cnst = lv_hash_find(&scope->const_index, name);
+            if(cnst) return cnst->value;
         }
     }
 
@@ -65,7 +65,7 @@ int lv_xml_to_size_int(const char * txt)
 
 const char* lv_xml_to_size(const char* txt)
 {
-    static char buf[48];
+    static LV_THREAD_LOCAL char buf[48];
 
     if (lv_streq(txt, "content"))
         return "LV_SIZE_CONTENT";
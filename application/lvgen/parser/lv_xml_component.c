@@ -43,13 +43,21 @@ static void process_const_element(lv_xml_parser_state_t * state, const char ** a
 static void process_font_element(lv_xml_parser_state_t * state, const char * type, const char ** attrs);
 static void process_image_element(lv_xml_parser_state_t * state, const char * type, const char ** attrs);
 static void process_prop_element(lv_xml_parser_state_t * state, const char ** attrs);
-static char * extract_view_content(const char * xml_definition);
+static const char * find_view_content(const char * xml_def, size_t len, size_t * view_len);
+static lv_result_t component_parse_metadata(lv_xml_parser_state_t * state, const char * xml_def, size_t len);
+static lv_result_t component_parse(const char * name, const char * xml_def, size_t len, lv_mmap_t * map,
+                                   lv_xml_component_scope_t * scope);
+static lv_result_t component_register(const char * name, const char * xml_def, size_t len, lv_mmap_t * map);
+static lv_mmap_t * component_map_file(const char * path, char ** name);
+static void component_unmap_file(lv_mmap_t * map);
+static void component_add_globals(void);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 
 static lv_ll_t component_scope_ll;
+static lv_hash_t component_scope_index;
 
 /**********************
  *      MACROS
@@ -97,12 +105,8 @@ void lv_subject_init_string(lv_subject_t* subject, char* buf, char* prev_buf, si
 void lv_xml_component_init(void)
 {
     lv_ll_init(&component_scope_ll, sizeof(lv_xml_component_scope_t));
-
-    lv_xml_component_scope_t * global_scope = lv_ll_ins_head(&component_scope_ll);
-    lv_memzero(global_scope, sizeof(lv_xml_component_scope_t));
-    lv_xml_component_scope_init(global_scope);
-    global_scope->name = lv_strdup("globals");
-
+    lv_hash_init(&component_scope_index);
+    component_add_globals();
 }
 
 void lv_xml_component_scope_init(lv_xml_component_scope_t * scope)
@@ -115,6 +119,71 @@ void lv_xml_component_scope_init(lv_xml_component_scope_t * scope)
     lv_ll_init(&scope->event_ll, sizeof(lv_xml_event_cb_t));
     lv_ll_init(&scope->image_ll, sizeof(lv_xml_image_t));
     lv_ll_init(&scope->font_ll, sizeof(lv_xml_font_t));
+    lv_hash_init(&scope->style_index);
+    lv_hash_init(&scope->const_index);
+}
+
+void lv_xml_component_scope_deinit(lv_xml_component_scope_t * scope)
+{
+    lv_free((char *)scope->name);
+    if(scope->view_map) component_unmap_file(scope->view_map);
+    else lv_free((char *)scope->view_def);
+    lv_free((char *)scope->extends);
+
+    lv_xml_const_t * cnst;
+    LV_LL_READ(&scope->const_ll, cnst) {
+        lv_free((char *)cnst->name);
+        lv_free((char *)cnst->value);
+    }
+    lv_ll_clear(&scope->const_ll);
+    lv_hash_clear(&scope->const_index);
+
+    lv_xml_param_t * param;
+    LV_LL_READ(&scope->param_ll, param) {
+        lv_free((char *)param->name);
+        lv_free((char *)param->def);
+        lv_free((char *)param->type);
+    }
+    lv_ll_clear(&scope->param_ll);
+
+    lv_xml_font_t * font;
+    LV_LL_READ(&scope->font_ll, font) {
+        lv_free((char *)font->name);
+    }
+    lv_ll_clear(&scope->font_ll);
+
+    lv_xml_image_t * image;
+    LV_LL_READ(&scope->image_ll, image) {
+        lv_free((char *)image->name);
+        lv_free((char *)image->src);
+    }
+    lv_ll_clear(&scope->image_ll);
+
+    lv_xml_style_t * style;
+    LV_LL_READ(&scope->style_ll, style) {
+        lv_free((char *)style->name);
+        lv_free((char *)style->long_name);
+        //lv_style_reset(&style->style);
+    }
+    lv_ll_clear(&scope->style_ll);
+    lv_hash_clear(&scope->style_index);
+
+    lv_xml_grad_t * grad;
+    LV_LL_READ(&scope->gradient_ll, grad) {
+        lv_free((char *)grad->name);
+    }
+    lv_ll_clear(&scope->gradient_ll);
+
+    lv_xml_subject_t * subject;
+    LV_LL_READ(&scope->subjects_ll, subject) {
+        lv_free((char *)subject->name);
+        if(subject->subject->type == LV_SUBJECT_TYPE_STRING) {
+            lv_free((char *)subject->subject->prev_value.pointer);
+            lv_free((char *)subject->subject->value.pointer);
+        }
+        lv_free(subject->subject);
+    }
+    lv_ll_clear(&scope->subjects_ll);
 }
 
 
@@ -122,6 +191,10 @@ lv_obj_t * lv_xml_component_process(lv_xml_parser_state_t * state, const char *
 {
     lv_xml_component_scope_t * scope = lv_xml_component_get_scope(name);
     if(scope == NULL) return NULL;
+    /*The component is expanded into the active function, so its module has to be generated again if the component changes*/
+    struct func_context * fn = lv_xml_state_get_active_fn(state);
+    if(fn && fn->owner) lvgen_new_module_use(fn->owner, lvgen_get_module_by_name(name));
+
     lv_obj_t * item = lv_xml_create_in_scope(state->parent, &state->scope, scope, attrs);
     if(item == NULL) {
         LV_LOG_WARN("Couldn't create component '%s'", name);
@@ -151,123 +224,65 @@ lv_obj_t * lv_xml_component_process(lv_xml_parser_state_t * state, const char *
 
 lv_xml_component_scope_t * lv_xml_component_get_scope(const char * component_name)
 {
-    lv_xml_component_scope_t * scope;
-    LV_LL_READ(&component_scope_ll, scope) {
-        if(lv_streq(scope->name, component_name)) return scope;
-    }
-
-    return NULL;
+    return lv_hash_find(&component_scope_index, component_name);
 }
 
 lv_result_t lv_xml_component_register_from_data(const char * name, const char * xml_def)
 {
-    bool globals = false;
-    if(lv_streq(name, "globals")) globals = true;
+    return component_register(name, xml_def, lv_strlen(xml_def), NULL);
+}
 
-    /* Create a temporary parser state to extract styles/params/consts */
-    lv_xml_parser_state_t state;
-    if(globals) {
-        lv_xml_component_scope_t * global_scope = lv_xml_component_get_scope("globals");
-        state.scope = *global_scope;
-    }
-    else {
-        lv_xml_parser_state_init(&state);
-        state.scope.name = name;
-    }
+lv_result_t lv_xml_component_register_from_file(const char * path)
+{
+    char * name;
+    lv_mmap_t * map = component_map_file(path, &name);
+    if(map == NULL) return LV_RESULT_INVALID;
 
-    /* Parse the XML to extract metadata */
-    XML_Memory_Handling_Suite mem_handlers;
-    mem_handlers.malloc_fcn = lv_malloc;
-    mem_handlers.realloc_fcn = lv_realloc;
-    mem_handlers.free_fcn = lv_free;
-    XML_Parser parser = XML_ParserCreate_MM(NULL, &mem_handlers, NULL);
-    XML_SetUserData(parser, &state);
-    XML_SetElementHandler(parser, start_metadata_handler, end_metadata_handler);
+    /* Register the component, its scope keeps the mapping for the view */
+    lv_result_t res = component_register(name, map->data, map->size, map);
 
-    if(XML_Parse(parser, xml_def, (int)lv_strlen(xml_def), XML_TRUE) == XML_STATUS_ERROR) {
-        LV_LOG_ERROR("XML parsing error: %s on line %lu",
-                     XML_ErrorString(XML_GetErrorCode(parser)),
-                     (unsigned long)XML_GetCurrentLineNumber(parser));
-        XML_ParserFree(parser);
-        lv_free((char *)state.scope.extends);
-        return LV_RESULT_INVALID;
-    }
+    /* Housekeeping */
+    if(res != LV_RESULT_OK || lv_streq(name, "globals")) component_unmap_file(map);
+    lv_free(name);
 
-    XML_ParserFree(parser);
+    return res;
+}
 
+lv_result_t lv_xml_component_parse_file(const char * path, lv_xml_component_scope_t * scope)
+{
+    char * name;
+    lv_mmap_t * map = component_map_file(path, &name);
+    if(map == NULL) return LV_RESULT_INVALID;
 
-    /* Copy extracted metadata to component processor */
-    if(globals) {
-        lv_xml_component_scope_t * global_scope = lv_xml_component_get_scope("globals");
-        lv_memcpy(global_scope, &state.scope, sizeof(lv_xml_component_scope_t));
+    lv_result_t res = LV_RESULT_INVALID;
+    if(lv_streq(name, "globals")) {
+        LV_LOG_WARN("The global scope can't be parsed separately (%s)", path);
     }
     else {
-        lv_xml_component_scope_t * scope = lv_ll_ins_head(&component_scope_ll);
-        lv_memzero(scope, sizeof(lv_xml_component_scope_t));
-        lv_memcpy(scope, &state.scope, sizeof(lv_xml_component_scope_t));
-
-        /* Extract view content directly instead of using XML parser */
-        scope->view_def = extract_view_content(xml_def);
-        scope->name = lv_strdup(name);
-        if(!scope->view_def) {
-            LV_LOG_WARN("Failed to extract view content");
-            /* Clean up and return error */
-            lv_free(scope);
-            return LV_RESULT_INVALID;
-        }
+        res = component_parse(name, map->data, map->size, map, scope);
     }
 
-    return LV_RESULT_OK;
-}
+    if(res != LV_RESULT_OK) component_unmap_file(map);
+    lv_free(name);
 
+    return res;
+}
 
-lv_result_t lv_xml_component_register_from_file(const char * path)
+lv_result_t lv_xml_component_register_scope(const lv_xml_component_scope_t * parsed)
 {
-    FILE* fp = fopen(path, "rb");
-    if(fp == NULL) {
-        LV_LOG_WARN("Couldn't open %s", path);
-        return LV_RESULT_INVALID;
-    }
-
-    /* Determine file size */
-    uint32_t file_size;
-    fseek(fp, 0, SEEK_END);
-    file_size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
+    lv_xml_component_scope_t * scope = lv_ll_ins_head(&component_scope_ll);
+    if(scope == NULL) return LV_RESULT_INVALID;
 
-    /* Create the buffer */
-    char * xml_buf = lv_malloc(file_size + 1);
-    if(xml_buf == NULL) {
-        LV_LOG_WARN("Memory allocation failed for file %s (%d bytes)", path, file_size + 1);
-        fclose(fp);
-        return LV_RESULT_INVALID;
-    }
+    lv_memcpy(scope, parsed, sizeof(lv_xml_component_scope_t));
 
-    /* Read the file content  */
-    if (fread(xml_buf, 1, file_size, fp) != file_size) {
-        LV_LOG_WARN("Couldn't read %s fully", path);
-        lv_free(xml_buf);
-        fclose(fp);
-        return LV_RESULT_INVALID;
+    /*The latest scope hides the earlier ones with the same name*/
+    lv_hash_entry_t * entry = lv_hash_insert(&component_scope_index, scope->name);
+    if(entry) {
+        entry->key = scope->name;
+        entry->value = scope;
     }
 
-    /* Null-terminate the buffer */
-    xml_buf[file_size] = '\0';
-
-    /* Remove extension name and just only use base name */
-    char* filename = lv_strdup(lv_basename(path));
-    size_t namelen = lv_strlen(filename);
-    filename[namelen - 4] = '\0';
-
-    /* Register the component */
-    lv_result_t res = lv_xml_component_register_from_data(filename, xml_buf);
-
-    /* Housekeeping */
-    lv_free(filename);
-    lv_free(xml_buf);
-    fclose(fp);
-
-    return res;
+    return LV_RESULT_OK;
 }
 
 lv_result_t lv_xml_component_unregister(const char * name)
@@ -276,75 +291,44 @@ lv_result_t lv_xml_component_unregister(const char * name)
     if(scope == NULL) return LV_RESULT_INVALID;
 
     lv_ll_remove(&component_scope_ll, scope);
-
-    lv_free((char *)scope->name);
-    lv_free((char *)scope->view_def);
-    lv_free((char *)scope->extends);
-
-    lv_xml_const_t * cnst;
-    LV_LL_READ(&scope->const_ll, cnst) {
-        lv_free((char *)cnst->name);
-        lv_free((char *)cnst->value);
-    }
-    lv_ll_clear(&scope->const_ll);
-
-    lv_xml_param_t * param;
-    LV_LL_READ(&scope->param_ll, param) {
-        lv_free((char *)param->name);
-        lv_free((char *)param->def);
-        lv_free((char *)param->type);
-    }
-    lv_ll_clear(&scope->param_ll);
-
-
-    lv_xml_font_t * font;
-    LV_LL_READ(&scope->font_ll, font) {
-        lv_free((char *)font->name);
-    }
-    lv_ll_clear(&scope->font_ll);
-
-    lv_xml_image_t * image;
-    LV_LL_READ(&scope->image_ll, image) {
-        lv_free((char *)image->name);
-        lv_free((char *)image->src);
-    }
-    lv_ll_clear(&scope->image_ll);
-
-    lv_xml_style_t * style;
-    LV_LL_READ(&scope->style_ll, style) {
-        lv_free((char *)style->name);
-        lv_free((char *)style->long_name);
-        //lv_style_reset(&style->style);
-    }
-    lv_ll_clear(&scope->style_ll);
-
-
-    lv_xml_grad_t * grad;
-    LV_LL_READ(&scope->gradient_ll, grad) {
-        lv_free((char *)grad->name);
-    }
-    lv_ll_clear(&scope->gradient_ll);
-
-    lv_xml_subject_t * subject;
-    LV_LL_READ(&scope->subjects_ll, subject) {
-        lv_free((char *)subject->name);
-        if(subject->subject->type == LV_SUBJECT_TYPE_STRING) {
-            lv_free((char *)subject->subject->prev_value.pointer);
-            lv_free((char *)subject->subject->value.pointer);
+    lv_hash_remove(&component_scope_index, scope->name);
+
+    /*Make a scope with the same name which was hidden by this one visible again*/
+    lv_xml_component_scope_t * other;
+    LV_LL_READ(&component_scope_ll, other) {
+        if(lv_streq(other->name, scope->name)) {
+            lv_hash_entry_t * entry = lv_hash_insert(&component_scope_index, other->name);
+            if(entry) entry->value = other;
+            break;
         }
-        lv_free(subject->subject);
     }
-    lv_ll_clear(&scope->subjects_ll);
 
+    lv_xml_component_scope_deinit(scope);
     lv_free(scope);
 
     return LV_RESULT_OK;
 }
 
+void lv_xml_component_reset_globals(void)
+{
+    lv_xml_component_unregister("globals");
+    component_add_globals();
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+static void component_add_globals(void)
+{
+    lv_xml_component_scope_t * global_scope = lv_ll_ins_head(&component_scope_ll);
+    lv_memzero(global_scope, sizeof(lv_xml_component_scope_t));
+    lv_xml_component_scope_init(global_scope);
+    global_scope->name = lv_strdup("globals");
+    lv_hash_entry_t * entry = lv_hash_insert(&component_scope_index, global_scope->name);
+    if(entry) entry->value = global_scope;
+}
+
 static void process_const_element(lv_xml_parser_state_t * state, const char ** attrs)
 {
     const char * name = lv_xml_get_value_of(attrs, "name");
@@ -515,10 +499,11 @@ static void process_grad_element(lv_xml_parser_state_t * state, const char * tag
     dsc->extend = LV_GRAD_EXTEND_PAD;
 
     struct func_context* fn = lvgen_new_module_func(lvgen_get_module());
-    lv_snprintf(fn->signature, sizeof(fn->signature), LV_FN_PREFIX "%s_%s_grad_init", 
+    lvgen_set_func_signature(fn, LV_FN_PREFIX "%s_%s_grad_init",
         state->scope.name, grad->name);
     lvgen_add_func_argument(fn, "lv_grad_dsc_t*", "dsc");
     lvgen_new_exprinsn(fn, "dsc->extend = LV_GRAD_EXTEND_PAD;");
+    fn->kind = LV_FUNC_GRAD_INIT;
     grad->link_fn = fn;
 
     if(lv_streq(tag_name, "linear")) {
@@ -778,36 +763,150 @@ static void end_metadata_handler(void * user_data, const char * name)
     lv_xml_parser_end_section(state, name);
 }
 
-static char * extract_view_content(const char * xml_definition)
+/*Parse the metadata of a component into `state->scope`*/
+static lv_result_t component_parse_metadata(lv_xml_parser_state_t * state, const char * xml_def, size_t len)
 {
-    if(!xml_definition) return NULL;
+    XML_Memory_Handling_Suite mem_handlers;
+    mem_handlers.malloc_fcn = lv_malloc;
+    mem_handlers.realloc_fcn = lv_realloc;
+    mem_handlers.free_fcn = lv_free;
+    XML_Parser parser = XML_ParserCreate_MM(NULL, &mem_handlers, NULL);
+    XML_SetUserData(parser, state);
+    XML_SetElementHandler(parser, start_metadata_handler, end_metadata_handler);
+
+    if(XML_Parse(parser, xml_def, (int)len, XML_TRUE) == XML_STATUS_ERROR) {
+        LV_LOG_ERROR("XML parsing error: %s on line %lu",
+                     XML_ErrorString(XML_GetErrorCode(parser)),
+                     (unsigned long)XML_GetCurrentLineNumber(parser));
+        XML_ParserFree(parser);
+        return LV_RESULT_INVALID;
+    }
+
+    XML_ParserFree(parser);
+    return LV_RESULT_OK;
+}
+
+/*Parse a component other than "globals" into `scope` without registering it*/
+/*Parse a component into `scope`. The view is kept in `map` if it's not NULL, or copied otherwise*/
+static lv_result_t component_parse(const char * name, const char * xml_def, size_t len, lv_mmap_t * map,
+                                   lv_xml_component_scope_t * scope)
+{
+    /* Create a temporary parser state to extract styles/params/consts */
+    lv_xml_parser_state_t state;
+    lv_xml_parser_state_init(&state);
+    state.scope.name = name;
+
+    if(component_parse_metadata(&state, xml_def, len) != LV_RESULT_OK) {
+        lv_free((char *)state.scope.extends);
+        lv_hash_clear(&state.scope.style_index);
+        lv_hash_clear(&state.scope.const_index);
+        return LV_RESULT_INVALID;
+    }
+
+    /* Extract view content directly instead of using XML parser */
+    size_t view_len;
+    const char * view = find_view_content(xml_def, len, &view_len);
+    char * view_copy = NULL;
+    if(view && map == NULL) {
+        view_copy = lv_malloc(view_len + 1);
+        if(view_copy) {
+            lv_memcpy(view_copy, view, view_len);
+            view_copy[view_len] = '\0';
+        }
+        view = view_copy;
+    }
+    if(!view) {
+        LV_LOG_WARN("Failed to extract view content");
+        lv_free((char *)state.scope.extends);
+        lv_hash_clear(&state.scope.style_index);
+        lv_hash_clear(&state.scope.const_index);
+        return LV_RESULT_INVALID;
+    }
+
+    state.scope.view_def = view;
+    state.scope.view_len = view_len;
+    state.scope.view_map = map;
+    state.scope.name = lv_strdup(name);
+    lv_memcpy(scope, &state.scope, sizeof(lv_xml_component_scope_t));
+    return LV_RESULT_OK;
+}
+
+static lv_result_t component_register(const char * name, const char * xml_def, size_t len, lv_mmap_t * map)
+{
+    if(!lv_streq(name, "globals")) {
+        lv_xml_component_scope_t scope;
+        lv_result_t res = component_parse(name, xml_def, len, map, &scope);
+        if(res != LV_RESULT_OK) return res;
+
+        return lv_xml_component_register_scope(&scope);
+    }
+
+    /* Extend the global scope */
+    lv_xml_parser_state_t state;
+    lv_xml_component_scope_t * global_scope = lv_xml_component_get_scope("globals");
+    lv_xml_parser_state_init(&state);
+    state.scope = *global_scope;
+
+    lv_result_t res = component_parse_metadata(&state, xml_def, len);
+
+    /*Copy back even on error as the indexes might have been reallocated while parsing*/
+    lv_memcpy(global_scope, &state.scope, sizeof(lv_xml_component_scope_t));
+    return res;
+}
+
+/*Map an XML file and get the component name from its file name*/
+static lv_mmap_t * component_map_file(const char * path, char ** name)
+{
+    lv_mmap_t * map = lv_malloc(sizeof(lv_mmap_t));
+    if(map == NULL) {
+        LV_LOG_WARN("Memory allocation failed for file %s", path);
+        return NULL;
+    }
+
+    if(!lv_mmap_open(map, path)) {
+        LV_LOG_WARN("Couldn't open %s", path);
+        lv_free(map);
+        return NULL;
+    }
+
+    /* Remove extension name and just only use base name */
+    char* filename = lv_strdup(lv_basename(path));
+    size_t namelen = lv_strlen(filename);
+    filename[namelen - 4] = '\0';
+
+    *name = filename;
+    return map;
+}
+
+static void component_unmap_file(lv_mmap_t * map)
+{
+    lv_mmap_close(map);
+    lv_free(map);
+}
+
+/*Find the `<view>` element in the definition without copying it*/
+static const char * find_view_content(const char * xml_def, size_t len, size_t * view_len)
+{
+    const char * xml_end = xml_def + len;
 
     /* Find start of view tag */
-    const char * start = strstr(xml_definition, "<view");
+    const char * start = lv_mmap_find(xml_def, xml_end, "<view");
     if(!start) return NULL;
 
     /* Find end of view tag */
-    const char * end = strstr(xml_definition, "</view>");
+    const char * end = lv_mmap_find(start, xml_end, "</view>");
     if(end) {
         end += 7; /* Include "</view>" in result */
     }
     else {
         /*If there is no "</view> maybe it's like <view ... />"*/
-        end = strstr(start, "/>");
+        end = lv_mmap_find(start, xml_end, "/>");
         if(!end) return NULL;
         end += 2; /* Include "/>" in result */
     }
 
-    /* Calculate and allocate length */
-    size_t len = end - start;
-    char * view_content = lv_malloc(len + 1);
-    if(!view_content) return NULL;
-
-    /* Copy content and null terminate */
-    lv_memcpy(view_content, start, len);
-    view_content[len] = '\0';
-
-    return view_content;
+    *view_len = (size_t)(end - start);
+    return start;
 }
 
 #endif /* LV_USE_XML */
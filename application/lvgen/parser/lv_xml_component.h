@@ -54,6 +54,23 @@ lv_result_t lv_xml_component_register_from_data(const char * name, const char *
  */
 lv_result_t lv_xml_component_register_from_file(const char * path);
 
+/**
+ * Parse the styles, constants, another data of a component without registering it.
+ * It only reads the global scope, so different components can be parsed in parallel
+ * as long as the global scope is not being registered at the same time.
+ * @param path      path to an XML file, its name can't be "globals"
+ * @param scope     store the parsed data here
+ * @return          LV_RES_OK: parsed successfully, LV_RES_INVALID: otherwise
+ */
+lv_result_t lv_xml_component_parse_file(const char * path, lv_xml_component_scope_t * scope);
+
+/**
+ * Register a component parsed by `lv_xml_component_parse_file`
+ * @param parsed    the parsed data, it's moved to the registered component
+ * @return          LV_RES_OK: registered successfully, LV_RES_INVALID: otherwise
+ */
+lv_result_t lv_xml_component_register_scope(const lv_xml_component_scope_t * parsed);
+
 /**
  * Get the scope of a component which was registered by
  * `lv_xml_component_register_from_data` or `lv_xml_component_register_from_file`
@@ -69,6 +86,11 @@ lv_xml_component_scope_t * lv_xml_component_get_scope(const char * component_nam
  */
 lv_result_t lv_xml_component_unregister(const char * name);
 
+/**
+ * Drop everything registered in the global scope and start again with an empty one.
+ */
+void lv_xml_component_reset_globals(void);
+
 /**********************
  *      MACROS
  **********************/
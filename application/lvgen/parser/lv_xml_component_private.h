@@ -19,6 +19,8 @@ extern "C" {
 #include "parser/lib/lv_types.h"
 #include "parser/lib/lv_types.h"
 #include "parser/lib/lv_ll.h"
+#include "parser/lib/lv_hash.h"
+#include "parser/lib/lv_mmap.h"
 #include "lv_xml_utils.h"
 
 /**********************
@@ -37,7 +39,11 @@ typedef struct _lv_xml_component_scope_t {
     lv_ll_t font_ll;
     lv_ll_t image_ll;
     lv_ll_t event_ll;
-    const char * view_def;
+    lv_hash_t style_index;                          /*Styles of style_ll by name*/
+    lv_hash_t const_index;                          /*Constants of const_ll by name*/
+    const char * view_def;                          /*Not null terminated, use view_len*/
+    size_t view_len;
+    lv_mmap_t * view_map;                           /*The mapped file view_def points into, NULL if view_def is allocated*/
     const char * extends;
     uint32_t is_widget : 1;                         /*1: not component but widget registered as a component for preview*/
     struct _lv_xml_component_scope_t * next;
@@ -81,6 +87,12 @@ void lv_xml_component_init(void);
  */
 void lv_xml_component_scope_init(lv_xml_component_scope_t * scope);
 
+/**
+ * Free everything a component context owns, but not the context itself
+ * @param scope     pointer to a component context
+ */
+void lv_xml_component_scope_deinit(lv_xml_component_scope_t * scope);
+
 /**********************
  *      MACROS
  **********************/
@@ -27,6 +27,137 @@
     #define strtok_r strtok_s  // Use strtok_s as an equivalent to strtok_r in Visual Studio
 #endif
 
+/*The supported style properties and the type of their values*/
+#define STYLE_PROPS(X) \
+    X(width, SIZE)                   \
+    X(min_width, SIZE)               \
+    X(max_width, SIZE)               \
+    X(height, SIZE)                  \
+    X(min_height, SIZE)              \
+    X(max_height, SIZE)              \
+    X(length, SIZE)                  \
+    X(radius, SIZE)                  \
+                                     \
+    X(pad_left, INT)                 \
+    X(pad_right, INT)                \
+    X(pad_top, INT)                  \
+    X(pad_bottom, INT)               \
+    X(pad_hor, INT)                  \
+    X(pad_ver, INT)                  \
+    X(pad_all, INT)                  \
+    X(pad_row, INT)                  \
+    X(pad_column, INT)               \
+    X(pad_gap, INT)                  \
+    X(pad_radial, INT)               \
+                                     \
+    X(margin_left, INT)              \
+    X(margin_right, INT)             \
+    X(margin_top, INT)               \
+    X(margin_bottom, INT)            \
+    X(margin_hor, INT)               \
+    X(margin_ver, INT)               \
+    X(margin_all, INT)               \
+                                     \
+    X(base_dir, BASE_DIR)            \
+    X(clip_corner, BOOL)             \
+                                     \
+    X(bg_opa, OPA)                   \
+    X(bg_color, COLOR)               \
+    X(bg_grad_dir, GRAD_DIR)         \
+    X(bg_grad_color, COLOR)          \
+    X(bg_main_stop, INT)             \
+    X(bg_grad_stop, INT)             \
+    X(bg_grad, GRAD)                 \
+                                     \
+    X(bg_image_src, IMAGE)           \
+    X(bg_image_tiled, BOOL)          \
+    X(bg_image_recolor, COLOR)       \
+    X(bg_image_recolor_opa, OPA)     \
+                                     \
+    X(border_color, COLOR)           \
+    X(border_width, INT)             \
+    X(border_opa, OPA)               \
+    X(border_side, BORDER_SIDE)      \
+    X(border_post, BOOL)             \
+                                     \
+    X(outline_color, COLOR)          \
+    X(outline_width, INT)            \
+    X(outline_opa, OPA)              \
+    X(outline_pad, INT)              \
+                                     \
+    X(shadow_width, INT)             \
+    X(shadow_color, COLOR)           \
+    X(shadow_offset_x, INT)          \
+    X(shadow_offset_y, INT)          \
+    X(shadow_spread, INT)            \
+    X(shadow_opa, OPA)               \
+                                     \
+    X(text_color, COLOR)             \
+    X(text_font, FONT)               \
+    X(text_opa, OPA)                 \
+    X(text_align, TEXT_ALIGN)        \
+    X(text_letter_space, INT)        \
+    X(text_line_space, INT)          \
+    X(text_decor, TEXT_DECOR)        \
+                                     \
+    X(image_opa, OPA)                \
+    X(image_recolor, COLOR)          \
+    X(image_recolor_opa, OPA)        \
+                                     \
+    X(line_color, COLOR)             \
+    X(line_opa, OPA)                 \
+    X(line_width, INT)               \
+    X(line_dash_width, INT)          \
+    X(line_dash_gap, INT)            \
+    X(line_rounded, BOOL)            \
+                                     \
+    X(arc_color, COLOR)              \
+    X(arc_opa, OPA)                  \
+    X(arc_width, INT)                \
+    X(arc_rounded, BOOL)             \
+    X(arc_image_src, IMAGE)          \
+                                     \
+    X(opa, OPA)                      \
+    X(opa_layered, OPA)              \
+    X(color_filter_opa, OPA)         \
+    X(anim_duration, INT)            \
+    X(blend_mode, BLEND_MODE)        \
+    X(transform_width, INT)          \
+    X(transform_height, INT)         \
+    X(translate_x, INT)              \
+    X(translate_y, INT)              \
+    X(translate_radial, INT)         \
+    X(transform_scale_x, INT)        \
+    X(transform_scale_y, INT)        \
+    X(transform_rotation, INT)       \
+    X(transform_pivot_x, INT)        \
+    X(transform_pivot_y, INT)        \
+    X(transform_skew_x, INT)         \
+    X(bitmap_mask_src, IMAGE)        \
+    X(rotary_sensitivity, INT)       \
+    X(recolor, COLOR)                \
+    X(recolor_opa, OPA)              \
+                                     \
+    X(layout, LAYOUT)                \
+                                     \
+    X(flex_flow, FLEX_FLOW)          \
+    X(flex_grow, INT)                \
+    X(flex_main_place, FLEX_ALIGN)   \
+    X(flex_cross_place, FLEX_ALIGN)  \
+    X(flex_track_place, FLEX_ALIGN)  \
+                                     \
+    X(grid_column_align, GRID_ALIGN) \
+    X(grid_row_align, GRID_ALIGN)    \
+    X(grid_cell_column_pos, INT)     \
+    X(grid_cell_column_span, INT)    \
+    X(grid_cell_x_align, GRID_ALIGN) \
+    X(grid_cell_row_pos, INT)        \
+    X(grid_cell_row_span, INT)       \
+    X(grid_cell_y_align, GRID_ALIGN)
+
+#define STYLE_PROP_DSC(prop, type) \
+    { #prop, "lv_style_set_" #prop, "lv_obj_set_style_" #prop, LV_XML_STYLE_VALUE_##type },
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -39,23 +170,85 @@ static lv_style_prop_t style_prop_text_to_enum(const char * txt);
 /**********************
  *  STATIC VARIABLES
  **********************/
+static const lv_xml_style_prop_dsc_t style_props[] = {
+    STYLE_PROPS(STYLE_PROP_DSC)
+};
+
+/*Maps the property names to `style_props`*/
+static lv_hash_t style_prop_index;
 
 /**********************
  *      MACROS
  **********************/
 
-/*Expands to e.g.
-  if(lv_streq(name, "height")) lv_style_set_height(style, lv_xml_to_size(value));
- */
-//#define SET_STYLE_IF(prop, value) if(lv_streq(name, #prop)) lv_style_set_##prop(style, value)
-
-#define SET_STYLE_IF(prop, value) \
-    if(lv_streq(name, #prop)) lvgen_new_callinsn(fn, LV_TYPE(void), "lv_style_set_" #prop, "style", value, NULL)
-
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
 
+void lv_xml_style_props_init(void)
+{
+    if(style_prop_index.count > 0) return;
+
+    for(size_t i = 0; i < sizeof(style_props) / sizeof(style_props[0]); i++) {
+        lv_hash_entry_t * entry = lv_hash_insert(&style_prop_index, style_props[i].name);
+        if(entry == NULL) {
+            LV_LOG_ERROR("Couldn't build the style property table");
+            return;
+        }
+        entry->value = (void *)&style_props[i];
+    }
+}
+
+const lv_xml_style_prop_dsc_t * lv_xml_style_prop_find(const char * name)
+{
+    return lv_hash_find(&style_prop_index, name);
+}
+
+const char * lv_xml_style_prop_value(const lv_xml_style_prop_dsc_t * dsc, lv_xml_component_scope_t * scope,
+                                     const char * value, void * fn)
+{
+    switch(dsc->value_type) {
+        case LV_XML_STYLE_VALUE_SIZE:
+            return lv_xml_to_size(value);
+        case LV_XML_STYLE_VALUE_INT:
+            return lv_xml_atoi_string(value);
+        case LV_XML_STYLE_VALUE_COLOR:
+            return lv_xml_to_color(value);
+        case LV_XML_STYLE_VALUE_OPA:
+            return lv_xml_to_opa_string(value);
+        case LV_XML_STYLE_VALUE_BOOL:
+            return lv_xml_to_bool_string(value);
+        case LV_XML_STYLE_VALUE_BASE_DIR:
+            return lv_xml_base_dir_to_enum(value);
+        case LV_XML_STYLE_VALUE_GRAD_DIR:
+            return lv_xml_grad_dir_to_enum(value);
+        case LV_XML_STYLE_VALUE_GRAD:
+            return lv_xml_component_get_grad(scope, value, fn);
+        case LV_XML_STYLE_VALUE_IMAGE:
+            return (const char *)lv_xml_get_image(scope, value);
+        case LV_XML_STYLE_VALUE_FONT:
+            return lv_xml_get_font(scope, value);
+        case LV_XML_STYLE_VALUE_BORDER_SIDE:
+            return lv_xml_border_side_to_enum(value);
+        case LV_XML_STYLE_VALUE_TEXT_ALIGN:
+            return lv_xml_text_align_to_enum(value);
+        case LV_XML_STYLE_VALUE_TEXT_DECOR:
+            return lv_xml_text_decor_to_enum(value);
+        case LV_XML_STYLE_VALUE_BLEND_MODE:
+            return lv_xml_blend_mode_to_enum(value);
+        case LV_XML_STYLE_VALUE_LAYOUT:
+            return lv_xml_layout_to_enum(value);
+        case LV_XML_STYLE_VALUE_FLEX_FLOW:
+            return lv_xml_flex_flow_to_enum(value);
+        case LV_XML_STYLE_VALUE_FLEX_ALIGN:
+            return lv_xml_flex_align_to_enum(value);
+        case LV_XML_STYLE_VALUE_GRID_ALIGN:
+            return lv_xml_grid_align_to_enum(value);
+    }
+
+    return value;
+}
+
 lv_state_t lv_xml_style_state_to_enum(const char * txt)
 {
     char* pv = NULL;
@@ -92,19 +285,16 @@ lv_result_t lv_xml_style_register(lv_xml_component_scope_t * scope, const char *
     } 
     if(scope == NULL) return LV_RESULT_INVALID;
 
-    lv_xml_style_t * xml_style;
     /*If a style with the same name is already created, use it */
-    bool found = false;
-    LV_LL_READ(&scope->style_ll, xml_style) {
-        if(lv_streq(xml_style->name, style_name)) {
-            found = true;
-            fn = xml_style->link_fn;
-            LV_LOG_INFO("Style %s is already registered. Extending it with new properties.", style_name);
-            break;
-        }
+    lv_xml_style_t * xml_style = lv_hash_find(&scope->style_index, style_name);
+    if(xml_style) {
+        fn = xml_style->link_fn;
+        LV_LOG_INFO("Style %s is already registered. Extending it with new properties.", style_name);
     }
+    else {
+        lv_hash_entry_t * entry = lv_hash_insert(&scope->style_index, style_name);
+        if(entry == NULL) return LV_RESULT_INVALID;
 
-    if(!found) {
         if (global)
             fn = lvgen_new_global_func();
         else
@@ -112,13 +302,16 @@ lv_result_t lv_xml_style_register(lv_xml_component_scope_t * scope, const char *
         
         xml_style = lv_ll_ins_tail(&scope->style_ll);
         xml_style->name = lv_strdup(style_name);
+        entry->key = xml_style->name;
+        entry->value = xml_style;
         //lv_style_init(&xml_style->style);
         size_t long_name_len = lv_strlen(scope->name) + 1 + lv_strlen(style_name) + 1;
         xml_style->long_name = lv_malloc(long_name_len);
         lv_snprintf((char *)xml_style->long_name, long_name_len, "%s.%s", scope->name, style_name); /*E.g. my_button.style1*/
 
-        lv_snprintf(fn->signature, sizeof(fn->signature), LV_FN_PREFIX "%s_%s_style_init", scope->name, style_name);
+        lvgen_set_func_signature(fn, LV_FN_PREFIX "%s_%s_style_init", scope->name, style_name);
         lvgen_add_func_argument(fn, "lv_style_t*", "style");
+        fn->kind = LV_FUNC_STYLE_INIT;
         lvgen_new_callinsn(fn, LV_TYPE(void), "lv_style_init", "style", NULL);
         xml_style->link_fn = fn;
     }
@@ -133,14 +326,8 @@ lv_result_t lv_xml_style_register(lv_xml_component_scope_t * scope, const char *
         if(lv_streq(name, "figma_node_id")) continue;
 
         if(value[0] == '#') {
-            const char * value_clean = &value[1];
-            lv_xml_const_t * c;
-            LV_LL_READ(&scope->const_ll, c) {
-                if(lv_streq(c->name, value_clean)) {
-                    value = c->value;
-                    break;
-                }
-            }
+            lv_xml_const_t * c = lv_hash_find(&scope->const_index, &value[1]);
+            if(c) value = c->value;
         }
 
         if(lv_streq(value, "remove")) {
@@ -182,135 +369,15 @@ lv_result_t lv_xml_style_register(lv_xml_component_scope_t * scope, const char *
             }
         }
 
-        else SET_STYLE_IF(width, lv_xml_to_size(value));
-        else SET_STYLE_IF(min_width, lv_xml_to_size(value));
-        else SET_STYLE_IF(max_width, lv_xml_to_size(value));
-        else SET_STYLE_IF(height, lv_xml_to_size(value));
-        else SET_STYLE_IF(min_height, lv_xml_to_size(value));
-        else SET_STYLE_IF(max_height, lv_xml_to_size(value));
-        else SET_STYLE_IF(length, lv_xml_to_size(value));
-        else SET_STYLE_IF(radius, lv_xml_to_size(value));
-
-        else SET_STYLE_IF(pad_left, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_right, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_top, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_bottom, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_hor, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_ver, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_all, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_row, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_column, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_gap, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(pad_radial, lv_xml_atoi_string(value));
-
-        else SET_STYLE_IF(margin_left, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(margin_right, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(margin_top, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(margin_bottom, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(margin_hor, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(margin_ver, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(margin_all, lv_xml_atoi_string(value));
-
-        else SET_STYLE_IF(base_dir, lv_xml_base_dir_to_enum(value));
-        else SET_STYLE_IF(clip_corner, lv_xml_to_bool_string(value));
-
-        else SET_STYLE_IF(bg_opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(bg_color, lv_xml_to_color(value));
-        else SET_STYLE_IF(bg_grad_dir, lv_xml_grad_dir_to_enum(value));
-        else SET_STYLE_IF(bg_grad_color, lv_xml_to_color(value));
-        else SET_STYLE_IF(bg_main_stop, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(bg_grad_stop, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(bg_grad, lv_xml_component_get_grad(scope, value, fn));
-
-        else SET_STYLE_IF(bg_image_src, lv_xml_get_image(scope, value));
-        else SET_STYLE_IF(bg_image_tiled, lv_xml_to_bool_string(value));
-        else SET_STYLE_IF(bg_image_recolor, lv_xml_to_color(value));
-        else SET_STYLE_IF(bg_image_recolor_opa, lv_xml_to_opa_string(value));
-
-        else SET_STYLE_IF(border_color, lv_xml_to_color(value));
-        else SET_STYLE_IF(border_width, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(border_opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(border_side, lv_xml_border_side_to_enum(value));
-        else SET_STYLE_IF(border_post, lv_xml_to_bool_string(value));
-
-        else SET_STYLE_IF(outline_color, lv_xml_to_color(value));
-        else SET_STYLE_IF(outline_width, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(outline_opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(outline_pad, lv_xml_atoi_string(value));
-
-        else SET_STYLE_IF(shadow_width, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(shadow_color, lv_xml_to_color(value));
-        else SET_STYLE_IF(shadow_offset_x, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(shadow_offset_y, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(shadow_spread, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(shadow_opa, lv_xml_to_opa_string(value));
-
-        else SET_STYLE_IF(text_color, lv_xml_to_color(value));
-        else SET_STYLE_IF(text_font, lv_xml_get_font(scope, value));
-        else SET_STYLE_IF(text_opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(text_align, lv_xml_text_align_to_enum(value));
-        else SET_STYLE_IF(text_letter_space, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(text_line_space, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(text_decor, lv_xml_text_decor_to_enum(value));
-
-        else SET_STYLE_IF(image_opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(image_recolor, lv_xml_to_color(value));
-        else SET_STYLE_IF(image_recolor_opa, lv_xml_to_opa_string(value));
-
-        else SET_STYLE_IF(line_color, lv_xml_to_color(value));
-        else SET_STYLE_IF(line_opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(line_width, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(line_dash_width, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(line_dash_gap, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(line_rounded, lv_xml_to_bool_string(value));
-
-        else SET_STYLE_IF(arc_color, lv_xml_to_color(value));
-        else SET_STYLE_IF(arc_opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(arc_width, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(arc_rounded, lv_xml_to_bool_string(value));
-        else SET_STYLE_IF(arc_image_src, lv_xml_get_image(scope, value));
-
-        else SET_STYLE_IF(opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(opa_layered, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(color_filter_opa, lv_xml_to_opa_string(value));
-        else SET_STYLE_IF(anim_duration, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(blend_mode, lv_xml_blend_mode_to_enum(value));
-        else SET_STYLE_IF(transform_width, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(transform_height, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(translate_x, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(translate_y, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(translate_radial, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(transform_scale_x, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(transform_scale_y, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(transform_rotation, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(transform_pivot_x, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(transform_pivot_y, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(transform_skew_x, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(bitmap_mask_src, lv_xml_get_image(scope, value));
-        else SET_STYLE_IF(rotary_sensitivity, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(recolor, lv_xml_to_color(value));
-        else SET_STYLE_IF(recolor_opa, lv_xml_to_opa_string(value));
-
-        else SET_STYLE_IF(layout, lv_xml_layout_to_enum(value));
-
-        else SET_STYLE_IF(flex_flow, lv_xml_flex_flow_to_enum(value));
-        else SET_STYLE_IF(flex_grow, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(flex_main_place, lv_xml_flex_align_to_enum(value));
-        else SET_STYLE_IF(flex_cross_place, lv_xml_flex_align_to_enum(value));
-        else SET_STYLE_IF(flex_track_place, lv_xml_flex_align_to_enum(value));
-
-        else SET_STYLE_IF(grid_column_align, lv_xml_grid_align_to_enum(value));
-        else SET_STYLE_IF(grid_row_align, lv_xml_grid_align_to_enum(value));
-        else SET_STYLE_IF(grid_cell_column_pos, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(grid_cell_column_span, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(grid_cell_x_align, lv_xml_grid_align_to_enum(value));
-        else SET_STYLE_IF(grid_cell_row_pos, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(grid_cell_row_span, lv_xml_atoi_string(value));
-        else SET_STYLE_IF(grid_cell_y_align, lv_xml_grid_align_to_enum(value));
-
-
         else {
-            LV_LOG_WARN("%s style property is not supported", name);
+            const lv_xml_style_prop_dsc_t * dsc = lv_xml_style_prop_find(name);
+            if(dsc) {
+                lvgen_new_callinsn(fn, LV_TYPE(void), dsc->style_setter, "style",
+                                   lv_xml_style_prop_value(dsc, scope, value, fn), NULL);
+            }
+            else {
+                LV_LOG_WARN("%s style property is not supported", name);
+            }
         }
     }
 
@@ -319,7 +386,7 @@ lv_result_t lv_xml_style_register(lv_xml_component_scope_t * scope, const char *
 
 const char * lv_xml_style_string_process(char * txt, lv_style_selector_t * selector)
 {
-    static char sty_buf[256];
+    static LV_THREAD_LOCAL char sty_buf[256];
     char* p = sty_buf;
     int remain = sizeof(sty_buf);
     int len = 0;
@@ -387,7 +454,7 @@ void lv_xml_style_add_to_obj(lv_xml_parser_state_t * state, lv_obj_t * obj, cons
                     char stybuf[64];
 
                     lv_snprintf(stybuf, sizeof(stybuf), LV_VFN_STYLE_AT(%d), fn->style_num++);
-                    lvgen_new_callinsn(fn, LV_TYPE(void), callee->signature, stybuf, NULL);
+                    lvgen_new_funcinsn(fn, callee, stybuf, NULL);
                     lvgen_new_callinsn(fn, LV_TYPE(void), "lv_obj_add_style", LV_OBJNAME(obj), stybuf, selector, NULL);
                     lvgen_new_module_depend(fn->owner, callee);
                 }
@@ -422,18 +489,15 @@ lv_xml_style_t * lv_xml_get_style_by_name(lv_xml_component_scope_t * scope, cons
     if(scope == NULL) scope = lv_xml_component_get_scope("globals");
     if(scope == NULL) return NULL;
 
-    lv_xml_style_t * xml_style;
-    LV_LL_READ(&scope->style_ll, xml_style) {
-        if(lv_streq(xml_style->name, style_name)) return xml_style;
-    }
+    lv_xml_style_t * xml_style = lv_hash_find(&scope->style_index, style_name);
+    if(xml_style) return xml_style;
 
     /*If not found in the component check the global space*/
     if(!lv_streq(scope->name, "globals")) {
         scope = lv_xml_component_get_scope("globals");
         if(scope) {
-            LV_LL_READ(&scope->style_ll, xml_style) {
-                if(lv_streq(xml_style->name, style_name)) return xml_style;
-            }
+            xml_style = lv_hash_find(&scope->style_index, style_name);
+            if(xml_style) return xml_style;
         }
     }
 
@@ -446,7 +510,7 @@ const char* lv_xml_component_get_grad(lv_xml_component_scope_t * scope, const ch
     void *parent_fn)
 {
     lv_xml_grad_t * d;
-    static char gradbuf[128];
+    static LV_THREAD_LOCAL char gradbuf[128];
 
     LV_LL_READ(&scope->gradient_ll, d) {
         if (lv_streq(d->name, name)) {
@@ -459,8 +523,8 @@ const char* lv_xml_component_get_grad(lv_xml_component_scope_t * scope, const ch
                 lvgen_new_exprinsn(parent_fn, "static lv_grad_dsc_t gard_dsc%d;", no);
                 lvgen_new_exprinsn(parent_fn, "static bool gard_dsc%d_ready;", no);
                 lvgen_new_exprinsn(parent_fn, "if (!gard_dsc%d_ready) {", no);
-                lvgen_new_exprinsn(parent_fn, "   gard_dsc%d_ready = true;", no);
-                lvgen_new_exprinsn(parent_fn, "   %s(%s);", fn->signature, gradbuf);
+                lvgen_new_exprinsn(parent_fn, "gard_dsc%d_ready = true;", no);
+                lvgen_new_funcinsn(parent_fn, fn, gradbuf, NULL);
                 lvgen_new_exprinsn(parent_fn, "}\n");
 
                 pfn->grad_cnt = no + 1;
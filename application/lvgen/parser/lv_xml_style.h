@@ -31,10 +31,64 @@ typedef struct _lv_xml_style_t {
     void* link_fn;
 } lv_xml_style_t;
 
+/** How the XML value of a style property is converted to C*/
+typedef enum {
+    LV_XML_STYLE_VALUE_SIZE,
+    LV_XML_STYLE_VALUE_INT,
+    LV_XML_STYLE_VALUE_COLOR,
+    LV_XML_STYLE_VALUE_OPA,
+    LV_XML_STYLE_VALUE_BOOL,
+    LV_XML_STYLE_VALUE_BASE_DIR,
+    LV_XML_STYLE_VALUE_GRAD_DIR,
+    LV_XML_STYLE_VALUE_GRAD,
+    LV_XML_STYLE_VALUE_IMAGE,
+    LV_XML_STYLE_VALUE_FONT,
+    LV_XML_STYLE_VALUE_BORDER_SIDE,
+    LV_XML_STYLE_VALUE_TEXT_ALIGN,
+    LV_XML_STYLE_VALUE_TEXT_DECOR,
+    LV_XML_STYLE_VALUE_BLEND_MODE,
+    LV_XML_STYLE_VALUE_LAYOUT,
+    LV_XML_STYLE_VALUE_FLEX_FLOW,
+    LV_XML_STYLE_VALUE_FLEX_ALIGN,
+    LV_XML_STYLE_VALUE_GRID_ALIGN,
+} lv_xml_style_value_t;
+
+/** Descriptor of a style property*/
+typedef struct {
+    const char * name;                  /**< E.g. "bg_color"*/
+    const char * style_setter;          /**< E.g. "lv_style_set_bg_color"*/
+    const char * obj_setter;            /**< E.g. "lv_obj_set_style_bg_color"*/
+    lv_xml_style_value_t value_type;
+} lv_xml_style_prop_dsc_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 
+/**
+ * Build the lookup table of the style properties. Call it before parsing,
+ * the table is read only afterwards.
+ */
+void lv_xml_style_props_init(void);
+
+/**
+ * Find a style property by name
+ * @param name      name of the property without prefix, e.g. "bg_color"
+ * @return          the descriptor of the property or `NULL` if it's not supported
+ */
+const lv_xml_style_prop_dsc_t * lv_xml_style_prop_find(const char * name);
+
+/**
+ * Convert the XML value of a style property to a C expression
+ * @param dsc       descriptor of the property
+ * @param scope     resolve images, fonts and gradients here
+ * @param value     the value from XML, e.g. "0xff0000"
+ * @param fn        function where a gradient is initialized
+ * @return          the C expression of the value
+ */
+const char * lv_xml_style_prop_value(const lv_xml_style_prop_dsc_t * dsc, lv_xml_component_scope_t * scope,
+                                     const char * value, void * fn);
+
 /**
  * Add a style to `ctx` and set the style properties from `attrs`
  * @param scope     add styles here. (Constants should be already added as style properties might use them)
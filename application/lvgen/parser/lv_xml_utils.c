@@ -55,7 +55,7 @@ const char * lv_xml_get_value_of(const char ** attrs, const char * name)
 
 lv_color_t lv_xml_to_color(const char * str)
 {
-    static char buf[48];
+    static LV_THREAD_LOCAL char buf[48];
 
     /*fff, #fff, 0xfff*/
     if (lv_strlen(str) <= 5)
@@ -90,7 +90,7 @@ lv_opa_t lv_xml_to_opa(const char * str)
 
 const char *lv_xml_to_opa_string(const char* str)
 {
-    static char opabuf[4];
+    static LV_THREAD_LOCAL char opabuf[4];
 
     lv_snprintf(opabuf, sizeof(opabuf), "%d", (int)lv_xml_to_opa(str));
     return opabuf;
@@ -153,10 +153,10 @@ int32_t lv_xml_atoi(const char * str)
 
 const char *lv_xml_atoi_string(const char* str)
 {
-    static char numbuf[20];
+    static LV_THREAD_LOCAL char numbuf[20];
 
     int32_t v = lv_xml_atoi_split(&str, '\0');
-    lv_snprintf(numbuf, sizeof(numbuf), "%d", str);
+    lv_snprintf(numbuf, sizeof(numbuf), "%d", (int)v);
 
     return numbuf;
 }
@@ -74,11 +74,11 @@ void * lv_xml_event_call_function_create(lv_xml_parser_state_t * state, const ch
     lvgen_new_exprinsn(fn, "lv_obj_add_event_cb(%s, %s, %s, %s);",
         LV_OBJNAME(obj), cb_txt, code, user_data);
 
-    struct func_context* newfn = lvgen_new_module_func_named(lvgen_get_module(), cb_txt);
+    struct func_context* newfn = lvgen_new_module_func_named(fn->owner, cb_txt);
     if (!lvgen_func_initialized(newfn)) {
         lvgen_set_func_rettype(newfn, LV_TYPE(void));
         lvgen_add_func_argument(newfn, "lv_event_t*", "e");
-        lv_strlcpy(newfn->signature, cb_txt, sizeof(newfn->signature));
+        lvgen_set_func_signature(newfn, "%s", cb_txt);
         lvgen_new_exprinsn(newfn, "lv_obj_t *target = lv_event_get_target(e);");
         lvgen_new_exprinsn(newfn, "lv_event_code_t code = lv_event_get_code(e);");
         if (user_data != NULL)
@@ -34,16 +34,6 @@ static void apply_styles(lv_xml_parser_state_t * state, lv_obj_t * obj, const ch
  *      MACROS
  **********************/
 
-/* Expands to
-   if(lv_streq(prop_name, "style_height")) lv_obj_set_style_height(obj, value, selector)
- */
-//#define SET_STYLE_IF(prop, value) if(lv_streq(prop_name, "style_" #prop)) lv_obj_set_style_##prop(obj, value, selector)
-
-#define SET_STYLE_IF(prop, value) \
-    if(lv_streq(prop_name, "style_" #prop)) lvgen_new_callinsn(fn, LV_TYPE(void), "lv_obj_set_style_" #prop, LV_OBJNAME(obj), value, selector, NULL)
-
-
-
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -268,131 +258,15 @@ static void apply_styles(lv_xml_parser_state_t * state, lv_obj_t * obj, const ch
 
     struct func_context* fn = state->scope.active_func;
 
-    SET_STYLE_IF(width, lv_xml_to_size(value));
-    else SET_STYLE_IF(min_width, lv_xml_to_size(value));
-    else SET_STYLE_IF(max_width, lv_xml_to_size(value));
-    else SET_STYLE_IF(height, lv_xml_to_size(value));
-    else SET_STYLE_IF(min_height, lv_xml_to_size(value));
-    else SET_STYLE_IF(max_height, lv_xml_to_size(value));
-    else SET_STYLE_IF(length, lv_xml_to_size(value));
-    else SET_STYLE_IF(radius, lv_xml_to_size(value));
-
-    else SET_STYLE_IF(pad_left, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_right, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_top, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_bottom, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_hor, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_ver, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_all, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_row, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_column, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_gap, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(pad_radial, lv_xml_atoi_string(value));
-
-    else SET_STYLE_IF(margin_left, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(margin_right, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(margin_top, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(margin_bottom, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(margin_hor, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(margin_ver, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(margin_all, lv_xml_atoi_string(value));
-
-    else SET_STYLE_IF(base_dir, lv_xml_base_dir_to_enum(value));
-    else SET_STYLE_IF(clip_corner, lv_xml_to_bool(value));
-
-    else SET_STYLE_IF(bg_opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(bg_color, lv_xml_to_color(value));
-    else SET_STYLE_IF(bg_grad_dir, lv_xml_grad_dir_to_enum(value));
-    else SET_STYLE_IF(bg_grad_color, lv_xml_to_color(value));
-    else SET_STYLE_IF(bg_main_stop, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(bg_grad_stop, lv_xml_atoi_string(value));
-    //else SET_STYLE_IF(bg_grad, lv_xml_component_get_grad(&state->scope, value));
-
-    //else SET_STYLE_IF(bg_image_src, lv_xml_get_image(&state->scope, value));
-    else SET_STYLE_IF(bg_image_tiled, lv_xml_to_bool(value));
-    else SET_STYLE_IF(bg_image_recolor, lv_xml_to_color(value));
-    else SET_STYLE_IF(bg_image_recolor_opa, lv_xml_to_opa(value));
-
-    else SET_STYLE_IF(border_color, lv_xml_to_color(value));
-    else SET_STYLE_IF(border_width, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(border_opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(border_side, lv_xml_border_side_to_enum(value));
-    else SET_STYLE_IF(border_post, lv_xml_to_bool(value));
-
-    else SET_STYLE_IF(outline_color, lv_xml_to_color(value));
-    else SET_STYLE_IF(outline_width, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(outline_opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(outline_pad, lv_xml_atoi_string(value));
-
-    else SET_STYLE_IF(shadow_width, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(shadow_color, lv_xml_to_color(value));
-    else SET_STYLE_IF(shadow_offset_x, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(shadow_offset_y, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(shadow_spread, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(shadow_opa, lv_xml_to_opa(value));
-
-    else SET_STYLE_IF(text_color, lv_xml_to_color(value));
-    else SET_STYLE_IF(text_font, lv_xml_get_font(&state->scope, value));
-    else SET_STYLE_IF(text_opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(text_align, lv_xml_text_align_to_enum(value));
-    else SET_STYLE_IF(text_letter_space, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(text_line_space, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(text_decor, lv_xml_text_decor_to_enum(value));
-
-    else SET_STYLE_IF(image_opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(image_recolor, lv_xml_to_color(value));
-    else SET_STYLE_IF(image_recolor_opa, lv_xml_to_opa(value));
-
-    else SET_STYLE_IF(line_color, lv_xml_to_color(value));
-    else SET_STYLE_IF(line_opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(line_width, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(line_dash_width, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(line_dash_gap, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(line_rounded, lv_xml_to_bool(value));
-
-    else SET_STYLE_IF(arc_color, lv_xml_to_color(value));
-    else SET_STYLE_IF(arc_opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(arc_width, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(arc_rounded, lv_xml_to_bool(value));
-    else SET_STYLE_IF(arc_image_src, lv_xml_get_image(&state->scope, value));
-
-    else SET_STYLE_IF(opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(opa_layered, lv_xml_to_opa(value));
-    else SET_STYLE_IF(color_filter_opa, lv_xml_to_opa(value));
-    else SET_STYLE_IF(anim_duration, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(blend_mode, lv_xml_blend_mode_to_enum(value));
-    else SET_STYLE_IF(transform_width, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(transform_height, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(translate_x, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(translate_y, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(translate_radial, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(transform_scale_x, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(transform_scale_y, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(transform_rotation, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(transform_pivot_x, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(transform_pivot_y, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(transform_skew_x, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(bitmap_mask_src, lv_xml_get_image(&state->scope, value));
-    else SET_STYLE_IF(rotary_sensitivity, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(recolor, lv_xml_to_color(value));
-    else SET_STYLE_IF(recolor_opa, lv_xml_to_opa(value));
-
-    else SET_STYLE_IF(layout, lv_xml_layout_to_enum(value));
-
-    else SET_STYLE_IF(flex_flow, lv_xml_flex_flow_to_enum(value));
-    else SET_STYLE_IF(flex_grow, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(flex_main_place, lv_xml_flex_align_to_enum(value));
-    else SET_STYLE_IF(flex_cross_place, lv_xml_flex_align_to_enum(value));
-    else SET_STYLE_IF(flex_track_place, lv_xml_flex_align_to_enum(value));
-
-    else SET_STYLE_IF(grid_column_align, lv_xml_grid_align_to_enum(value));
-    else SET_STYLE_IF(grid_row_align, lv_xml_grid_align_to_enum(value));
-    else SET_STYLE_IF(grid_cell_column_pos, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(grid_cell_column_span, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(grid_cell_x_align, lv_xml_grid_align_to_enum(value));
-    else SET_STYLE_IF(grid_cell_row_pos, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(grid_cell_row_span, lv_xml_atoi_string(value));
-    else SET_STYLE_IF(grid_cell_y_align, lv_xml_grid_align_to_enum(value));
+    /*Skip the "style_" prefix*/
+    const lv_xml_style_prop_dsc_t * dsc = lv_xml_style_prop_find(prop_name + 6);
+    if(dsc == NULL) {
+        LV_LOG_WARN("%s style property is not supported", prop_name);
+        return;
+    }
+
+    lvgen_new_callinsn(fn, LV_TYPE(void), dsc->obj_setter, LV_OBJNAME(obj),
+                       lv_xml_style_prop_value(dsc, &state->scope, value, fn), selector, NULL);
 }
 
 
@@ -5,15 +5,26 @@
 #include "driver/config.h"
 
 #if USE_FILE_WATCHER > 0
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 //#include <stdatomic.h>
 #include <time.h>
 #include <threads.h>
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#endif
 
 #include "driver/queue.h"
 #include "driver/file_watcher.h"
@@ -29,8 +40,15 @@ struct watcher_node {
 #define MAX_FILEPATH 255
     TAILQ_ENTRY(watcher_node) node;
     char            filepath[MAX_FILEPATH + 1];
-    uint64_t        timestamp;
     file_watcher_cb callback;
+#ifdef _WIN32
+    uint64_t        timestamp;
+#else
+    int             wd;       /* Watch of the parent directory */
+    const char*     name;     /* File name in the parent directory */
+    bool            pending;
+    uint64_t        deadline; /* Time to report the pending change */
+#endif
 };
 
 static TAILQ_HEAD(, watcher_node) watcher_list;
@@ -39,16 +57,6 @@ static volatile int watcher_state;
 static mtx_t watcher_lock;
 static thrd_t watcher_tid;
 
-static bool file_watcher_get_timestamp(const char* file, uint64_t *pts) {
-    WIN32_FILE_ATTRIBUTE_DATA attr;
-    if (!GetFileAttributesExA(file, GetFileExInfoStandard, &attr))
-        return false;
-
-    uint64_t ts = attr.ftLastWriteTime.dwHighDateTime;
-    *pts = (ts << 32) | attr.ftLastWriteTime.dwLowDateTime;
-    return true;
-}
-
 static void sleep_millisec(unsigned int ms) {
 #define NS_PER_SEC (1000000000ul)
     struct timespec ts = {0};
@@ -64,6 +72,30 @@ static void sleep_millisec(unsigned int ms) {
     thrd_sleep(&ts, NULL);
 }
 
+static void file_watcher_free_all(void) {
+    struct watcher_node* wnd, * wnd_next;
+
+    TAILQ_FOREACH_SAFE(wnd, &watcher_list, node, wnd_next) {
+        TAILQ_REMOVE(&watcher_list, wnd, node);
+        free(wnd);
+    }
+    TAILQ_INIT(&watcher_list);
+}
+
+#ifdef _WIN32
+/*
+ * Windows: the timestamps of the files are polled every watcher_period ms
+ */
+static bool file_watcher_get_timestamp(const char* file, uint64_t *pts) {
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExA(file, GetFileExInfoStandard, &attr))
+        return false;
+
+    uint64_t ts = attr.ftLastWriteTime.dwHighDateTime;
+    *pts = (ts << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    return true;
+}
+
 static int file_watcher_thread(void* arg) {
     struct watcher_node* wnd, * wnd_next;
 
@@ -87,29 +119,248 @@ static int file_watcher_thread(void* arg) {
     }
 
     /*
-     * Clean all watcher node  
+     * Clean all watcher node
      */
     mtx_lock(&watcher_lock);
-    TAILQ_FOREACH_SAFE(wnd, &watcher_list, node, wnd_next) {
-        TAILQ_REMOVE(&watcher_list, wnd, node);
-        free(wnd);
+    file_watcher_free_all();
+    mtx_unlock(&watcher_lock);
+
+    watcher_state = WATCHER_IDLE;
+    thrd_exit(0);
+
+    return 0;
+}
+
+static int file_watcher_os_init(void) {
+    return 0;
+}
+
+static void file_watcher_os_deinit(void) {
+}
+
+static void file_watcher_os_wakeup(void) {
+}
+
+static int file_watcher_os_add(struct watcher_node* wnd) {
+    if (!file_watcher_get_timestamp(wnd->filepath, &wnd->timestamp)) {
+        printf("Invalid(%ld) file path(%s)\n", GetLastError(), wnd->filepath);
+        return -ESRCH;
     }
-    TAILQ_INIT(&watcher_list);
+    return 0;
+}
+
+static void file_watcher_os_remove(struct watcher_node* wnd) {
+    (void) wnd;
+}
+
+#else /* !_WIN32 */
+/*
+ * Linux: the parent directories are watched with inotify, so the files
+ * replaced by rename (as most editors save) are still followed. The changes
+ * of a file are reported once it has been quiet for watcher_period ms.
+ */
+#define WATCHER_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE)
+
+static int inotify_fd = -1;
+static int wakeup_fd = -1;
+
+static uint64_t file_watcher_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Milliseconds to the nearest pending change, -1 if there is none */
+static int file_watcher_next_timeout(void) {
+    struct watcher_node* wnd;
+    uint64_t now = file_watcher_now();
+    int timeout = -1;
+
+    mtx_lock(&watcher_lock);
+    TAILQ_FOREACH(wnd, &watcher_list, node) {
+        if (wnd->pending) {
+            int ms = wnd->deadline > now ? (int)(wnd->deadline - now) : 0;
+            if (timeout < 0 || ms < timeout)
+                timeout = ms;
+        }
+    }
+    mtx_unlock(&watcher_lock);
+
+    return timeout;
+}
+
+static void file_watcher_mark(const struct inotify_event* ev, uint64_t deadline) {
+    struct watcher_node* wnd;
+
+    TAILQ_FOREACH(wnd, &watcher_list, node) {
+        /* The events are lost if the queue overflows, assume all changed */
+        if ((ev->mask & IN_Q_OVERFLOW) ||
+            (wnd->wd == ev->wd && ev->len > 0 && !strcmp(wnd->name, ev->name))) {
+            wnd->pending = true;
+            wnd->deadline = deadline;
+        }
+    }
+}
+
+static void file_watcher_read_events(void) {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+
+    while ((len = read(inotify_fd, buf, sizeof(buf))) > 0) {
+        uint64_t deadline = file_watcher_now() + watcher_period;
+        char* ptr = buf;
+
+        mtx_lock(&watcher_lock);
+        while (ptr < buf + len) {
+            const struct inotify_event* ev = (const struct inotify_event*)ptr;
+            file_watcher_mark(ev, deadline);
+            ptr += sizeof(struct inotify_event) + ev->len;
+        }
+        mtx_unlock(&watcher_lock);
+    }
+}
+
+/*
+ * The callback is called without the lock, so it can add or remove files
+ */
+static void file_watcher_dispatch(void) {
+    struct watcher_node* wnd;
+    char filepath[MAX_FILEPATH + 1];
+    file_watcher_cb callback;
+
+    while (true) {
+        uint64_t now = file_watcher_now();
+
+        callback = NULL;
+        mtx_lock(&watcher_lock);
+        TAILQ_FOREACH(wnd, &watcher_list, node) {
+            if (wnd->pending && wnd->deadline <= now) {
+                wnd->pending = false;
+                callback = wnd->callback;
+                strcpy(filepath, wnd->filepath);
+                break;
+            }
+        }
+        mtx_unlock(&watcher_lock);
+
+        if (callback == NULL)
+            break;
+        callback(filepath);
+    }
+}
+
+static void file_watcher_os_deinit(void) {
+    close(inotify_fd);
+    close(wakeup_fd);
+    inotify_fd = wakeup_fd = -1;
+}
+
+static int file_watcher_thread(void* arg) {
+    struct pollfd fds[2] = {
+        {.fd = inotify_fd, .events = POLLIN},
+        {.fd = wakeup_fd,  .events = POLLIN},
+    };
+
+    while (watcher_state != WATCHER_REQSTOP) {
+        int err = poll(fds, 2, file_watcher_next_timeout());
+        if (err < 0) {
+            if (errno == EINTR)
+                continue;
+            printf("File watcher poll failed(%d)\n", errno);
+            break;
+        }
+
+        if (fds[0].revents & POLLIN)
+            file_watcher_read_events();
+        file_watcher_dispatch();
+    }
+
+    /*
+     * Clean all watcher node
+     */
+    mtx_lock(&watcher_lock);
+    file_watcher_free_all();
     mtx_unlock(&watcher_lock);
 
+    file_watcher_os_deinit();
+
     watcher_state = WATCHER_IDLE;
     thrd_exit(0);
 
     return 0;
 }
 
+static int file_watcher_os_init(void) {
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0)
+        return -errno;
+
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd < 0) {
+        int err = -errno;
+        close(inotify_fd);
+        inotify_fd = -1;
+        return err;
+    }
+    return 0;
+}
+
+static void file_watcher_os_wakeup(void) {
+    uint64_t val = 1;
+
+    /* EAGAIN: the counter is full, so the thread will wake up anyway */
+    if (write(wakeup_fd, &val, sizeof(val)) < 0 && errno != EAGAIN)
+        printf("File watcher wakeup failed(%d)\n", errno);
+}
+
+static int file_watcher_os_add(struct watcher_node* wnd) {
+    char dir[MAX_FILEPATH + 1];
+    struct stat st;
+    char* sep;
+
+    if (stat(wnd->filepath, &st) < 0) {
+        printf("Invalid(%d) file path(%s)\n", errno, wnd->filepath);
+        return -ESRCH;
+    }
+
+    strcpy(dir, wnd->filepath);
+    sep = strrchr(dir, '/');
+    if (sep == NULL) {
+        strcpy(dir, ".");
+        wnd->name = wnd->filepath;
+    } else {
+        wnd->name = wnd->filepath + (sep - dir) + 1;
+        if (sep == dir)
+            sep++;
+        *sep = '\0';
+    }
+
+    /* The files of a directory share its watch */
+    wnd->wd = inotify_add_watch(inotify_fd, dir, WATCHER_EVENTS);
+    if (wnd->wd < 0) {
+        printf("Failed(%d) to watch directory(%s)\n", errno, dir);
+        return -errno;
+    }
+    return 0;
+}
+
+static void file_watcher_os_remove(struct watcher_node* wnd) {
+    struct watcher_node* pos;
+
+    TAILQ_FOREACH(pos, &watcher_list, node) {
+        if (pos != wnd && pos->wd == wnd->wd)
+            return;
+    }
+    inotify_rm_watch(inotify_fd, wnd->wd);
+}
+#endif /* _WIN32 */
+
 static void file_watcher_exit(void) {
     (void) file_watcher_deinit();
 }
 
 int file_watcher_add(const char* filepath, file_watcher_cb cb) {
     struct watcher_node* wnd;
-    uint64_t ts = 0;
 
     if (filepath == NULL || cb == NULL)
         return -EINVAL;
@@ -117,24 +368,22 @@ int file_watcher_add(const char* filepath, file_watcher_cb cb) {
     if (watcher_state != WATCHER_ACTIVED)
         return -EBUSY;
 
-    if (!file_watcher_get_timestamp(filepath, &ts)) {
-        printf("Invalid(%ld) file path(%s)\n", GetLastError(), filepath);
-        return -ESRCH;
-    }
-
     wnd = calloc(1, sizeof(struct watcher_node));
     if (wnd == NULL)
         return -ENOMEM;
 
     strncpy(wnd->filepath, filepath, MAX_FILEPATH);
     wnd->callback = cb;
-    wnd->timestamp = ts;
 
     mtx_lock(&watcher_lock);
-    TAILQ_INSERT_TAIL(&watcher_list, wnd, node);
+    int err = file_watcher_os_add(wnd);
+    if (!err)
+        TAILQ_INSERT_TAIL(&watcher_list, wnd, node);
     mtx_unlock(&watcher_lock);
 
-    return 0;
+    if (err)
+        free(wnd);
+    return err;
 }
 
 int file_watcher_remove(const char* filepath) {
@@ -149,6 +398,7 @@ int file_watcher_remove(const char* filepath) {
     mtx_lock(&watcher_lock);
     TAILQ_FOREACH(wnd, &watcher_list, node) {
         if (!strcmp(wnd->filepath, filepath)) {
+            file_watcher_os_remove(wnd);
             TAILQ_REMOVE(&watcher_list, wnd, node);
             free(wnd);
             break;
@@ -167,6 +417,7 @@ int file_watcher_remove_all(void) {
 
     mtx_lock(&watcher_lock);
     TAILQ_FOREACH_SAFE(wnd, &watcher_list, node, wnd_next) {
+        file_watcher_os_remove(wnd);
         TAILQ_REMOVE(&watcher_list, wnd, node);
         free(wnd);
     }
@@ -179,14 +430,22 @@ int file_watcher_init(unsigned int monitor_period) {
     if (watcher_state != WATCHER_IDLE)
         return -EBUSY;
 
+    int err = file_watcher_os_init();
+    if (err) {
+        printf("Failed(%d) to initialize file watcher\n", err);
+        return err;
+    }
+
     TAILQ_INIT(&watcher_list);
     mtx_init(&watcher_lock, 0);
     watcher_state = WATCHER_ACTIVED;
     watcher_period = monitor_period;
 
-    int err = thrd_create(&watcher_tid, file_watcher_thread, NULL);
+    err = thrd_create(&watcher_tid, file_watcher_thread, NULL);
     if (err != thrd_success) {
         printf("Failed(%d) to create file watcher thread\n", err);
+        file_watcher_os_deinit();
+        mtx_destroy(&watcher_lock);
         watcher_state = WATCHER_IDLE;
         return err;
     }
@@ -202,6 +461,7 @@ int file_watcher_deinit(void) {
 
     /* Waiting for watcher thread stop */
     watcher_state = WATCHER_REQSTOP;
+    file_watcher_os_wakeup();
     while (watcher_state != WATCHER_IDLE) {
         sleep_millisec(100);
     }
@@ -16,6 +16,12 @@ typedef void (*file_watcher_cb)(const char* file);
 int file_watcher_add(const char* filepath, file_watcher_cb cb);
 int file_watcher_remove(const char* filepath);
 int file_watcher_remove_all(void);
+
+/*
+ * monitor_period: the polling period in ms on Windows. On Linux the changes
+ * are reported by inotify once a file has been quiet for monitor_period ms,
+ * so the burst of writes of a save is reported once.
+ */
 int file_watcher_init(unsigned int monitor_period);
 int file_watcher_deinit(void);
 #else
@@ -10,55 +10,164 @@
 #include <SDL2/SDL.h>
 
 #include "simulator.h"
-#include "driver/queue.h"
 #include "lvgl/lvgl.h"
 #include "lvgl/src/drivers/lv_drivers.h"
 
 
+/*
+ * Bounded multi-producer single-consumer ring. Each slot has a sequence
+ * number: a producer claims the slot at tail when its sequence is equal to
+ * the position, and publishes it with position + 1. The UI thread consumes
+ * it and gives the slot back for the next lap with position + capacity.
+ */
 typedef struct simulator_message {
-	TAILQ_ENTRY(simulator_message) node;
+	SDL_atomic_t seq;
 	lvgl_message_t message;
 } simulator_message_t;
 
 typedef struct {
-	TAILQ_HEAD(, simulator_message) pending;
-	TAILQ_HEAD(, simulator_message) free;
-	SDL_mutex* mutex;
+	simulator_message_t* ring;
+	unsigned int mask;
+	SDL_atomic_t tail;
+	unsigned int head; /* Only the UI thread reads it */
+	SDL_atomic_t waiters;
+	SDL_sem* space;
+	unsigned int budget_ms;
+	SDL_atomic_t wakeup; /* A wake up event is in the SDL queue */
+	Uint32 wake_event;
+	lvgl_frame_stats_t stats;
 } simulator_context_t;
 
-#define MAX_MESSAGES 20
+#define DEFAULT_MESSAGES  256
+#define DEFAULT_BUDGET_MS 8
 
+static unsigned int msg_capacity = DEFAULT_MESSAGES;
+static unsigned int msg_budget_ms = DEFAULT_BUDGET_MS;
 static simulator_context_t sim_context;
-static simulator_message_t msg_buffer[MAX_MESSAGES];
 
 extern lv_indev_t* lv_sdl_mouse_create(void);
 extern void lv_sdl_mouse_handler(SDL_Event* event);
 
 static void message_init(void) {
-	sim_context.mutex = SDL_CreateMutex();
-	assert(sim_context.mutex != NULL);
+	simulator_context_t* ctx = &sim_context;
+	unsigned int capacity = 1;
+
+	while (capacity < msg_capacity)
+		capacity <<= 1;
+
+	ctx->ring = calloc(capacity, sizeof(simulator_message_t));
+	assert(ctx->ring != NULL);
+	ctx->space = SDL_CreateSemaphore(0);
+	assert(ctx->space != NULL);
+
+	for (unsigned int i = 0; i < capacity; i++)
+		SDL_AtomicSet(&ctx->ring[i].seq, (int)i);
+	ctx->mask = capacity - 1;
+	ctx->budget_ms = msg_budget_ms;
+	ctx->head = 0;
+	SDL_AtomicSet(&ctx->waiters, 0);
+	SDL_AtomicSet(&ctx->tail, 0);
+	SDL_AtomicSet(&ctx->wakeup, 0);
+	ctx->wake_event = SDL_RegisterEvents(1);
+}
+
+/*
+ * A full barrier. The interlocked functions behind the SDL atomics are
+ * full barriers with MSVC, but __sync_lock_test_and_set() of GCC isn't.
+ */
+#if defined(__GNUC__)
+#define message_full_barrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define message_full_barrier() SDL_CompilerBarrier()
+#endif
+
+/* Wake up the UI thread if it is waiting for events */
+static void message_wakeup(simulator_context_t* ctx) {
+	/* The message must be visible before the flag is read, see lvgl_runloop() */
+	message_full_barrier();
+	if (ctx->wake_event != (Uint32)-1 && SDL_AtomicCAS(&ctx->wakeup, 0, 1)) {
+		SDL_Event e;
+
+		SDL_zero(e);
+		e.type = ctx->wake_event;
+		SDL_PushEvent(&e);
+	}
+}
+
+static bool message_pending(simulator_context_t* ctx) {
+	simulator_message_t* p = &ctx->ring[ctx->head & ctx->mask];
+	bool pending = (unsigned int)SDL_AtomicGet(&p->seq) == ctx->head + 1;
+
+	SDL_MemoryBarrierAcquire();
+	return pending;
+}
 
-	TAILQ_INIT(&sim_context.pending);
-	TAILQ_INIT(&sim_context.free);
-	for (int i = 0; i < MAX_MESSAGES; i++)
-		TAILQ_INSERT_TAIL(&sim_context.free, &msg_buffer[i], node);
+static bool message_enqueue(simulator_context_t* ctx, lvgl_message_cb_t cb,
+	uint16_t id, void* user) {
+	unsigned int pos = (unsigned int)SDL_AtomicGet(&ctx->tail);
+	simulator_message_t* p;
+
+	for (; ; ) {
+		p = &ctx->ring[pos & ctx->mask];
+		int diff = (int)((unsigned int)SDL_AtomicGet(&p->seq) - pos);
+
+		if (diff == 0) {
+			if (SDL_AtomicCAS(&ctx->tail, (int)pos, (int)(pos + 1)))
+				break;
+			pos = (unsigned int)SDL_AtomicGet(&ctx->tail);
+		} else if (diff < 0) {
+			/* The slot of the previous lap isn't consumed yet */
+			return false;
+		} else {
+			pos = (unsigned int)SDL_AtomicGet(&ctx->tail);
+		}
+	}
+
+	p->message.routine = cb;
+	p->message.id = id;
+	p->message.user = user;
+
+	/* SDL_AtomicSet() is only an acquire barrier, publish the payload first */
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&p->seq, (int)(pos + 1));
+	message_wakeup(ctx);
+	return true;
 }
 
 static void sched_message(void) {
 	simulator_context_t* ctx = &sim_context;
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = SDL_GetPerformanceFrequency() * ctx->budget_ms / 1000;
+	int count = 0;
 
-	if (!TAILQ_EMPTY(&ctx->pending)) {
-		SDL_LockMutex(sim_context.mutex);
-		if (!TAILQ_EMPTY(&ctx->pending)) {
-			simulator_message_t* p = TAILQ_FIRST(&ctx->pending);
+	/* Run the messages in order until the ring is empty or the budget is spent */
+	for (; ; ) {
+		simulator_message_t* p = &ctx->ring[ctx->head & ctx->mask];
+		lvgl_message_t message;
 
-			TAILQ_REMOVE(&ctx->pending, p, node);
-			if (p->message.routine)
-				p->message.routine(&p->message);
+		if ((unsigned int)SDL_AtomicGet(&p->seq) != ctx->head + 1)
+			break;
+		SDL_MemoryBarrierAcquire();
 
-			TAILQ_INSERT_HEAD(&ctx->free, p, node);
-		}
-		SDL_UnlockMutex(sim_context.mutex);
+		/* Copy the payload before the slot is given back to the producers */
+		message = p->message;
+		SDL_MemoryBarrierRelease();
+		SDL_AtomicSet(&p->seq, (int)(ctx->head + ctx->mask + 1));
+		ctx->head++;
+		count++;
+
+		if (message.routine)
+			message.routine(&message);
+
+		if (SDL_GetPerformanceCounter() - start >= budget)
+			break;
+	}
+
+	/* Wake up the senders which are waiting for room */
+	if (count > 0) {
+		int waiters = SDL_AtomicSet(&ctx->waiters, 0);
+		while (waiters-- > 0)
+			SDL_SemPost(ctx->space);
 	}
 }
 
@@ -68,26 +177,82 @@ static bool key_defaultproc(int code, bool pressed) {
 	return true;
 }
 
-int lvgl_send_message(lvgl_message_cb_t cb, uint16_t id, void* user) {
+/* Return false to quit the loop */
+static bool dispatch_event(SDL_Event* e,
+	bool (*key_action)(int code, bool pressed)) {
+	/* Process pointer device input event */
+	lv_sdl_mouse_handler(e);
+
+	/* Quit event */
+	if (e->type == SDL_QUIT)
+		return false;
+
+	/* Keypad input event */
+	if (e->type == SDL_KEYDOWN || e->type == SDL_KEYUP) {
+		if (!key_action(e->key.keysym.sym, e->type == SDL_KEYDOWN))
+			return false;
+	}
+	return true;
+}
+
+static uint32_t elapsed_us(Uint64 from, Uint64 to) {
+	return (uint32_t)((to - from) * 1000000 / SDL_GetPerformanceFrequency());
+}
+
+void lvgl_get_frame_stats(lvgl_frame_stats_t* stats, bool reset) {
+	*stats = sim_context.stats;
+	if (reset)
+		SDL_zero(sim_context.stats);
+}
+
+int lvgl_message_configure(unsigned int capacity, unsigned int budget_ms) {
+	if (capacity == 0 || capacity > (1u << 24))
+		return -EINVAL;
+
+	if (sim_context.ring != NULL)
+		return -EBUSY;
+
+	msg_capacity = capacity;
+	msg_budget_ms = budget_ms;
+	return 0;
+}
+
+int lvgl_post_message(lvgl_message_cb_t cb, uint16_t id, void* user,
+	int timeout_ms) {
 	simulator_context_t* ctx = &sim_context;
-	int err = -ENOMEM;
-
-	if (!TAILQ_EMPTY(&ctx->free)) {
-		SDL_LockMutex(sim_context.mutex);
-		if (!TAILQ_EMPTY(&ctx->free)) {
-			simulator_message_t* p = TAILQ_FIRST(&ctx->free);
-
-			TAILQ_REMOVE(&ctx->free, p, node);
-			p->message.routine = cb;
-			p->message.id = id;
-			p->message.user = user;
-			TAILQ_INSERT_TAIL(&ctx->pending, p, node);
-			err = 0;
+	Uint64 deadline;
+
+	if (ctx->ring == NULL)
+		return -ENOMEM;
+
+	if (message_enqueue(ctx, cb, id, user))
+		return 0;
+
+	deadline = SDL_GetTicks64() + (Uint64)(timeout_ms > 0 ? timeout_ms : 0);
+	while (timeout_ms != 0) {
+		/* Check again after registering, the UI thread may have made room */
+		SDL_AtomicIncRef(&ctx->waiters);
+		if (message_enqueue(ctx, cb, id, user))
+			return 0;
+
+		if (timeout_ms == LVGL_WAIT_FOREVER) {
+			SDL_SemWait(ctx->space);
+		} else {
+			Uint64 now = SDL_GetTicks64();
+			if (now >= deadline)
+				break;
+			SDL_SemWaitTimeout(ctx->space, (Uint32)(deadline - now));
 		}
-		SDL_UnlockMutex(sim_context.mutex);
+
+		if (message_enqueue(ctx, cb, id, user))
+			return 0;
 	}
 
-	return err;
+	return -ENOMEM;
+}
+
+int lvgl_send_message(lvgl_message_cb_t cb, uint16_t id, void* user) {
+	return lvgl_post_message(cb, id, user, 0);
 }
 
 int lvgl_runloop(int hor_res, int ver_res,
@@ -116,31 +281,56 @@ int lvgl_runloop(int hor_res, int ver_res,
 	lv_sdl_mouse_create();
 
 	for (; ; ) {
+		simulator_context_t* ctx = &sim_context;
+		lvgl_frame_stats_t* stats = &ctx->stats;
+		Uint64 start = SDL_GetPerformanceCounter();
+		Uint64 now;
+		uint32_t delay;
 		SDL_Event e;
+		bool running = true;
+		bool woken;
 
-		/* Get input events */
-		if (SDL_PollEvent(&e) != 0) {
-			/* Process pointer device input event */
-			lv_sdl_mouse_handler(&e);
-
-			/* Quit event */
-			if (e.type == SDL_QUIT)
-				break;
-
-			/* Keypad input event */
-			if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP) {
-				if (!key_action(e.key.keysym.sym, e.type == SDL_KEYDOWN))
-					break;
-			}
-		}
+		/* Get all the input events */
+		while (running && SDL_PollEvent(&e) != 0)
+			running = dispatch_event(&e, key_action);
+		if (!running)
+			break;
 
 		/* Process UI message */
 		sched_message();
 
-		/* Refresh UI */
-		lv_timer_handler();
-
-		SDL_Delay(16);
+		/* Refresh UI, it returns the time to the next timer */
+		delay = lv_timer_handler();
+
+		now = SDL_GetPerformanceCounter();
+		stats->last_us = elapsed_us(start, now);
+		if (stats->last_us > stats->max_us)
+			stats->max_us = stats->last_us;
+		stats->busy_us += stats->last_us;
+		stats->frames++;
+
+		/*
+		 * Sleep until the next timer, a posted message wakes up the loop
+		 * with an event. The flag must be cleared before the ring is
+		 * checked, so that a message missed by the check finds the flag
+		 * clear and pushes an event. SDL_AtomicSet() is only an acquire
+		 * barrier with GCC, the load of the ring could pass its store.
+		 * The compare-and-swap is a full barrier. If the flag is clear
+		 * already, there is nothing to order.
+		 */
+		SDL_AtomicCAS(&ctx->wakeup, 1, 0);
+		if (message_pending(ctx) || delay == 0)
+			continue;
+
+		if (delay == LV_NO_TIMER_READY)
+			woken = SDL_WaitEvent(&e) != 0;
+		else
+			woken = SDL_WaitEventTimeout(&e, (int)delay) != 0;
+		stats->idle_us += elapsed_us(now, SDL_GetPerformanceCounter());
+
+		/* Woken up by an event rather than the timeout */
+		if (woken && !dispatch_event(&e, key_action))
+			break;
 	}
 
 	return 0;
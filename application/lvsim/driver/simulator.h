@@ -5,6 +5,7 @@
 #ifndef SIMULATOR_H_
 #define SIMULATOR_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -24,17 +25,54 @@ typedef struct lvgl_message {
 	lvgl_message_cb_t routine;
 } lvgl_message_t;
 
+/*
+ * Time spent by the UI loop, the idle ratio is idle_us / (busy_us + idle_us)
+ */
+typedef struct lvgl_frame_stats {
+	uint32_t frames;
+	uint32_t last_us;  /* Busy time of the last frame */
+	uint32_t max_us;
+	uint64_t busy_us;  /* Events, messages and LVGL timers */
+	uint64_t idle_us;  /* Waiting for the next timer or an event */
+} lvgl_frame_stats_t;
+
 int lvgl_runloop(int hor_res, int ver_res,
 	void (*ui_bringup)(void* param),
 	void* param,
 	bool (*key_action)(int code, bool pressed));
 
+/*
+ * Set the number of messages which can be pending (rounded up to a power
+ * of 2) and the time the UI thread may spend running them in each frame.
+ * It has to be called before lvgl_runloop().
+ */
+int lvgl_message_configure(unsigned int capacity, unsigned int budget_ms);
+
+/*
+ * Post a message to the UI thread, it can be called from any thread.
+ * If the queue is full it waits up to timeout_ms for room (0 returns at once,
+ * LVGL_WAIT_FOREVER blocks) and returns -ENOMEM if there is still none.
+ */
+#define LVGL_WAIT_FOREVER (-1)
+int lvgl_post_message(
+	lvgl_message_cb_t cb,
+	uint16_t id,
+	void* user,
+	int timeout_ms
+);
+
 int lvgl_send_message(
 	lvgl_message_cb_t cb, 
 	uint16_t id, 
 	void* user
 );
 
+/*
+ * Copy the statistics of the UI loop, it should be called by the UI thread
+ * (from a message or a timer).
+ */
+void lvgl_get_frame_stats(lvgl_frame_stats_t* stats, bool reset);
+
 
 /*
  * Configure options  
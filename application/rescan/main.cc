@@ -10,6 +10,7 @@
 #include "base/memory/scoped_ptr.h"
 
 #include "application/rescan/rescan.h"
+#include "application/rescan/scan_cache.h"
 #include "application/rescan/doc_generator.h"
 
 
@@ -27,7 +28,9 @@ int main(int argc, char* argv[]) {
                 "[--compatible_file=project file] "
                 "[--output_dir=output file] "
                 "[--sceen_width=width] "
-                "[--sceen_height=height]\n"
+                "[--sceen_height=height] "
+                "[--no-cache] "
+                "[--rebuild]\n"
                 "Options:\n"
                 "\t--input_dir         Resource directory path\n"
                 "\t--new_entry         New resource directory name\n"
@@ -35,6 +38,8 @@ int main(int argc, char* argv[]) {
                 "\t--output_dir        Output directory path\n"
                 "\t--sceen_width       Screen width\n"
                 "\t--sceen_height      Screen Height\n"
+                "\t--no-cache          Measure all resources without scan cache\n"
+                "\t--rebuild           Discard the scan cache and create it again\n"
             );
             return 0;
         }
@@ -63,7 +68,22 @@ int main(int argc, char* argv[]) {
             entry = cmdline->GetSwitchValueNative("new_entry");
         }
 
+        //The scan cache is saved next to the json document
+        scoped_ptr<app::ScanCache> cache;
+        if (!cmdline->HasSwitch("no-cache")) {
+            FilePath cache_dir(L".");
+            if (compatible)
+                cache_dir = cmdline->GetSwitchValuePath("compatible_file").DirName();
+            else if (cmdline->HasSwitch("output_dir"))
+                cache_dir = cmdline->GetSwitchValuePath("output_dir");
+
+            cache.reset(new app::ScanCache(cache_dir.Append(L"re_scan_cache.json")));
+            if (!cmdline->HasSwitch("rebuild"))
+                cache->Load();
+        }
+
         scoped_refptr<app::ResourceScan> scanner = new app::ResourceScan();
+        scanner->SetCache(cache.get());
         if (scanner->ScanResource(input_dir, entry, compatible)) {
             scoped_refptr<app::UIEditorProject> ui = new app::UIEditorProject(scanner.get(), input_dir);
             FilePath output_file(L"bt_watch.ui");
@@ -94,6 +114,12 @@ int main(int argc, char* argv[]) {
             FilePath json_path(ui->output_path().Append(L"re_doc.json"));
             if (ui->GenerateJsonDoc(*scanner.get(), json_path)) {
                 printf("Generated json-ui document(%s)\n", json_path.AsUTF8Unsafe().c_str());
+                if (cache.get() != nullptr) {
+                    printf("Scan cache: %d hits, %d misses\n",
+                        (int)cache->hits(), (int)cache->misses());
+                    if (!cache->Save())
+                        printf("Failed to save scan cache\n");
+                }
                 okay = ui->GenerateXMLDoc(
                     input_dir.Append(output_file.BaseName().InsertBeforeExtension(L"_autogen")).AsUTF8Unsafe().c_str());
                 return okay ? 0 : -1;
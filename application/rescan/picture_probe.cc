@@ -0,0 +1,150 @@
+/*
+ * Copyright 2025 wtcat 
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+
+#include "application/rescan/picture_probe.h"
+
+namespace app {
+
+namespace {
+
+inline uint32_t LoadBE16(const uint8_t* p) {
+    return ((uint32_t)p[0] << 8) | p[1];
+}
+
+inline uint32_t LoadBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+        ((uint32_t)p[2] << 8) | p[3];
+}
+
+inline uint32_t LoadLE16(const uint8_t* p) {
+    return ((uint32_t)p[1] << 8) | p[0];
+}
+
+inline uint32_t LoadLE32(const uint8_t* p) {
+    return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) |
+        ((uint32_t)p[1] << 8) | p[0];
+}
+
+// PNG: 8 bytes signature followed by the IHDR chunk, which is required
+// to be the first one.
+bool ProbePNG(const uint8_t* hdr, size_t size, int* width, int* height) {
+    static const uint8_t kSignature[8] = {
+        0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+    };
+
+    if (size < 24 || memcmp(hdr, kSignature, sizeof(kSignature)) != 0)
+        return false;
+    if (memcmp(hdr + 12, "IHDR", 4) != 0)
+        return false;
+
+    *width  = (int)LoadBE32(hdr + 16);
+    *height = (int)LoadBE32(hdr + 20);
+    return true;
+}
+
+// BMP: 14 bytes file header followed by the DIB header. The old OS/2
+// BITMAPCOREHEADER stores 16-bit sizes, all the others store 32-bit signed
+// sizes where a negative height means a top-down bitmap.
+bool ProbeBMP(const uint8_t* hdr, size_t size, int* width, int* height) {
+    if (size < 26 || hdr[0] != 'B' || hdr[1] != 'M')
+        return false;
+
+    uint32_t dib_size = LoadLE32(hdr + 14);
+    if (dib_size == 12) {
+        *width  = (int)LoadLE16(hdr + 18);
+        *height = (int)LoadLE16(hdr + 20);
+    } else {
+        int32_t h = (int32_t)LoadLE32(hdr + 22);
+        *width  = (int)(int32_t)LoadLE32(hdr + 18);
+        *height = h < 0 ? -h : h;
+    }
+    return true;
+}
+
+inline bool IsJPEGFrameMarker(int marker) {
+    // SOF0..SOF15 except DHT(C4), JPG(C8) and DAC(CC)
+    return marker >= 0xC0 && marker <= 0xCF &&
+        marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+// JPEG: walk the marker segments until the first start-of-frame, skipping
+// the payload of every other segment with a seek.
+bool ProbeJPEG(FILE* fp, int* width, int* height) {
+    uint8_t buf[8];
+
+    if (fseek(fp, 2, SEEK_SET) != 0)
+        return false;
+
+    for ( ; ; ) {
+        int c = fgetc(fp);
+        if (c != 0xFF)
+            return false;
+
+        // Skip fill bytes
+        do {
+            c = fgetc(fp);
+        } while (c == 0xFF);
+        if (c == EOF)
+            return false;
+
+        // Standalone markers carry no length field
+        if (c == 0x01 || (c >= 0xD0 && c <= 0xD8))
+            continue;
+
+        // End of image or start of scan before any frame header
+        if (c == 0xD9 || c == 0xDA)
+            return false;
+
+        if (fread(buf, 1, 2, fp) != 2)
+            return false;
+
+        uint32_t length = LoadBE16(buf);
+        if (length < 2)
+            return false;
+
+        if (IsJPEGFrameMarker(c)) {
+            // precision(1) height(2) width(2)
+            if (length < 7 || fread(buf, 1, 5, fp) != 5)
+                return false;
+            *height = (int)LoadBE16(buf + 1);
+            *width  = (int)LoadBE16(buf + 3);
+            return true;
+        }
+
+        if (fseek(fp, (long)length - 2, SEEK_CUR) != 0)
+            return false;
+    }
+}
+
+} //namespace
+
+bool ProbePictureSize(const FilePath& path, int* width, int* height) {
+    file_util::ScopedFILE file(file_util::OpenFile(path, "rb"));
+    uint8_t hdr[32];
+
+    if (file.get() == nullptr)
+        return false;
+
+    size_t size = fread(hdr, 1, sizeof(hdr), file.get());
+    if (size < 4)
+        return false;
+
+    if (hdr[0] == 0x89)
+        return ProbePNG(hdr, size, width, height);
+    if (hdr[0] == 'B')
+        return ProbeBMP(hdr, size, width, height);
+    if (hdr[0] == 0xFF && hdr[1] == 0xD8)
+        return ProbeJPEG(file.get(), width, height);
+
+    return false;
+}
+
+} //namespace app
@@ -0,0 +1,19 @@
+/*
+ * Copyright 2025 wtcat 
+ */
+#ifndef PICTURE_PROBE_H_
+#define PICTURE_PROBE_H_
+
+class FilePath;
+
+namespace app {
+
+// Reads the pixel dimensions of a PNG, JPEG or BMP picture by parsing only
+// its header (PNG IHDR, JPEG SOFn, BMP info header). The bitmap itself is
+// never decoded. Returns false when the file can not be opened or its format
+// is not recognised, callers may then fall back to a full decoder.
+bool ProbePictureSize(const FilePath& path, int* width, int* height);
+
+} //namespace app
+
+#endif /* PICTURE_PROBE_H_ */
@@ -8,10 +8,13 @@
 #include "base/file_path.h"
 #include "base/file_util.h"
 #include "base/bind.h"
-#include "base/threading/simple_thread.h"
+#include "base/sys_info.h"
+#include "base/threading/work_stealing_thread_pool.h"
 
 #include <opencv2/opencv.hpp>
 #include "application/rescan/rescan.h"
+#include "application/rescan/picture_probe.h"
+#include "application/rescan/scan_cache.h"
 #include "application/helper/helper.h"
 
 
@@ -19,22 +22,6 @@ namespace app {
 
 namespace fs = std::filesystem;
 
-class PictureParser : public base::DelegateSimpleThreadPool::Delegate {
-public:
-    friend class ResourceScan;
-    PictureParser(ResourceScan *cls, ResourceScan::ViewResource* view) :
-        view_ptr_(view), cls_(cls) {}
-
-    void Run() override {
-        cls_->ForeachViewPicture(view_ptr_, 
-            base::Bind(&ResourceScan::FixPicture, cls_));
-        delete this;
-    }
-private:
-    ResourceScan::ViewResource* view_ptr_;
-    ResourceScan* cls_;
-};
-
 //Class ResourceScan
 ResourceScan::~ResourceScan() {
     DLOG(INFO) << "Completed\n";
@@ -64,24 +51,27 @@ bool ResourceScan::ScanResource(const FilePath& dir, const FilePath::StringType
 }
 
 bool ResourceScan::Scan(const FilePath& path) {
+    enum { MAX_PENDING_PER_CPU = 64 };
+
     //Check whether the resource path is valid
     if (!CheckPath(path)) {
         printf("Invalid resource directory(%s)\n", path.AsUTF8Unsafe().c_str());
         return false;
     }
 
-    //Walk around the directory by recursive
-    if (!ScanDirectory(path))
-        return false;
-
-    //Fix picture parameters
-    base::DelegateSimpleThreadPool thread_pool("pictures", 4);
+    //Walk around the directory on all processors. Each view directory is
+    //scanned by one task and each picture is measured by another one, views
+    //and groups are still appended in directory order.
+    base::WorkStealingThreadPool thread_pool("rescan", 0,
+        base::SysInfo::NumberOfProcessors() * MAX_PENDING_PER_CPU);
+    pool_ = &thread_pool;
+    scan_failed_ = false;
     thread_pool.Start();
-    for (auto iter : views_)
-        thread_pool.AddWork(new PictureParser(this, iter.get()));
+    bool okay = ScanDirectory(path, LEVEL_RESOURCE, nullptr, nullptr);
     thread_pool.JoinAll();
+    pool_ = nullptr;
 
-    return true;
+    return okay && !scan_failed_;
 }
 
 bool ResourceScan::CheckPath(const FilePath& dir) {
@@ -104,32 +94,41 @@ bool ResourceScan::CheckPath(const FilePath& dir) {
     return false;
 }
 
-bool ResourceScan::ScanDirectory(const FilePath& dir) {
+void ResourceScan::ScanView(const FilePath& dir, scoped_refptr<ViewResource> view) {
+    if (!ScanDirectory(dir, LEVEL_VIEW, view.get(), nullptr))
+        scan_failed_ = true;
+}
+
+bool ResourceScan::ScanDirectory(const FilePath& dir, int depth,
+    ViewResource* view, PictureGroup* group) {
     const fs::path root_path(dir.MaybeAsASCII());
 
     //Limited max path deepth
-    if (path_depth_ == LEVEL_MAX)
+    if (depth > LEVEL_MAX)
         return true;
 
-    //Add path depth counter
-    ++path_depth_;
-
     for (const auto& entry : fs::directory_iterator(root_path)) {
         if (fs::is_directory(entry)) {
-            if (path_depth_ == LEVEL_RESOURCE) {
-                //Create a new view
+            FilePath subdir = FilePath::FromUTF8Unsafe(entry.path().string());
+
+            if (depth == LEVEL_RESOURCE) {
+                //Create a new view and scan it in the thread pool
                 scoped_refptr<ViewResource> viewptr = new ViewResource(entry.path().filename().string());
                 views_.push_back(viewptr);
-                current_ = viewptr.get();
-            } else if (path_depth_ == LEVEL_VIEW) {
+                pool_->PostTask(base::Bind(&ResourceScan::ScanView, base::Unretained(this),
+                    subdir, viewptr));
+                continue;
+            }
+
+            if (depth == LEVEL_VIEW) {
                 //Create a picture group
-                scoped_refptr<PictureGroup> group = new PictureGroup(entry.path().filename().string());
-                current_->groups.push_back(group);
-                current_group_ = group.get();
+                scoped_refptr<PictureGroup> grpptr = new PictureGroup(entry.path().filename().string());
+                view->groups.push_back(grpptr);
+                group = grpptr.get();
             }
 
             //Scan the directory recursive
-            if (!ScanDirectory(FilePath::FromUTF8Unsafe(entry.path().string())))
+            if (!ScanDirectory(subdir, depth + 1, view, group))
                 return false;
      
         } else if (fs::is_regular_file(entry)) {
@@ -141,7 +140,7 @@ bool ResourceScan::ScanDirectory(const FilePath& dir) {
             else
                 file_realpath = entry.path();
 
-            if (path_depth_ == LEVEL_RESOURCE) {
+            if (depth == LEVEL_RESOURCE) {
                 if (file_realpath.filename() == "@view")
                     continue;
 
@@ -149,36 +148,43 @@ bool ResourceScan::ScanDirectory(const FilePath& dir) {
                 if (file_realpath.filename().extension() == ".xls")
                     string_file_ = FilePath::FromUTF8Unsafe(file_realpath.string());
 
-            } else if (path_depth_ >= LEVEL_VIEW) {
-                DCHECK(current_ != nullptr);
+            } else if (depth >= LEVEL_VIEW) {
+                DCHECK(view != nullptr);
                 std::string path_ext = file_realpath.filename().extension().string();
                 FilePath filepath = FilePath::FromUTF8Unsafe(file_realpath.string());
 
                 if (IsPicture(path_ext)) {
-                    if (path_depth_ == LEVEL_VIEW)
-                        current_->pictures.push_back(new Picture(filepath));
+                    scoped_refptr<Picture> picture = new Picture(filepath);
+                    if (depth == LEVEL_VIEW)
+                        view->pictures.push_back(picture);
                     else
-                        current_group_->pictures.push_back(new Picture(filepath));
+                        group->pictures.push_back(picture);
+
+                    //Measure it in the thread pool unless it is cached
+                    if (cache_ == nullptr ||
+                        !cache_->LookupPicture(filepath, &picture->width, &picture->height))
+                        pool_->PostTask(base::Bind(&ResourceScan::FixPicture,
+                            base::Unretained(this), picture));
                 } else if (file_realpath.filename().string() == "@STR.txt") {
                     //Load and parse string from text file
-                    ParserString(filepath);
+                    ParserString(filepath, view);
                 }
-            } else {
-                DCHECK(current_ != nullptr);
             }
         }
     }
 
-    //Restore path depth counter
-    --path_depth_;
-
     return true;
 }
 
-bool ResourceScan::ParserString(const FilePath& file) {
+bool ResourceScan::ParserString(const FilePath& file, ViewResource* view) {
     enum { BUFFER_SIZE = 1024 };
+    //Reuse the strings of an unchanged file
+    if (cache_ != nullptr && cache_->LookupStrings(file, &view->strings))
+        return true;
+
     TextLineReader text_lines(file);
     scoped_ptr<char> line_buffer(new char[BUFFER_SIZE]);
+    size_t first = view->strings.size();
 
     for (size_t n = 0; n < text_lines.size(); n++) {
         const char* src = text_lines[n];
@@ -225,7 +231,7 @@ bool ResourceScan::ParserString(const FilePath& file) {
                     text.get()->font_height = atoi(p);
                     if (alias != nullptr)
                         text.get()->alias.append(alias);
-                    current_->strings.push_back(text);
+                    view->strings.push_back(text);
                     okay = true;
                     break;
                 }
@@ -239,26 +245,27 @@ bool ResourceScan::ParserString(const FilePath& file) {
         }
     }
 
-    return true;
-}
-
-void ResourceScan::ForeachViewPicture(const ViewResource* view,
-    base::Callback<void(scoped_refptr<Picture>)>&& callback) {
-    for (auto iter : view->pictures)
-        callback.Run(iter);
-
-    for (auto group : view->groups) {
-        for (auto iter : group->pictures)
-            callback.Run(iter);
+    if (cache_ != nullptr) {
+        cache_->UpdateStrings(file, view->strings.begin() + first,
+            view->strings.end());
     }
+
+    return true;
 }
 
 void ResourceScan::FixPicture(scoped_refptr<Picture> iter) {
-    cv::Mat img = cv::imread(iter->path.AsUTF8Unsafe());
-    if (!img.empty()) {
+    //Read the size from picture header, decode it only for unknown format
+    if (!ProbePictureSize(iter->path, &iter->width, &iter->height)) {
+        cv::Mat img = cv::imread(iter->path.AsUTF8Unsafe());
+        if (img.empty())
+            return;
+
         iter->width  = img.cols;
         iter->height = img.rows;
     }
+
+    if (cache_ != nullptr)
+        cache_->UpdatePicture(iter->path, iter->width, iter->height);
 }
 
 } //namespace app
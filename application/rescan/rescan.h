@@ -5,6 +5,7 @@
 #ifndef RESCAN_H_
 #define RESCAN_H_
 
+#include <atomic>
 #include <vector>
 #include <string>
 
@@ -13,8 +14,14 @@
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
 
+namespace base {
+class WorkStealingThreadPool;
+} //namespace base
+
 namespace app {
 
+class ScanCache;
+
 class TextLineReader {
 public:
     TextLineReader(const FilePath &file): line_count_(0) {
@@ -114,7 +121,6 @@ private:
 
 class ResourceScan : public base::RefCountedThreadSafe<ResourceScan> {
 public:
-    friend class PictureParser;
     enum {
         LEVEL_RESOURCE = 1,
         LEVEL_VIEW,
@@ -161,11 +167,15 @@ public:
         std::vector<scoped_refptr<PictureGroup>> groups;
     };
 
-    ResourceScan(): path_depth_(0) { 
+    ResourceScan(): cache_(nullptr), pool_(nullptr), scan_failed_(false) { 
         views_.reserve(10); 
     }
     ~ResourceScan();
 
+    //Reuse results of unchanged files from |cache|, it may be null
+    void SetCache(ScanCache* cache) {
+        cache_ = cache;
+    }
     bool ScanResource(const FilePath& dir, const FilePath::StringType &name, bool compatible);
     template<typename Function>
     void ForeachView(base::Callback<Function>&& callback) const {
@@ -201,21 +211,21 @@ private:
         char* end;
     };
     bool Scan(const FilePath& dir);
-    void ForeachViewPicture(const ViewResource* view,
-        base::Callback<void(scoped_refptr<Picture>)>&& callback);
     bool CheckPath(const FilePath& dir);
-    bool ScanDirectory(const FilePath& dir);
-    bool ParserString(const FilePath& file);
+    void ScanView(const FilePath& dir, scoped_refptr<ViewResource> view);
+    bool ScanDirectory(const FilePath& dir, int depth, ViewResource* view,
+        PictureGroup* group);
+    bool ParserString(const FilePath& file, ViewResource* view);
     bool IsPicture(const std::string& extname);
     void FixPicture(scoped_refptr<Picture> iter);
 
 private:
     std::vector<scoped_refptr<ViewResource>> views_;
-    ViewResource* current_;
-    PictureGroup* current_group_;
     FilePath string_file_;
     FilePath resource_rootpath_;
-    int path_depth_;
+    ScanCache* cache_;
+    base::WorkStealingThreadPool* pool_;
+    std::atomic<bool> scan_failed_;
 };
 
 } //namespace app
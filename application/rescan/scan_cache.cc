@@ -0,0 +1,244 @@
+/*
+ * Copyright 2025 wtcat 
+ */
+
+#include "base/logging.h"
+#include "base/file_util.h"
+#include "base/md5.h"
+#include "base/platform_file.h"
+#include "base/values.h"
+#include "base/string_number_conversions.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/json/json_file_value_serializer.h"
+
+#include "application/rescan/scan_cache.h"
+
+namespace app {
+
+namespace {
+const char kCacheSignature[] = "ResourceScanCache";
+const int  kCacheVersion = 1;
+} //namespace
+
+//Class ScanCache
+ScanCache::ScanCache(const FilePath& file) : 
+    file_(file), hits_(0), misses_(0) {
+}
+
+ScanCache::~ScanCache() {
+}
+
+bool ScanCache::Load() {
+    if (!file_util::PathExists(file_))
+        return true;
+
+    JSONFileValueSerializer json(file_);
+    scoped_ptr<base::Value> value(json.Deserialize(nullptr, nullptr));
+    base::DictionaryValue* root;
+    if (value.get() == nullptr || !value->GetAsDictionary(&root)) {
+        DLOG(WARNING) << "Invalid scan cache: " << file_.AsUTF8Unsafe();
+        return false;
+    }
+
+    std::string signature;
+    int version;
+    if (!root->GetString("signature", &signature) || signature != kCacheSignature ||
+        !root->GetInteger("version", &version) || version != kCacheVersion)
+        return true;
+
+    base::DictionaryValue* files;
+    if (!root->GetDictionaryWithoutPathExpansion("files", &files))
+        return true;
+
+    base::AutoLock locker(lock_);
+    for (base::DictionaryValue::Iterator iter(*files); iter.HasNext(); iter.Advance()) {
+        const base::DictionaryValue* item;
+        std::string size, mtime;
+        Entry entry;
+
+        if (!iter.value().GetAsDictionary(&item))
+            continue;
+        if (!item->GetString("size", &size) || !base::StringToInt64(size, &entry.size) ||
+            !item->GetString("mtime", &mtime) || !base::StringToInt64(mtime, &entry.mtime) ||
+            !item->GetString("hash", &entry.hash))
+            continue;
+
+        item->GetInteger("width", &entry.width);
+        item->GetInteger("height", &entry.height);
+
+        const base::ListValue* strings;
+        if (item->GetListWithoutPathExpansion("strings", &strings)) {
+            for (size_t i = 0; i < strings->GetSize(); i++) {
+                const base::DictionaryValue* str;
+                TextEntry text;
+                if (!strings->GetDictionary(i, &str) ||
+                    !str->GetString("text", &text.text) ||
+                    !str->GetInteger("font_height", &text.font_height))
+                    continue;
+                str->GetString("alias", &text.alias);
+                entry.strings.push_back(text);
+            }
+        }
+
+        entries_[iter.key()] = entry;
+    }
+
+    return true;
+}
+
+bool ScanCache::Save() {
+    scoped_ptr<base::DictionaryValue> root(new base::DictionaryValue);
+    base::DictionaryValue* files = new base::DictionaryValue;
+
+    root->SetString("signature", kCacheSignature);
+    root->SetInteger("version", kCacheVersion);
+    root->SetWithoutPathExpansion("files", files);
+
+    base::AutoLock locker(lock_);
+    for (const auto& iter : entries_) {
+        const Entry& entry = iter.second;
+        if (!entry.used)
+            continue;
+
+        base::DictionaryValue* item = new base::DictionaryValue;
+        item->SetString("size", base::Int64ToString(entry.size));
+        item->SetString("mtime", base::Int64ToString(entry.mtime));
+        item->SetString("hash", entry.hash);
+        if (entry.width >= 0) {
+            item->SetInteger("width", entry.width);
+            item->SetInteger("height", entry.height);
+        }
+        if (!entry.strings.empty()) {
+            base::ListValue* strings = new base::ListValue;
+            item->SetWithoutPathExpansion("strings", strings);
+            for (const auto& text : entry.strings) {
+                base::DictionaryValue* str = new base::DictionaryValue;
+                str->SetString("text", text.text);
+                str->SetInteger("font_height", text.font_height);
+                if (!text.alias.empty())
+                    str->SetString("alias", text.alias);
+                strings->Append(str);
+            }
+        }
+        files->SetWithoutPathExpansion(iter.first, item);
+    }
+
+    JSONFileValueSerializer json(file_);
+    return json.Serialize(*root.get());
+}
+
+bool ScanCache::LookupPicture(const FilePath& path, int* width, int* height) {
+    Entry entry;
+    if (!Lookup(path, &entry) || entry.width < 0)
+        return false;
+
+    *width  = entry.width;
+    *height = entry.height;
+    return true;
+}
+
+void ScanCache::UpdatePicture(const FilePath& path, int width, int height) {
+    Entry entry;
+    entry.width  = width;
+    entry.height = height;
+    Update(path, &entry);
+}
+
+bool ScanCache::LookupStrings(const FilePath& path, TextList* strings) {
+    Entry entry;
+    if (!Lookup(path, &entry))
+        return false;
+
+    for (const auto& iter : entry.strings) {
+        scoped_refptr<ResourceScan::Text> text(new ResourceScan::Text(iter.text.c_str()));
+        text->alias = iter.alias;
+        text->font_height = iter.font_height;
+        strings->push_back(text);
+    }
+    return true;
+}
+
+void ScanCache::UpdateStrings(const FilePath& path, TextList::const_iterator first,
+    TextList::const_iterator last) {
+    Entry entry;
+    for ( ; first != last; ++first) {
+        TextEntry text;
+        text.text = (*first)->text;
+        text.alias = (*first)->alias;
+        text.font_height = (*first)->font_height;
+        entry.strings.push_back(text);
+    }
+    Update(path, &entry);
+}
+
+bool ScanCache::GetStat(const FilePath& path, int64* size, int64* mtime) {
+    base::PlatformFileInfo info;
+    if (!file_util::GetFileInfo(path, &info))
+        return false;
+
+    *size  = info.size;
+    *mtime = info.last_modified.ToInternalValue();
+    return true;
+}
+
+bool ScanCache::GetHash(const FilePath& path, std::string* hash) {
+    std::string contents;
+    if (!file_util::ReadFileToString(path, &contents))
+        return false;
+
+    base::MD5Digest digest;
+    base::MD5Sum(contents.data(), contents.size(), &digest);
+    *hash = base::MD5DigestToBase16(digest);
+    return true;
+}
+
+bool ScanCache::Lookup(const FilePath& path, Entry* entry) {
+    const std::string key(path.AsUTF8Unsafe());
+    int64 size, mtime;
+
+    if (!GetStat(path, &size, &mtime))
+        return false;
+
+    {
+        base::AutoLock locker(lock_);
+        auto iter = entries_.find(key);
+        if (iter == entries_.end() || iter->second.size != size) {
+            misses_++;
+            return false;
+        }
+        if (iter->second.mtime == mtime) {
+            iter->second.used = true;
+            *entry = iter->second;
+            hits_++;
+            return true;
+        }
+        *entry = iter->second;
+    }
+
+    // The file was touched, compare the content before giving up
+    std::string hash;
+    if (!GetHash(path, &hash) || hash != entry->hash) {
+        base::AutoLock locker(lock_);
+        misses_++;
+        return false;
+    }
+
+    base::AutoLock locker(lock_);
+    Entry& cached = entries_[key];
+    cached.mtime = mtime;
+    cached.used = true;
+    hits_++;
+    return true;
+}
+
+void ScanCache::Update(const FilePath& path, Entry* entry) {
+    if (!GetStat(path, &entry->size, &entry->mtime) ||
+        !GetHash(path, &entry->hash))
+        return;
+
+    base::AutoLock locker(lock_);
+    entry->used = true;
+    entries_[path.AsUTF8Unsafe()] = *entry;
+}
+
+} //namespace app
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 wtcat 
+ */
+#ifndef SCAN_CACHE_H_
+#define SCAN_CACHE_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "base/basictypes.h"
+#include "base/file_path.h"
+#include "base/synchronization/lock.h"
+
+#include "application/rescan/rescan.h"
+
+namespace app {
+
+//Class ScanCache
+// Persistent record of the files measured by ResourceScan. Every entry is
+// keyed by the file path and remembers the size, modification time and
+// content hash of the file together with the measured result (picture size
+// or the strings parsed from @STR.txt). An entry is reused when size and
+// mtime still match, or when only the mtime changed but the content hash
+// is the same. Lookup and update may be called from worker threads.
+class ScanCache {
+public:
+    using TextList = std::vector<scoped_refptr<ResourceScan::Text>>;
+
+    explicit ScanCache(const FilePath& file);
+    ~ScanCache();
+
+    // Load entries from the cache file. A missing or incompatible file is
+    // not an error, the cache just starts empty.
+    bool Load();
+
+    // Write all entries that were looked up or updated in this run back
+    // to the cache file. Entries of removed files are dropped.
+    bool Save();
+
+    bool LookupPicture(const FilePath& path, int* width, int* height);
+    void UpdatePicture(const FilePath& path, int width, int height);
+
+    // Append the cached strings of |path| to |strings|
+    bool LookupStrings(const FilePath& path, TextList* strings);
+    void UpdateStrings(const FilePath& path, TextList::const_iterator first,
+        TextList::const_iterator last);
+
+    size_t hits() const {
+        return hits_;
+    }
+    size_t misses() const {
+        return misses_;
+    }
+
+private:
+    struct TextEntry {
+        std::string text;
+        std::string alias;
+        int font_height;
+    };
+    struct Entry {
+        Entry() : size(0), mtime(0), width(-1), height(-1), used(false) {}
+        int64 size;
+        int64 mtime;
+        std::string hash;
+        int width;
+        int height;
+        std::vector<TextEntry> strings;
+        bool used;
+    };
+
+    static bool GetStat(const FilePath& path, int64* size, int64* mtime);
+    static bool GetHash(const FilePath& path, std::string* hash);
+
+    bool Lookup(const FilePath& path, Entry* entry);
+    void Update(const FilePath& path, Entry* entry);
+
+private:
+    base::Lock lock_;
+    std::unordered_map<std::string, Entry> entries_;
+    FilePath file_;
+    size_t hits_;
+    size_t misses_;
+};
+
+} //namespace app
+
+#endif /* SCAN_CACHE_H_ */
@@ -41,6 +41,20 @@ inline int Log2Ceiling(uint32 n) {
   }
 }
 
+// Returns the index of the lowest set bit of n, which must not be 0.
+inline int CountTrailingZeros64(uint64 n) {
+  DCHECK_NE(n, 0u);
+#if defined(COMPILER_GCC)
+  return __builtin_ctzll(n);
+#else
+  uint64 lowest = n & (~n + 1);
+  uint32 low = static_cast<uint32>(lowest);
+  if (low)
+    return Log2Floor(low);
+  return 32 + Log2Floor(static_cast<uint32>(lowest >> 32));
+#endif
+}
+
 }  // namespace bits
 }  // namespace base
 
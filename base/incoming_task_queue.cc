@@ -0,0 +1,82 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/incoming_task_queue.h"
+
+#include <utility>
+
+namespace base {
+
+struct IncomingTaskQueue::Node {
+  explicit Node(PendingTask* pending_task)
+      : task(std::move(*pending_task)),
+        next(NULL) {
+  }
+
+  PendingTask task;
+  Node* next;
+};
+
+IncomingTaskQueue::IncomingTaskQueue() : head_(NULL) {
+}
+
+IncomingTaskQueue::~IncomingTaskQueue() {
+  Node* node = head_.exchange(NULL, std::memory_order_acquire);
+  while (node != NULL && node != awake_marker()) {
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+bool IncomingTaskQueue::Push(PendingTask* pending_task) {
+  Node* node = new Node(pending_task);
+  Node* head = head_.load(std::memory_order_relaxed);
+  do {
+    node->next = head;
+  } while (!head_.compare_exchange_weak(head, node,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+
+  // |head| is what the list was before, only an empty list means that the
+  // owner may sleep.
+  return head == NULL;
+}
+
+bool IncomingTaskQueue::ReloadWorkQueue(TaskQueue* work_queue) {
+  Node* list = head_.exchange(awake_marker(), std::memory_order_acquire);
+  if (list == NULL || list == awake_marker()) {
+    // Nothing was posted, the owner may sleep unless a task comes in before
+    // NULL is back.
+    Node* expected = awake_marker();
+    if (head_.compare_exchange_strong(expected, NULL,
+                                      std::memory_order_acq_rel))
+      return false;
+    list = head_.exchange(awake_marker(), std::memory_order_acquire);
+  }
+
+  // The list is newest first.
+  Node* reversed = NULL;
+  while (list != NULL && list != awake_marker()) {
+    Node* next = list->next;
+    list->next = reversed;
+    reversed = list;
+    list = next;
+  }
+
+  while (reversed != NULL) {
+    Node* next = reversed->next;
+    work_queue->push(std::move(reversed->task));
+    delete reversed;
+    reversed = next;
+  }
+  return true;
+}
+
+bool IncomingTaskQueue::empty() const {
+  Node* head = head_.load(std::memory_order_acquire);
+  return head == NULL || head == awake_marker();
+}
+
+}  // namespace base
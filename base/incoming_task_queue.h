@@ -0,0 +1,73 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// IncomingTaskQueue carries PendingTasks from any number of threads to the
+// one thread which runs them, without a lock.  Posters push their node onto
+// an atomic singly linked list with a single compare-and-swap, the owner
+// takes the whole list with one exchange and reverses it into a TaskQueue.
+//
+// The list also tells the posters whether the owner has to be woken up.
+// While the owner is taking tasks the head of the list points to a marker
+// instead of NULL, so tasks posted meanwhile are picked up by its next
+// ReloadWorkQueue() and don't need a wake up.  The owner puts NULL back
+// only when it finds the list empty, right before it may go to sleep; the
+// first task posted after that asks for a wake up.
+//
+// Example:
+//
+//   // Any thread.
+//   if (incoming_queue.Push(&pending_task))
+//     pump->ScheduleWork();
+//
+//   // Owner thread.
+//   incoming_queue.ReloadWorkQueue(&work_queue);
+
+#ifndef BASE_INCOMING_TASK_QUEUE_H_
+#define BASE_INCOMING_TASK_QUEUE_H_
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/pending_task.h"
+
+namespace base {
+
+class BASE_EXPORT IncomingTaskQueue {
+ public:
+  IncomingTaskQueue();
+
+  // Deletes the tasks which were never taken.
+  ~IncomingTaskQueue();
+
+  // Moves |pending_task| in.  Safe to call from any thread.  Returns true if
+  // the owner may be sleeping and needs a wake up.  The queue isn't touched
+  // after the compare-and-swap which publishes the task, so the owner is
+  // free to delete it as soon as the task can run.
+  bool Push(PendingTask* pending_task);
+
+  // Owner thread only.  Appends all the queued tasks to |work_queue| in the
+  // order they were pushed.  Returns false if there were none, then the next
+  // Push() asks for a wake up.
+  bool ReloadWorkQueue(TaskQueue* work_queue);
+
+  // True if no task is queued.  The result may be stale as soon as it
+  // returns unless it is called by the owner and nothing is posted anymore.
+  bool empty() const;
+
+ private:
+  struct Node;
+
+  // The head of the list while the owner is taking tasks.  It ends the list
+  // like NULL and is never dereferenced.
+  static Node* awake_marker() { return reinterpret_cast<Node*>(1); }
+
+  std::atomic<Node*> head_;
+
+  DISALLOW_COPY_AND_ASSIGN(IncomingTaskQueue);
+};
+
+}  // namespace base
+
+#endif  // BASE_INCOMING_TASK_QUEUE_H_
@@ -225,25 +225,7 @@ Value* JSONParser::Parse(const StringPiece& input) {
   } else {
     start_pos_ = input.data();
   }
-  pos_ = start_pos_;
-  end_pos_ = start_pos_ + input.length();
-  index_ = 0;
-  line_number_ = 1;
-  index_last_line_ = 0;
-
-  error_code_ = JSONReader::JSON_NO_ERROR;
-  error_line_ = 0;
-  error_column_ = 0;
-
-  // When the input JSON string starts with a UTF-8 Byte-Order-Mark
-  // <0xEF 0xBB 0xBF>, advance the start position to avoid the
-  // ParseNextToken function mis-treating a Unicode BOM as an invalid
-  // character and returning NULL.
-  if (CanConsume(3) && static_cast<uint8>(*pos_) == 0xEF &&
-      static_cast<uint8>(*(pos_ + 1)) == 0xBB &&
-      static_cast<uint8>(*(pos_ + 2)) == 0xBF) {
-    NextNChars(3);
-  }
+  Reset(start_pos_, input.length());
 
   // Parse the first and any nested tokens.
   scoped_ptr<Value> root(ParseNextToken());
@@ -251,12 +233,8 @@ Value* JSONParser::Parse(const StringPiece& input) {
     return NULL;
 
   // Make sure the input stream is at an end.
-  if (GetNextToken() != T_END_OF_INPUT) {
-    if (!CanConsume(1) || (NextChar() && GetNextToken() != T_END_OF_INPUT)) {
-      ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
-      return NULL;
-    }
-  }
+  if (!CheckEndOfInput())
+    return NULL;
 
   // Dictionaries and lists can contain JSONStringValues, so wrap them in a
   // hidden root.
@@ -277,6 +255,13 @@ Value* JSONParser::Parse(const StringPiece& input) {
   return root.release();
 }
 
+bool JSONParser::Parse(const StringPiece& input, JSONSaxHandler* handler) {
+  // Strings are handed out as pieces of |input| and only live for the duration
+  // of the callback, so the input never needs to be copied.
+  Reset(input.data(), input.length());
+  return EmitNextToken(handler) && CheckEndOfInput();
+}
+
 JSONReader::JsonParseError JSONParser::error_code() const {
   return error_code_;
 }
@@ -347,8 +332,48 @@ const std::string& JSONParser::StringBuilder::AsString() {
   return *string_;
 }
 
+StringPiece JSONParser::StringBuilder::Contents() {
+  if (string_)
+    return StringPiece(*string_);
+  return StringPiece(pos_, length_);
+}
+
 // JSONParser private //////////////////////////////////////////////////////////
 
+void JSONParser::Reset(const char* start, size_t length) {
+  start_pos_ = start;
+  pos_ = start_pos_;
+  end_pos_ = start_pos_ + length;
+  index_ = 0;
+  stack_depth_ = 0;
+  line_number_ = 1;
+  index_last_line_ = 0;
+
+  error_code_ = JSONReader::JSON_NO_ERROR;
+  error_line_ = 0;
+  error_column_ = 0;
+
+  // When the input JSON string starts with a UTF-8 Byte-Order-Mark
+  // <0xEF 0xBB 0xBF>, advance the start position to avoid the
+  // ParseNextToken function mis-treating a Unicode BOM as an invalid
+  // character and returning NULL.
+  if (CanConsume(3) && static_cast<uint8>(*pos_) == 0xEF &&
+      static_cast<uint8>(*(pos_ + 1)) == 0xBB &&
+      static_cast<uint8>(*(pos_ + 2)) == 0xBF) {
+    NextNChars(3);
+  }
+}
+
+bool JSONParser::CheckEndOfInput() {
+  if (GetNextToken() != T_END_OF_INPUT) {
+    if (!CanConsume(1) || (NextChar() && GetNextToken() != T_END_OF_INPUT)) {
+      ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
+      return false;
+    }
+  }
+  return true;
+}
+
 inline bool JSONParser::CanConsume(int length) {
   return pos_ + length <= end_pos_;
 }
@@ -592,6 +617,137 @@ Value* JSONParser::ConsumeList() {
   return list.release();
 }
 
+bool JSONParser::EmitNextToken(JSONSaxHandler* handler) {
+  return EmitToken(GetNextToken(), handler);
+}
+
+bool JSONParser::EmitToken(Token token, JSONSaxHandler* handler) {
+  switch (token) {
+    case T_OBJECT_BEGIN:
+      return EmitDictionary(handler);
+    case T_ARRAY_BEGIN:
+      return EmitList(handler);
+    case T_STRING: {
+      StringBuilder string;
+      if (!ConsumeStringRaw(&string))
+        return false;
+      return handler->String(string.Contents());
+    }
+    case T_NUMBER: {
+      StringPiece number;
+      if (!ConsumeNumberRaw(&number))
+        return false;
+      return handler->Number(number);
+    }
+    case T_BOOL_TRUE:
+      return ConsumeLiteralRaw("true") && handler->Boolean(true);
+    case T_BOOL_FALSE:
+      return ConsumeLiteralRaw("false") && handler->Boolean(false);
+    case T_NULL:
+      return ConsumeLiteralRaw("null") && handler->Null();
+    default:
+      ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+      return false;
+  }
+}
+
+bool JSONParser::EmitDictionary(JSONSaxHandler* handler) {
+  if (*pos_ != '{') {
+    ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+    return false;
+  }
+
+  StackMarker depth_check(&stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 1);
+    return false;
+  }
+
+  if (!handler->StartObject())
+    return false;
+
+  NextChar();
+  Token token = GetNextToken();
+  while (token != T_OBJECT_END) {
+    if (token != T_STRING) {
+      ReportError(JSONReader::JSON_UNQUOTED_DICTIONARY_KEY, 1);
+      return false;
+    }
+
+    StringBuilder key;
+    if (!ConsumeStringRaw(&key))
+      return false;
+    if (!handler->Key(key.Contents()))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token != T_OBJECT_PAIR_SEPARATOR) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+      return false;
+    }
+
+    NextChar();
+    if (!EmitNextToken(handler))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      NextChar();
+      token = GetNextToken();
+      if (token == T_OBJECT_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+        return false;
+      }
+    } else if (token != T_OBJECT_END) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 0);
+      return false;
+    }
+  }
+
+  return handler->EndObject();
+}
+
+bool JSONParser::EmitList(JSONSaxHandler* handler) {
+  if (*pos_ != '[') {
+    ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+    return false;
+  }
+
+  StackMarker depth_check(&stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 1);
+    return false;
+  }
+
+  if (!handler->StartArray())
+    return false;
+
+  NextChar();
+  Token token = GetNextToken();
+  while (token != T_ARRAY_END) {
+    if (!EmitToken(token, handler))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      NextChar();
+      token = GetNextToken();
+      if (token == T_ARRAY_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+        return false;
+      }
+    } else if (token != T_ARRAY_END) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+      return false;
+    }
+  }
+
+  return handler->EndArray();
+}
+
 Value* JSONParser::ConsumeString() {
   StringBuilder string;
   if (!ConsumeStringRaw(&string))
@@ -811,7 +967,7 @@ void JSONParser::DecodeUTF8(const int32& point, StringBuilder* dest) {
   }
 }
 
-Value* JSONParser::ConsumeNumber() {
+bool JSONParser::ConsumeNumberRaw(StringPiece* out) {
   const char* num_start = pos_;
   const int start_index = index_;
   int end_index = start_index;
@@ -821,7 +977,7 @@ Value* JSONParser::ConsumeNumber() {
 
   if (!ReadInt(false)) {
     ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-    return NULL;
+    return false;
   }
   end_index = index_;
 
@@ -829,12 +985,12 @@ Value* JSONParser::ConsumeNumber() {
   if (*pos_ == '.') {
     if (!CanConsume(1)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     NextChar();
     if (!ReadInt(true)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     end_index = index_;
   }
@@ -846,7 +1002,7 @@ Value* JSONParser::ConsumeNumber() {
       NextChar();
     if (!ReadInt(true)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     end_index = index_;
   }
@@ -866,13 +1022,20 @@ Value* JSONParser::ConsumeNumber() {
       break;
     default:
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
   }
 
   pos_ = exit_pos;
   index_ = exit_index;
 
-  StringPiece num_string(num_start, end_index - start_index);
+  *out = StringPiece(num_start, end_index - start_index);
+  return true;
+}
+
+Value* JSONParser::ConsumeNumber() {
+  StringPiece num_string;
+  if (!ConsumeNumberRaw(&num_string))
+    return NULL;
 
   int num_int;
   if (StringToInt(num_string, &num_int))
@@ -908,45 +1071,34 @@ bool JSONParser::ReadInt(bool allow_leading_zeros) {
 
 Value* JSONParser::ConsumeLiteral() {
   switch (*pos_) {
-    case 't': {
-      const char* kTrueLiteral = "true";
-      const int kTrueLen = static_cast<int>(strlen(kTrueLiteral));
-      if (!CanConsume(kTrueLen - 1) ||
-          !StringsAreEqual(pos_, kTrueLiteral, kTrueLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    case 't':
+      if (!ConsumeLiteralRaw("true"))
         return NULL;
-      }
-      NextNChars(kTrueLen - 1);
       return Value::CreateBooleanValue(true);
-    }
-    case 'f': {
-      const char* kFalseLiteral = "false";
-      const int kFalseLen = static_cast<int>(strlen(kFalseLiteral));
-      if (!CanConsume(kFalseLen - 1) ||
-          !StringsAreEqual(pos_, kFalseLiteral, kFalseLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    case 'f':
+      if (!ConsumeLiteralRaw("false"))
         return NULL;
-      }
-      NextNChars(kFalseLen - 1);
       return Value::CreateBooleanValue(false);
-    }
-    case 'n': {
-      const char* kNullLiteral = "null";
-      const int kNullLen = static_cast<int>(strlen(kNullLiteral));
-      if (!CanConsume(kNullLen - 1) ||
-          !StringsAreEqual(pos_, kNullLiteral, kNullLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    case 'n':
+      if (!ConsumeLiteralRaw("null"))
         return NULL;
-      }
-      NextNChars(kNullLen - 1);
       return Value::CreateNullValue();
-    }
     default:
       ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
       return NULL;
   }
 }
 
+bool JSONParser::ConsumeLiteralRaw(const char* literal) {
+  const int len = static_cast<int>(strlen(literal));
+  if (!CanConsume(len - 1) || !StringsAreEqual(pos_, literal, len)) {
+    ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    return false;
+  }
+  NextNChars(len - 1);
+  return true;
+}
+
 // static
 bool JSONParser::StringsAreEqual(const char* one, const char* two, size_t len) {
   return strncmp(one, two, len) == 0;
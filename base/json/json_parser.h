@@ -49,6 +49,10 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // result as a Value owned by the caller.
   Value* Parse(const StringPiece& input);
 
+  // Parses the input string and reports it to |handler| event by event.
+  // Returns false on a syntax error or when |handler| stops the parse.
+  bool Parse(const StringPiece& input, JSONSaxHandler* handler);
+
   // Returns the error code.
   JSONReader::JsonParseError error_code() const;
 
@@ -114,6 +118,9 @@ class BASE_EXPORT_PRIVATE JSONParser {
     // Returns the builder as a std::string.
     const std::string& AsString();
 
+    // Returns the string, either as a piece of the input or of the copy.
+    StringPiece Contents();
+
    private:
     // The beginning of the input string.
     const char* pos_;
@@ -126,6 +133,13 @@ class BASE_EXPORT_PRIVATE JSONParser {
     std::string* string_;
   };
 
+  // Winds the parser to the beginning of |length| bytes at |start| and clears
+  // the error, skipping a UTF-8 Byte-Order-Mark.
+  void Reset(const char* start, size_t length);
+
+  // Checks that only whitespace and comments follow the root element.
+  bool CheckEndOfInput();
+
   // Quick check that the stream has capacity to consume |length| more bytes.
   bool CanConsume(int length);
 
@@ -163,6 +177,14 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // ListValue.
   Value* ConsumeList();
 
+  // Event based counterparts of ParseNextToken(), ParseToken(),
+  // ConsumeDictionary() and ConsumeList().  They follow the same invariants
+  // but report the tokens to |handler| instead of building Values.
+  bool EmitNextToken(JSONSaxHandler* handler);
+  bool EmitToken(Token token, JSONSaxHandler* handler);
+  bool EmitDictionary(JSONSaxHandler* handler);
+  bool EmitList(JSONSaxHandler* handler);
+
   // Calls through ConsumeStringRaw and wraps it in a value.
   Value* ConsumeString();
 
@@ -185,6 +207,8 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Assuming that the parser is wound to the start of a valid JSON number,
   // this parses and converts it to either an int or double value.
   Value* ConsumeNumber();
+  // Validates the number and returns its text in |out|, without conversion.
+  bool ConsumeNumberRaw(StringPiece* out);
   // Helper that reads characters that are ints. Returns true if a number was
   // read and false on error.
   bool ReadInt(bool allow_leading_zeros);
@@ -192,6 +216,8 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Consumes the literal values of |true|, |false|, and |null|, assuming the
   // parser is wound to the first character of any of those.
   Value* ConsumeLiteral();
+  // Consumes |literal|, which the parser must be wound to.
+  bool ConsumeLiteralRaw(const char* literal);
 
   // Compares two string buffers of a given length.
   static bool StringsAreEqual(const char* left, const char* right, size_t len);
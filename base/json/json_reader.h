@@ -60,6 +60,30 @@ enum JSONParserOptions {
   JSON_DETACHABLE_CHILDREN = 1 << 1,
 };
 
+// Receives a JSON document from JSONReader::ReadWithHandler() as a stream of
+// events, without building any Value.  StringPieces passed to the handler are
+// only valid for the duration of the call.  Returning false from any method
+// stops the parse.
+class BASE_EXPORT JSONSaxHandler {
+ public:
+  virtual ~JSONSaxHandler() {}
+
+  virtual bool StartObject() { return true; }
+  virtual bool EndObject() { return true; }
+  virtual bool StartArray() { return true; }
+  virtual bool EndArray() { return true; }
+
+  // The key of the next member of the current object.
+  virtual bool Key(const StringPiece& key) { return true; }
+
+  // Scalar values.  Strings are unescaped UTF-8, numbers are passed as they
+  // appear in the input, e.g. "-1.5e3".
+  virtual bool String(const StringPiece& value) { return true; }
+  virtual bool Number(const StringPiece& value) { return true; }
+  virtual bool Boolean(bool value) { return true; }
+  virtual bool Null() { return true; }
+};
+
 class BASE_EXPORT JSONReader {
  public:
   // Error codes during parsing.
@@ -111,6 +135,16 @@ class BASE_EXPORT JSONReader {
                                    int* error_code_out,
                                    std::string* error_msg_out);
 
+  // Parses |json| and reports its structure to |handler| instead of building
+  // a Value.  Returns true if the whole input was consumed.  On a syntax error
+  // |error_code_out| and |error_msg_out| (both optional) are populated; if the
+  // handler stopped the parse they are set to JSON_NO_ERROR and "".
+  static bool ReadWithHandler(const StringPiece& json,
+                              int options,  // JSONParserOptions
+                              JSONSaxHandler* handler,
+                              int* error_code_out,
+                              std::string* error_msg_out);
+
   // Converts a JSON parse error code into a human readable message.
   // Returns an empty string if error_code is JSON_NO_ERROR.
   static std::string ErrorCodeToString(JsonParseError error_code);
@@ -5,6 +5,8 @@
 #include "base/message_loop.h"
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/compiler_specific.h"
@@ -216,38 +218,63 @@ void MessageLoop::RemoveDestructionObserver(
 
 void MessageLoop::PostTask(
     const tracked_objects::Location& from_here, const base::Closure& task) {
+  PostTask(from_here, base::OnceClosure(task));
+}
+
+void MessageLoop::PostDelayedTask(
+    const tracked_objects::Location& from_here,
+    const base::Closure& task,
+    TimeDelta delay) {
+  PostDelayedTask(from_here, base::OnceClosure(task), delay);
+}
+
+void MessageLoop::PostNonNestableTask(
+    const tracked_objects::Location& from_here,
+    const base::Closure& task) {
+  PostNonNestableTask(from_here, base::OnceClosure(task));
+}
+
+void MessageLoop::PostNonNestableDelayedTask(
+    const tracked_objects::Location& from_here,
+    const base::Closure& task,
+    TimeDelta delay) {
+  PostNonNestableDelayedTask(from_here, base::OnceClosure(task), delay);
+}
+
+void MessageLoop::PostTask(
+    const tracked_objects::Location& from_here, base::OnceClosure task) {
   DCHECK(!task.is_null()) << from_here.ToString();
   PendingTask pending_task(
-      from_here, task, CalculateDelayedRuntime(TimeDelta()), true);
+      from_here, std::move(task), CalculateDelayedRuntime(TimeDelta()), true);
   AddToIncomingQueue(&pending_task);
 }
 
 void MessageLoop::PostDelayedTask(
     const tracked_objects::Location& from_here,
-    const base::Closure& task,
+    base::OnceClosure task,
     TimeDelta delay) {
   DCHECK(!task.is_null()) << from_here.ToString();
   PendingTask pending_task(
-      from_here, task, CalculateDelayedRuntime(delay), true);
+      from_here, std::move(task), CalculateDelayedRuntime(delay), true);
   AddToIncomingQueue(&pending_task);
 }
 
 void MessageLoop::PostNonNestableTask(
     const tracked_objects::Location& from_here,
-    const base::Closure& task) {
+    base::OnceClosure task) {
   DCHECK(!task.is_null()) << from_here.ToString();
   PendingTask pending_task(
-      from_here, task, CalculateDelayedRuntime(TimeDelta()), false);
+      from_here, std::move(task), CalculateDelayedRuntime(TimeDelta()), false);
   AddToIncomingQueue(&pending_task);
 }
 
 void MessageLoop::PostNonNestableDelayedTask(
     const tracked_objects::Location& from_here,
-    const base::Closure& task,
+    base::OnceClosure task,
     TimeDelta delay) {
   DCHECK(!task.is_null()) << from_here.ToString();
   PendingTask pending_task(
-      from_here, task, CalculateDelayedRuntime(delay), false);
+      from_here, std::move(task), CalculateDelayedRuntime(delay), false);
   AddToIncomingQueue(&pending_task);
 }
 
@@ -321,8 +348,8 @@ void MessageLoop::RemoveTaskObserver(TaskObserver* task_observer) {
 }
 
 void MessageLoop::AssertIdle() const {
-  // We only check |incoming_queue_|, since we don't want to lock |work_queue_|.
-  base::AutoLock lock(incoming_queue_lock_);
+  // We only check |incoming_queue_|, since |work_queue_| belongs to the
+  // thread of the loop.
   DCHECK(incoming_queue_.empty());
 }
 
@@ -372,14 +399,15 @@ bool MessageLoop::ProcessNextDelayedNonNestableTask() {
   if (deferred_non_nestable_work_queue_.empty())
     return false;
 
-  PendingTask pending_task = deferred_non_nestable_work_queue_.front();
+  PendingTask pending_task =
+      std::move(deferred_non_nestable_work_queue_.front());
   deferred_non_nestable_work_queue_.pop();
 
-  RunTask(pending_task);
+  RunTask(&pending_task);
   return true;
 }
 
-void MessageLoop::RunTask(const PendingTask& pending_task) {
+void MessageLoop::RunTask(PendingTask* pending_task) {
   DCHECK(nestable_tasks_allowed_);
   // Execute the task and assume the worst: It is probably not reentrant.
   nestable_tasks_allowed_ = false;
@@ -390,21 +418,21 @@ void MessageLoop::RunTask(const PendingTask& pending_task) {
   // expected value when displayed by the optimizer in an optimized build.
   // Look at a memory dump of the stack.
   const void* program_counter =
-      pending_task.posted_from.program_counter();
+      pending_task->posted_from.program_counter();
   base::debug::Alias(&program_counter);
 
   FOR_EACH_OBSERVER(TaskObserver, task_observers_,
-                    WillProcessTask(pending_task.time_posted));
-  pending_task.task.Run();
+                    WillProcessTask(pending_task->time_posted));
+  pending_task->task.Run();
   FOR_EACH_OBSERVER(TaskObserver, task_observers_,
-                    DidProcessTask(pending_task.time_posted));
+                    DidProcessTask(pending_task->time_posted));
 
   nestable_tasks_allowed_ = true;
 }
 
-bool MessageLoop::DeferOrRunPendingTask(const PendingTask& pending_task) {
+bool MessageLoop::DeferOrRunPendingTask(PendingTask pending_task) {
   if (pending_task.nestable || run_loop_->run_depth_ == 1) {
-    RunTask(pending_task);
+    RunTask(&pending_task);
     // Show that we ran a task (Note: a new one might arrive as a
     // consequence!).
     return true;
@@ -412,43 +440,70 @@ bool MessageLoop::DeferOrRunPendingTask(const PendingTask& pending_task) {
 
   // We couldn't run the task now because we're in a nested message loop
   // and the task isn't nestable.
-  deferred_non_nestable_work_queue_.push(pending_task);
+  deferred_non_nestable_work_queue_.push(std::move(pending_task));
   return false;
 }
 
-void MessageLoop::AddToDelayedWorkQueue(const PendingTask& pending_task) {
+void MessageLoop::AddToDelayedWorkQueue(PendingTask pending_task) {
   // Move to the delayed work queue.
-  delayed_work_queue_.push(pending_task);
+  if (timer_wheel_.get()) {
+    TimeTicks delayed_run_time = pending_task.delayed_run_time;
+    timer_wheel_->Schedule(new base::WheelPendingTask(std::move(pending_task)),
+                           delayed_run_time);
+    return;
+  }
+  delayed_work_queue_.push(std::move(pending_task));
+}
+
+void MessageLoop::SetDelayedTaskBackend(DelayedTaskBackend backend) {
+  DCHECK_EQ(this, current());
+  DCHECK(delayed_work_queue_.empty());
+  DCHECK(!timer_wheel_.get() || timer_wheel_->empty());
+
+  if (backend == DELAYED_TASK_HEAP)
+    timer_wheel_.reset();
+  else if (!timer_wheel_.get())
+    timer_wheel_.reset(new base::TimerWheel(TimeTicks::Now()));
+}
+
+void MessageLoop::ScheduleWheelTask(base::WheelPendingTask* task,
+                                    TimeTicks run_time) {
+  DCHECK_EQ(this, current());
+  DCHECK(timer_wheel_.get());
+  task->pending_task.delayed_run_time = run_time;
+  timer_wheel_->Schedule(task, run_time);
+  ScheduleWheelWakeUp();
+}
+
+void MessageLoop::ScheduleWheelWakeUp() {
+  TimeTicks wake_up = timer_wheel_->NextWakeUp();
+  if (!wake_up.is_null())
+    pump_->ScheduleDelayedWork(wake_up);
 }
 
 void MessageLoop::ReloadWorkQueue() {
   // We can improve performance of our loading tasks from incoming_queue_ to
   // work_queue_ by waiting until the last minute (work_queue_ is empty) to
-  // load.  That reduces the number of locks-per-task significantly when our
-  // queues get large.
+  // load.  That reduces the number of atomic exchanges per task significantly
+  // when our queues get large.
   if (!work_queue_.empty())
-    return;  // Wait till we *really* need to lock and load.
+    return;  // Wait till we *really* need to load.
 
-  // Acquire all we can from the inter-thread queue with one lock acquisition.
-  {
-    base::AutoLock lock(incoming_queue_lock_);
-    if (incoming_queue_.empty())
-      return;
-    incoming_queue_.Swap(&work_queue_);  // Constant time
-    DCHECK(incoming_queue_.empty());
-  }
+  // Acquire all we can from the inter-thread queue with one exchange.  If it
+  // is empty, the next posted task wakes up the pump.
+  incoming_queue_.ReloadWorkQueue(&work_queue_);
 }
 
 bool MessageLoop::DeletePendingTasks() {
   bool did_work = !work_queue_.empty();
   while (!work_queue_.empty()) {
-    PendingTask pending_task = work_queue_.front();
+    PendingTask pending_task = std::move(work_queue_.front());
     work_queue_.pop();
     if (!pending_task.delayed_run_time.is_null()) {
       // We want to delete delayed tasks in the same order in which they would
       // normally be deleted in case of any funny dependencies between delayed
       // tasks.
-      AddToDelayedWorkQueue(pending_task);
+      AddToDelayedWorkQueue(std::move(pending_task));
     }
   }
   did_work |= !deferred_non_nestable_work_queue_.empty();
@@ -465,6 +520,14 @@ bool MessageLoop::DeletePendingTasks() {
   while (!delayed_work_queue_.empty()) {
     delayed_work_queue_.pop();
   }
+
+  if (timer_wheel_.get()) {
+    std::vector<base::TimerWheel::Entry*> entries;
+    timer_wheel_->Clear(&entries);
+    did_work |= !entries.empty();
+    for (size_t i = 0; i < entries.size(); i++)
+      static_cast<base::WheelPendingTask*>(entries[i])->Drop();
+  }
   return did_work;
 }
 
@@ -512,29 +575,23 @@ void MessageLoop::AddToIncomingQueue(PendingTask* pending_task) {
   // directly, as it could starve handling of foreign threads.  Put every task
   // into this queue.
 
-  scoped_refptr<base::MessagePump> pump;
-  {
-    base::AutoLock locked(incoming_queue_lock_);
-
-    // Initialize the sequence number. The sequence number is used for delayed
-    // tasks (to faciliate FIFO sorting when two tasks have the same
-    // delayed_run_time value) and for identifying the task in about:tracing.
-    pending_task->sequence_num = next_sequence_num_++;
+  // Initialize the sequence number. The sequence number is used for delayed
+  // tasks (to faciliate FIFO sorting when two tasks have the same
+  // delayed_run_time value) and for identifying the task in about:tracing.
+  pending_task->sequence_num =
+      next_sequence_num_.fetch_add(1, std::memory_order_relaxed);
 
-    bool was_empty = incoming_queue_.empty();
-    incoming_queue_.push(*pending_task);
-    pending_task->task.Reset();
-    if (!was_empty)
-      return;  // Someone else should have started the sub-pump.
-
-    pump = pump_;
-  }
   // Since the incoming_queue_ may contain a task that destroys this message
-  // loop, we cannot exit incoming_queue_lock_ until we are done with |this|.
-  // We use a stack-based reference to the message pump so that we can call
-  // ScheduleWork outside of incoming_queue_lock_.
+  // loop, we cannot touch |this| once the task is pushed.  We use a
+  // stack-based reference to the message pump so that we can call
+  // ScheduleWork after the push.
+  scoped_refptr<base::MessagePump> pump = pump_;
+  bool was_empty = incoming_queue_.Push(pending_task);
 
-  pump->ScheduleWork();
+  // Skip the wake up if the loop is awake and will reload its work queue
+  // before it sleeps.
+  if (was_empty)
+    pump->ScheduleWork();
 }
 
 bool MessageLoop::DoWork() {
@@ -550,15 +607,19 @@ bool MessageLoop::DoWork() {
 
     // Execute oldest task.
     do {
-      PendingTask pending_task = work_queue_.front();
+      PendingTask pending_task = std::move(work_queue_.front());
       work_queue_.pop();
       if (!pending_task.delayed_run_time.is_null()) {
-        AddToDelayedWorkQueue(pending_task);
+        int sequence_num = pending_task.sequence_num;
+        TimeTicks delayed_run_time = pending_task.delayed_run_time;
+        AddToDelayedWorkQueue(std::move(pending_task));
         // If we changed the topmost task, then it is time to reschedule.
-        if (delayed_work_queue_.top().task.Equals(pending_task.task))
-          pump_->ScheduleDelayedWork(pending_task.delayed_run_time);
+        if (timer_wheel_.get())
+          ScheduleWheelWakeUp();
+        else if (delayed_work_queue_.top().sequence_num == sequence_num)
+          pump_->ScheduleDelayedWork(delayed_run_time);
       } else {
-        if (DeferOrRunPendingTask(pending_task))
+        if (DeferOrRunPendingTask(std::move(pending_task)))
           return true;
       }
     } while (!work_queue_.empty());
@@ -569,6 +630,9 @@ bool MessageLoop::DoWork() {
 }
 
 bool MessageLoop::DoDelayedWork(TimeTicks* next_delayed_work_time) {
+  if (timer_wheel_.get())
+    return DoWheelDelayedWork(next_delayed_work_time);
+
   if (!nestable_tasks_allowed_ || delayed_work_queue_.empty()) {
     recent_time_ = *next_delayed_work_time = TimeTicks();
     return false;
@@ -590,13 +654,48 @@ bool MessageLoop::DoDelayedWork(TimeTicks* next_delayed_work_time) {
     }
   }
 
-  PendingTask pending_task = delayed_work_queue_.top();
+  PendingTask pending_task =
+      std::move(const_cast<PendingTask&>(delayed_work_queue_.top()));
   delayed_work_queue_.pop();
 
   if (!delayed_work_queue_.empty())
     *next_delayed_work_time = delayed_work_queue_.top().delayed_run_time;
 
-  return DeferOrRunPendingTask(pending_task);
+  return DeferOrRunPendingTask(std::move(pending_task));
+}
+
+bool MessageLoop::DoWheelDelayedWork(TimeTicks* next_delayed_work_time) {
+  if (!nestable_tasks_allowed_ || timer_wheel_->empty()) {
+    *next_delayed_work_time = TimeTicks();
+    return false;
+  }
+
+  // As with the heap, Now() is only read again once all the tasks found
+  // expired have run.
+  if (!timer_wheel_->HasExpired()) {
+    timer_wheel_->Advance(TimeTicks::Now());
+    if (!timer_wheel_->HasExpired()) {
+      *next_delayed_work_time = timer_wheel_->NextWakeUp();
+      return false;
+    }
+  }
+
+  base::WheelPendingTask* wheel_task =
+      static_cast<base::WheelPendingTask*>(timer_wheel_->PopExpired());
+
+  // The next expired task is due already.
+  if (timer_wheel_->HasExpired())
+    *next_delayed_work_time = wheel_task->pending_task.delayed_run_time;
+  else
+    *next_delayed_work_time = timer_wheel_->NextWakeUp();
+
+  // The task is taken out first, a task the loop doesn't own may delete its
+  // owner and the WheelPendingTask with it.
+  DCHECK(wheel_task->IsOwnedByLoop() || wheel_task->pending_task.nestable);
+  PendingTask pending_task = wheel_task->TakePendingTask();
+  if (wheel_task->IsOwnedByLoop())
+    delete wheel_task;
+  return DeferOrRunPendingTask(std::move(pending_task));
 }
 
 bool MessageLoop::DoIdleWork() {
@@ -5,21 +5,25 @@
 #ifndef BASE_MESSAGE_LOOP_H_
 #define BASE_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <queue>
 #include <string>
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
+#include "base/incoming_task_queue.h"
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop_proxy.h"
 #include "base/message_pump.h"
 #include "base/observer_list.h"
+#include "base/once_closure.h"
 #include "base/pending_task.h"
 #include "base/sequenced_task_runner_helpers.h"
 #include "base/synchronization/lock.h"
 #include "base/base_time.h"
+#include "base/timer_wheel.h"
 #include "message_pump_dispatcher.h"
 #include "message_pump_observer.h"
 
@@ -35,6 +39,7 @@ namespace base {
 class Histogram;
 class RunLoop;
 class ThreadTaskRunnerHandle;
+class Timer;
 }  // namespace base
 
 // A MessageLoop is used to process events for a particular thread.  There is
@@ -162,6 +167,27 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
       const base::Closure& task,
       base::TimeDelta delay);
 
+  // The same for a move-only task, see base/once_closure.h.  The task is
+  // moved all the way to the call, a task with small bound state is posted
+  // without allocating anything for it.
+  void PostTask(
+      const tracked_objects::Location& from_here,
+      base::OnceClosure task);
+
+  void PostDelayedTask(
+      const tracked_objects::Location& from_here,
+      base::OnceClosure task,
+      base::TimeDelta delay);
+
+  void PostNonNestableTask(
+      const tracked_objects::Location& from_here,
+      base::OnceClosure task);
+
+  void PostNonNestableDelayedTask(
+      const tracked_objects::Location& from_here,
+      base::OnceClosure task,
+      base::TimeDelta delay);
+
   // A variant on PostTask that deletes the given object.  This is useful
   // if the object needs to live until the next run of the MessageLoop (for
   // example, deleting a RenderProcessHost from within an IPC callback is not
@@ -309,6 +335,30 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // Returns true if we are currently running a nested message loop.
   bool IsNested();
 
+  // Where the delayed tasks wait for their run time.
+  //
+  // DELAYED_TASK_HEAP
+  //   A priority queue, the tasks run at their exact run time.  This is the
+  //   default.
+  //
+  // DELAYED_TASK_WHEEL
+  //   A base::TimerWheel.  Adding a task costs the same however many are
+  //   pending, but run times are rounded up to the next millisecond.
+  //   base::Timer moves its task in the wheel when it is reset instead of
+  //   posting a new one.
+  //
+  enum DelayedTaskBackend {
+    DELAYED_TASK_HEAP,
+    DELAYED_TASK_WHEEL
+  };
+
+  // Changes where the delayed tasks wait.  It may only be called while no
+  // delayed task is pending, usually right after the loop is created.
+  void SetDelayedTaskBackend(DelayedTaskBackend backend);
+  DelayedTaskBackend delayed_task_backend() const {
+    return timer_wheel_.get() ? DELAYED_TASK_WHEEL : DELAYED_TASK_HEAP;
+  }
+
   // A TaskObserver is an object that receives task notifications from the
   // MessageLoop.
   //
@@ -395,26 +445,35 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   bool ProcessNextDelayedNonNestableTask();
 
   // Runs the specified PendingTask.
-  void RunTask(const base::PendingTask& pending_task);
+  void RunTask(base::PendingTask* pending_task);
 
   // Calls RunTask or queues the pending_task on the deferred task list if it
   // cannot be run right now.  Returns true if the task was run.
-  bool DeferOrRunPendingTask(const base::PendingTask& pending_task);
+  bool DeferOrRunPendingTask(base::PendingTask pending_task);
+
+  // Adds the pending task to delayed_work_queue_, or to timer_wheel_.
+  void AddToDelayedWorkQueue(base::PendingTask pending_task);
 
-  // Adds the pending task to delayed_work_queue_.
-  void AddToDelayedWorkQueue(const base::PendingTask& pending_task);
+  // Schedules |task| in timer_wheel_ to run at |run_time|, it is moved if it
+  // is already there.
+  void ScheduleWheelTask(base::WheelPendingTask* task,
+                         base::TimeTicks run_time);
 
-  // Adds the pending task to our incoming_queue_.
+  // Tells the pump when timer_wheel_ is due.
+  void ScheduleWheelWakeUp();
+
+  // DoDelayedWork() for timer_wheel_.
+  bool DoWheelDelayedWork(base::TimeTicks* next_delayed_work_time);
+
+  // Moves the pending task to our incoming_queue_.
   //
-  // Caller retains ownership of |pending_task|, but this function will
-  // reset the value of pending_task->task.  This is needed to ensure
-  // that the posting call stack does not retain pending_task->task
-  // beyond this function call.
+  // Caller retains ownership of |pending_task|, whose task is null once this
+  // function returns, so the posting call stack does not retain the task.
   void AddToIncomingQueue(base::PendingTask* pending_task);
 
   // Load tasks from the incoming_queue_ into work_queue_ if the latter is
-  // empty.  The former requires a lock to access, while the latter is directly
-  // accessible on this thread.
+  // empty.  The former is filled by any thread without a lock, while the
+  // latter is directly accessible on this thread.
   void ReloadWorkQueue();
 
   // Delete tasks that haven't run yet without running them.  Used in the
@@ -442,6 +501,10 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // A recent snapshot of Time::Now(), used to check delayed_work_queue_.
   base::TimeTicks recent_time_;
 
+  // Holds the delayed tasks instead of delayed_work_queue_ when the backend is
+  // DELAYED_TASK_WHEEL.
+  scoped_ptr<base::TimerWheel> timer_wheel_;
+
   // A queue of non-nestable tasks that we had to defer because when it came
   // time to execute them we were in a nested message loop.  They will execute
   // once we're out of nested message loops.
@@ -461,13 +524,10 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // A profiling histogram showing the counts of various messages and events.
   base::Histogram* message_histogram_;
 
-  // A null terminated list which creates an incoming_queue of tasks that are
-  // acquired under a mutex for processing on this instance's thread. These
-  // tasks have not yet been sorted out into items for our work_queue_ vs items
-  // that will be handled by the TimerManager.
-  base::TaskQueue incoming_queue_;
-  // Protect access to incoming_queue_.
-  mutable base::Lock incoming_queue_lock_;
+  // A lock-free list of tasks posted by any thread for processing on this
+  // instance's thread. These tasks have not yet been sorted out into items
+  // for our work_queue_ vs items that will be handled by the TimerManager.
+  base::IncomingTaskQueue incoming_queue_;
 
   base::RunLoop* run_loop_;
 
@@ -478,9 +538,9 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   bool os_modal_loop_;
 #endif
 
-  // The next sequence number to use for delayed tasks. Updating this counter is
-  // protected by incoming_queue_lock_.
-  int next_sequence_num_;
+  // The next sequence number to use for delayed tasks, it is incremented by
+  // the posting threads.
+  std::atomic<int> next_sequence_num_;
 
   ObserverList<TaskObserver> task_observers_;
 
@@ -489,6 +549,7 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   scoped_ptr<base::ThreadTaskRunnerHandle> thread_task_runner_handle_;
 
  private:
+  friend class base::Timer;
   template <class T, class R> friend class base::subtle::DeleteHelperInternal;
   template <class T, class R> friend class base::subtle::ReleaseHelperInternal;
 
@@ -4,6 +4,8 @@
 
 #include "base/message_loop_proxy_impl.h"
 
+#include <utility>
+
 #include "base/location.h"
 #include "base/threading/thread_restrictions.h"
 
@@ -26,6 +28,13 @@ bool MessageLoopProxyImpl::PostNonNestableDelayedTask(
   return PostTaskHelper(from_here, task, delay, false);
 }
 
+bool MessageLoopProxyImpl::PostDelayedTask(
+    const tracked_objects::Location& from_here,
+    OnceClosure task,
+    base::TimeDelta delay) {
+  return PostTaskHelper(from_here, std::move(task), delay, true);
+}
+
 bool MessageLoopProxyImpl::RunsTasksOnCurrentThread() const {
   // We shouldn't use MessageLoop::current() since it uses LazyInstance which
   // may be deleted by ~AtExitManager when a WorkerPool thread calls this
@@ -67,14 +76,15 @@ MessageLoopProxyImpl::MessageLoopProxyImpl()
 }
 
 bool MessageLoopProxyImpl::PostTaskHelper(
-    const tracked_objects::Location& from_here, const base::Closure& task,
+    const tracked_objects::Location& from_here, OnceClosure task,
     base::TimeDelta delay, bool nestable) {
   AutoLock lock(message_loop_lock_);
   if (target_message_loop_) {
     if (nestable) {
-      target_message_loop_->PostDelayedTask(from_here, task, delay);
+      target_message_loop_->PostDelayedTask(from_here, std::move(task), delay);
     } else {
-      target_message_loop_->PostNonNestableDelayedTask(from_here, task, delay);
+      target_message_loop_->PostNonNestableDelayedTask(
+          from_here, std::move(task), delay);
     }
     return true;
   }
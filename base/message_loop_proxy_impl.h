@@ -25,6 +25,9 @@ class BASE_EXPORT MessageLoopProxyImpl : public MessageLoopProxy {
       const tracked_objects::Location& from_here,
       const base::Closure& task,
       base::TimeDelta delay) OVERRIDE;
+  virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
+                               OnceClosure task,
+                               base::TimeDelta delay) OVERRIDE;
   virtual bool RunsTasksOnCurrentThread() const OVERRIDE;
 
  protected:
@@ -46,7 +49,7 @@ class BASE_EXPORT MessageLoopProxyImpl : public MessageLoopProxy {
 
 
   bool PostTaskHelper(const tracked_objects::Location& from_here,
-                      const base::Closure& task,
+                      OnceClosure task,
                       base::TimeDelta delay,
                       bool nestable);
 
@@ -0,0 +1,199 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// OnceClosure is a move-only task which runs at most once.  Unlike Closure it
+// isn't reference counted, it owns what it runs: a Closure, a lambda or any
+// other callable taking no argument.  A callable no bigger than four pointers
+// is stored inside the OnceClosure, so posting it allocates nothing for the
+// task and carrying it from queue to queue touches no reference count.
+// Bigger ones are moved to the heap once.
+//
+// BindOnce() binds arguments like Bind(), into a OnceClosure.  The functor
+// and the arguments are moved in when binding and moved out to the call when
+// it runs, so they may be move-only.  There is no Unretained(), Owned() or
+// WeakPtr handling: pointers are passed as they are, use Bind() when the
+// receiver needs to be kept alive or may go away.
+//
+// Example:
+//
+//   loop->PostTask(FROM_HERE, base::BindOnce(&Parser::Parse, parser, 42));
+//   loop->PostTask(FROM_HERE, [parser] { parser->Flush(); });
+//
+//   base::OnceClosure task = base::BindOnce(&Consume, std::move(buffer));
+//   task.Run();  // |task| is null afterwards.
+
+#ifndef BASE_ONCE_CLOSURE_H_
+#define BASE_ONCE_CLOSURE_H_
+
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/logging.h"
+
+namespace base {
+
+class OnceClosure {
+ public:
+  OnceClosure() : ops_(NULL) {}
+
+  // Runs |closure|, which keeps its bound state shared.  A null |closure|
+  // gives a null OnceClosure.
+  OnceClosure(const Closure& closure) : ops_(NULL) {
+    if (!closure.is_null())
+      Construct(closure);
+  }
+
+  // Takes any callable which can be called without argument.
+  template <typename Functor,
+            typename = typename std::enable_if<
+                !std::is_same<typename std::decay<Functor>::type,
+                              OnceClosure>::value &&
+                std::is_invocable<
+                    typename std::decay<Functor>::type&>::value>::type>
+  OnceClosure(Functor&& functor) : ops_(NULL) {
+    Construct(std::forward<Functor>(functor));
+  }
+
+  OnceClosure(OnceClosure&& other) : ops_(other.ops_) {
+    if (ops_)
+      ops_->move(other.storage_, storage_);
+    other.ops_ = NULL;
+  }
+
+  OnceClosure& operator=(OnceClosure&& other) {
+    if (this != &other) {
+      Reset();
+      ops_ = other.ops_;
+      if (ops_)
+        ops_->move(other.storage_, storage_);
+      other.ops_ = NULL;
+    }
+    return *this;
+  }
+
+  ~OnceClosure() {
+    Reset();
+  }
+
+  bool is_null() const { return ops_ == NULL; }
+
+  // Destroys the task without running it.
+  void Reset() {
+    if (ops_) {
+      const Ops* ops = ops_;
+      ops_ = NULL;
+      ops->destroy(storage_);
+    }
+  }
+
+  // Runs the task, then destroys it.  The OnceClosure is null from the
+  // moment the task starts, but must outlive the call and must not be
+  // assigned to by the task.
+  void Run() {
+    DCHECK(ops_);
+    const Ops* ops = ops_;
+    ops_ = NULL;
+    ops->run(storage_);
+  }
+
+ private:
+  enum { kInlineSize = 4 * sizeof(void*) };
+
+  struct Ops {
+    // Calls the callable in |storage|, then destroys it.
+    void (*run)(void* storage);
+    // Moves the callable from |from| to the uninitialized |to| and destroys
+    // what is left in |from|.
+    void (*move)(void* from, void* to);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename F>
+  static void Call(F& functor) {
+    functor();
+  }
+
+  static void Call(Closure& closure) {
+    closure.Run();
+  }
+
+  // A callable stored in the OnceClosure.
+  template <typename F>
+  struct InlineOps {
+    static F* Get(void* storage) {
+      return static_cast<F*>(storage);
+    }
+    static void Run(void* storage) {
+      Call(*Get(storage));
+      Get(storage)->~F();
+    }
+    static void Move(void* from, void* to) {
+      new (to) F(std::move(*Get(from)));
+      Get(from)->~F();
+    }
+    static void Destroy(void* storage) {
+      Get(storage)->~F();
+    }
+
+    static constexpr Ops kOps = { &Run, &Move, &Destroy };
+  };
+
+  // A callable too big for the OnceClosure, only its pointer is stored.
+  template <typename F>
+  struct HeapOps {
+    static F*& Get(void* storage) {
+      return *static_cast<F**>(storage);
+    }
+    static void Run(void* storage) {
+      F* functor = Get(storage);
+      Call(*functor);
+      delete functor;
+    }
+    static void Move(void* from, void* to) {
+      new (to) F*(Get(from));
+    }
+    static void Destroy(void* storage) {
+      delete Get(storage);
+    }
+
+    static constexpr Ops kOps = { &Run, &Move, &Destroy };
+  };
+
+  template <typename Functor>
+  void Construct(Functor&& functor) {
+    typedef typename std::decay<Functor>::type F;
+    if constexpr (sizeof(F) <= kInlineSize && alignof(F) <= alignof(void*) &&
+                  std::is_nothrow_move_constructible<F>::value) {
+      new (storage_) F(std::forward<Functor>(functor));
+      ops_ = &InlineOps<F>::kOps;
+    } else {
+      new (storage_) F*(new F(std::forward<Functor>(functor)));
+      ops_ = &HeapOps<F>::kOps;
+    }
+  }
+
+  alignas(void*) char storage_[kInlineSize];
+  const Ops* ops_;
+
+  DISALLOW_COPY_AND_ASSIGN(OnceClosure);
+};
+
+// Binds |args| to |functor|, a function, a method or a callable, see above.
+template <typename Functor, typename... Args>
+OnceClosure BindOnce(Functor&& functor, Args&&... args) {
+  return OnceClosure(
+      [functor = std::forward<Functor>(functor),
+       args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        std::apply(std::move(functor), std::move(args));
+      });
+}
+
+}  // namespace base
+
+#endif  // BASE_ONCE_CLOSURE_H_
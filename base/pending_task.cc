@@ -4,10 +4,12 @@
 
 #include "base/pending_task.h"
 
+#include <utility>
+
 namespace base {
 
-PendingTask::PendingTask(const tracked_objects::Location& posted_from, const base::Closure& task)
-  : task(task),
+PendingTask::PendingTask(const tracked_objects::Location& posted_from, OnceClosure task)
+  : task(std::move(task)),
     posted_from(posted_from),
     sequence_num(0),
     nestable(true) {
@@ -16,15 +18,32 @@ PendingTask::PendingTask(const tracked_objects::Location& posted_from, const bas
   time_posted = TimeTicks();
 }
 
-PendingTask::PendingTask(const tracked_objects::Location& posted_from, const base::Closure& task,
+PendingTask::PendingTask(const tracked_objects::Location& posted_from, OnceClosure task,
                          TimeTicks delayed_run_time, bool nestable)
-    : task(task),
+    : task(std::move(task)),
       posted_from(posted_from),
       sequence_num(0),
-      nestable(nestable) {
+      nestable(nestable),
+      delayed_run_time(delayed_run_time) {
+}
 
-  delayed_run_time = TimeTicks();
-  time_posted = TimeTicks();
+PendingTask::PendingTask(PendingTask&& other)
+    : task(std::move(other.task)),
+      posted_from(other.posted_from),
+      sequence_num(other.sequence_num),
+      nestable(other.nestable),
+      delayed_run_time(other.delayed_run_time),
+      time_posted(other.time_posted) {
+}
+
+PendingTask& PendingTask::operator=(PendingTask&& other) {
+  task = std::move(other.task);
+  posted_from = other.posted_from;
+  sequence_num = other.sequence_num;
+  nestable = other.nestable;
+  delayed_run_time = other.delayed_run_time;
+  time_posted = other.time_posted;
+  return *this;
 }
 
 PendingTask::~PendingTask() {
@@ -46,6 +65,25 @@ bool PendingTask::operator<(const PendingTask& other) const {
   return (sequence_num - other.sequence_num) > 0;
 }
 
+WheelPendingTask::WheelPendingTask(PendingTask pending_task)
+    : pending_task(std::move(pending_task)) {
+}
+
+WheelPendingTask::~WheelPendingTask() {
+}
+
+bool WheelPendingTask::IsOwnedByLoop() const {
+  return true;
+}
+
+PendingTask WheelPendingTask::TakePendingTask() {
+  return std::move(pending_task);
+}
+
+void WheelPendingTask::Drop() {
+  delete this;
+}
+
 void TaskQueue::Swap(TaskQueue* queue) {
   c.swap(queue->c);  // Calls std::deque::swap.
 }
@@ -11,24 +11,30 @@
 #include "base/callback.h"
 #include "base/location.h"
 #include "base/base_time.h"
+#include "base/once_closure.h"
+#include "base/timer_wheel.h"
 
 namespace base {
 
 // Contains data about a pending task. Stored in TaskQueue and DelayedTaskQueue
-// for use by classes that queue and execute tasks.
+// for use by classes that queue and execute tasks.  It is move-only, like its
+// task, so that carrying it from queue to queue copies nothing.
 struct BASE_EXPORT PendingTask {
-  PendingTask(const tracked_objects::Location& posted_from, const Closure& task);
+  PendingTask(const tracked_objects::Location& posted_from, OnceClosure task);
 
-  PendingTask(const tracked_objects::Location& posted_from, const Closure& task,
+  PendingTask(const tracked_objects::Location& posted_from, OnceClosure task,
               TimeTicks delayed_run_time, bool nestable);
 
+  PendingTask(PendingTask&& other);
+  PendingTask& operator=(PendingTask&& other);
+
   ~PendingTask();
 
   // Used to support sorting.
   bool operator<(const PendingTask& other) const;
 
   // The task to run.
-  Closure task;
+  OnceClosure task;
 
   // The site this PendingTask was posted from.
   tracked_objects::Location posted_from;
@@ -53,9 +59,36 @@ class BASE_EXPORT TaskQueue : public std::queue<PendingTask> {
   void Swap(TaskQueue* queue);
 };
 
-// PendingTasks are sorted by their |delayed_run_time| property.
+// PendingTasks are sorted by their |delayed_run_time| property.  top() is
+// const, the task is moved out with a const_cast right before pop(), which
+// only compares |delayed_run_time| and |sequence_num|.
 typedef std::priority_queue<base::PendingTask> DelayedTaskQueue;
 
+// A PendingTask waiting in the TimerWheel of a MessageLoop.  The loop owns
+// the ones it makes for PostDelayedTask(), base::Timer keeps its own and
+// moves it instead of posting a new one.
+class BASE_EXPORT WheelPendingTask : public TimerWheel::Entry {
+ public:
+  explicit WheelPendingTask(PendingTask pending_task);
+  virtual ~WheelPendingTask();
+
+  // Whether the MessageLoop deletes the task once it is taken out to run.
+  virtual bool IsOwnedByLoop() const;
+
+  // Called when the task expired, returns the PendingTask to run.  Moves
+  // |pending_task| out by default.
+  virtual PendingTask TakePendingTask();
+
+  // Called when the MessageLoop is destroyed before the task could run.
+  // Deletes it by default.
+  virtual void Drop();
+
+  PendingTask pending_task;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(WheelPendingTask);
+};
+
 }  // namespace base
 
 #endif  // PENDING_TASK_H_
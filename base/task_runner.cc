@@ -4,6 +4,9 @@
 
 #include "base/task_runner.h"
 
+#include <utility>
+
+#include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/threading/post_task_and_reply_impl.h"
@@ -12,6 +15,10 @@ namespace base {
 
 namespace {
 
+void RunOnceClosure(OnceClosure* task) {
+  task->Run();
+}
+
 // TODO(akalin): There's only one other implementation of
 // PostTaskAndReplyImpl in WorkerPool.  Investigate whether it'll be
 // possible to merge the two.
@@ -45,6 +52,20 @@ bool TaskRunner::PostTask(const tracked_objects::Location& from_here,
   return PostDelayedTask(from_here, task, base::TimeDelta());
 }
 
+bool TaskRunner::PostTask(const tracked_objects::Location& from_here,
+                          OnceClosure task) {
+  return PostDelayedTask(from_here, std::move(task), base::TimeDelta());
+}
+
+bool TaskRunner::PostDelayedTask(const tracked_objects::Location& from_here,
+                                 OnceClosure task,
+                                 base::TimeDelta delay) {
+  return PostDelayedTask(
+      from_here,
+      Bind(&RunOnceClosure, Owned(new OnceClosure(std::move(task)))),
+      delay);
+}
+
 bool TaskRunner::PostTaskAndReply(
     const tracked_objects::Location& from_here,
     const Closure& task,
@@ -9,6 +9,7 @@
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
 #include "base/memory/ref_counted.h"
+#include "base/once_closure.h"
 #include "base/base_time.h"
 
 namespace tracked_objects {
@@ -75,6 +76,17 @@ class BASE_EXPORT TaskRunner
                                const Closure& task,
                                base::TimeDelta delay) = 0;
 
+  // PostTask and PostDelayedTask for a move-only task, see
+  // base/once_closure.h.
+  bool PostTask(const tracked_objects::Location& from_here,
+                OnceClosure task);
+
+  // The default wraps |task| in a Closure, which costs an allocation.
+  // Implementations which can carry a OnceClosure to the call override it.
+  virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
+                               OnceClosure task,
+                               base::TimeDelta delay);
+
   // Returns true if the current thread is a thread on which a task
   // may be run, and false if no task will be run on the current
   // thread.
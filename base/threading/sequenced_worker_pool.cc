@@ -4,9 +4,9 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
-#include <list>
+#include <deque>
 #include <map>
-#include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <atomic>
@@ -300,10 +300,6 @@ class SequencedWorkerPool::Inner {
   int WillRunWorkerTask(const SequencedTask& task);
   void DidRunWorkerTask(const SequencedTask& task);
 
-  // Returns true if there are no threads currently running the given
-  // sequence token.
-  bool IsSequenceTokenRunnable(int sequence_token_id) const;
-
   // Checks if all threads are busy and the addition of one more could run an
   // additional task waiting in the queue. This must be called from within
   // the lock.
@@ -361,7 +357,7 @@ class SequencedWorkerPool::Inner {
   const std::string thread_name_prefix_;
 
   // Associates all known sequence token names with their IDs.
-  std::map<std::string, int> named_sequence_tokens_;
+  std::unordered_map<std::string, int> named_sequence_tokens_;
 
   // Owning pointers to all threads we've created so far, indexed by
   // ID. Since we lazily create threads, this may be less than
@@ -380,20 +376,33 @@ class SequencedWorkerPool::Inner {
   // or SKIP_ON_SHUTDOWN flag set.
   size_t blocking_shutdown_thread_count_;
 
-  // In-order list of all pending tasks. These are tasks waiting for a thread
-  // to run on or that are blocked on a previous task in their sequence.
-  //
-  // We maintain the pending_task_count_ separately for metrics because
-  // list.size() can be linear time.
-  std::list<SequencedTask> pending_tasks_;
+  // The pending tasks of one sequence token, in the order they were posted.
+  struct Sequence {
+    Sequence() : running(false) {}
+
+    std::deque<SequencedTask> tasks;
+
+    // Set while a thread runs a task of this sequence.
+    bool running;
+  };
+  typedef std::unordered_map<int, Sequence> SequenceMap;
+
+  // All pending tasks by sequence token. These are tasks waiting for a thread
+  // to run on or that are blocked on a previous task in their sequence. The
+  // unsequenced tasks are under token 0, which is never marked running since
+  // any number of them may run at once. A sequence is removed once it has no
+  // task left and isn't running.
+  SequenceMap sequences_;
   size_t pending_task_count_;
 
-  // Number of tasks in the pending_tasks_ list that are marked as blocking
-  // shutdown.
-  size_t blocking_shutdown_pending_task_count_;
+  // The sequences whose first task may run now, in the order they became
+  // runnable, so finding work doesn't have to look at the blocked tasks. A
+  // sequence token is in it at most once, except token 0 which is in it once
+  // for every pending unsequenced task.
+  std::deque<int> runnable_sequences_;
 
-  // Lists all sequence tokens currently executing.
-  std::set<int> current_sequences_;
+  // Number of tasks in sequences_ that are marked as blocking shutdown.
+  size_t blocking_shutdown_pending_task_count_;
 
   // An ID for each posted task to distinguish the task from others in traces.
   int trace_id_;
@@ -473,7 +482,8 @@ SequencedWorkerPool::Inner::~Inner() {
 
 SequencedWorkerPool::SequenceToken
 SequencedWorkerPool::Inner::GetSequenceToken() {
-  int result = last_sequence_number_.fetch_add(1);
+  // Token 0 means unsequenced, the first token handed out is 1.
+  int result = last_sequence_number_.fetch_add(1) + 1;
   return SequenceToken(static_cast<int>(result));
 }
 
@@ -507,7 +517,13 @@ bool SequencedWorkerPool::Inner::PostTask(
     if (optional_token_name)
       sequenced.sequence_token_id = LockedGetNamedTokenID(*optional_token_name);
 
-    pending_tasks_.push_back(sequenced);
+    // An unsequenced task may run right away, a sequenced one once the tasks
+    // before it in its sequence ran.
+    Sequence& sequence = sequences_[sequenced.sequence_token_id];
+    sequence.tasks.push_back(sequenced);
+    if (!sequenced.sequence_token_id ||
+        (sequence.tasks.size() == 1 && !sequence.running))
+      runnable_sequences_.push_back(sequenced.sequence_token_id);
     pending_task_count_++;
     if (shutdown_behavior == BLOCK_SHUTDOWN)
       blocking_shutdown_pending_task_count_++;
@@ -667,7 +683,7 @@ int SequencedWorkerPool::Inner::LockedGetNamedTokenID(
   lock_.AssertAcquired();
   DCHECK(!name.empty());
 
-  std::map<std::string, int>::const_iterator found =
+  std::unordered_map<std::string, int>::const_iterator found =
       named_sequence_tokens_.find(name);
   if (found != named_sequence_tokens_.end())
     return found->second;  // Got an existing one.
@@ -683,48 +699,34 @@ bool SequencedWorkerPool::Inner::GetWork(
     std::vector<Closure>* delete_these_outside_lock) {
   lock_.AssertAcquired();
 
-  DCHECK_EQ(pending_tasks_.size(), pending_task_count_);
-
-  // Find the next task with a sequence token that's not currently in use.
-  // If the token is in use, that means another thread is running something
-  // in that sequence, and we can't run it without going out-of-order.
-  //
-  // This algorithm is simple and fair, but inefficient in some cases. For
-  // example, say somebody schedules 1000 slow tasks with the same sequence
-  // number. We'll have to go through all those tasks each time we feel like
-  // there might be work to schedule. If this proves to be a problem, we
-  // should make this more efficient.
-  //
-  // One possible enhancement would be to keep a map from sequence ID to a
-  // list of pending but currently blocked SequencedTasks for that ID.
-  // When a worker finishes a task of one sequence token, it can pick up the
-  // next one from that token right away.
-  //
-  // This may lead to starvation if there are sufficient numbers of sequences
-  // in use. To alleviate this, we could add an incrementing priority counter
-  // to each SequencedTask. Then maintain a priority_queue of all runnable
-  // tasks, sorted by priority counter. When a sequenced task is completed
-  // we would pop the head element off of that tasks pending list and add it
-  // to the priority queue. Then we would run the first item in the priority
-  // queue.
-  bool found_task = false;
-  int unrunnable_tasks = 0;
-  std::list<SequencedTask>::iterator i = pending_tasks_.begin();
-  while (i != pending_tasks_.end()) {
-    if (!IsSequenceTokenRunnable(i->sequence_token_id)) {
-      unrunnable_tasks++;
-      ++i;
-      continue;
-    }
-
-    if (shutdown_called_ && i->shutdown_behavior != BLOCK_SHUTDOWN) {
+  // Take the first task of the first runnable sequence. A sequence with a
+  // task running isn't in runnable_sequences_, so the tasks blocked behind
+  // it are never looked at, and a sequence which ran a task goes to the back
+  // of the queue when the task is done so a long sequence can't starve the
+  // others.
+  while (!runnable_sequences_.empty()) {
+    int sequence_token_id = runnable_sequences_.front();
+    runnable_sequences_.pop_front();
+
+    SequenceMap::iterator found = sequences_.find(sequence_token_id);
+    DCHECK(found != sequences_.end());
+    Sequence& sequence = found->second;
+    DCHECK(!sequence.running);
+    DCHECK(!sequence.tasks.empty());
+
+    *task = sequence.tasks.front();
+    sequence.tasks.pop_front();
+    pending_task_count_--;
+
+    if (shutdown_called_ && task->shutdown_behavior != BLOCK_SHUTDOWN) {
       // We're shutting down and the task we just found isn't blocking
       // shutdown. Delete it and get more work.
       //
       // Note that we do not want to delete unrunnable tasks. Deleting a task
       // can have side effects (like freeing some objects) and deleting a
       // task that's supposed to run after one that's currently running could
-      // cause an obscure crash.
+      // cause an obscure crash. Only the first task of a runnable sequence
+      // is deleted here, the next one becomes runnable in its place.
       //
       // We really want to delete these tasks outside the lock in case the
       // closures are holding refs to objects that want to post work from
@@ -733,32 +735,35 @@ bool SequencedWorkerPool::Inner::GetWork(
       // until the lock is exited. The calling code can just clear() the
       // vector they passed to us once the lock is exited to make this
       // happen.
-      delete_these_outside_lock->push_back(i->task);
-      i = pending_tasks_.erase(i);
-      pending_task_count_--;
-    } else {
-      // Found a runnable task.
-      *task = *i;
-      i = pending_tasks_.erase(i);
-      pending_task_count_--;
-      if (task->shutdown_behavior == BLOCK_SHUTDOWN) {
-        blocking_shutdown_pending_task_count_--;
-      }
-
-      found_task = true;
-      break;
+      delete_these_outside_lock->push_back(task->task);
+      task->task = Closure();
+      if (sequence.tasks.empty())
+        sequences_.erase(found);
+      else if (sequence_token_id)
+        runnable_sequences_.push_front(sequence_token_id);
+      continue;
     }
+
+    // Found a runnable task. WillRunWorkerTask() marks its sequence running,
+    // the unsequenced tasks aren't kept once there are none left.
+    if (task->shutdown_behavior == BLOCK_SHUTDOWN)
+      blocking_shutdown_pending_task_count_--;
+    if (!sequence_token_id && sequence.tasks.empty())
+      sequences_.erase(found);
+    return true;
   }
 
-  return found_task;
+  return false;
 }
 
 int SequencedWorkerPool::Inner::WillRunWorkerTask(const SequencedTask& task) {
   lock_.AssertAcquired();
 
   // Mark the task's sequence number as in use.
-  if (task.sequence_token_id)
-    current_sequences_.insert(task.sequence_token_id);
+  if (task.sequence_token_id) {
+    DCHECK(ContainsKey(sequences_, task.sequence_token_id));
+    sequences_[task.sequence_token_id].running = true;
+  }
 
   // Ensure that threads running tasks posted with either SKIP_ON_SHUTDOWN
   // or BLOCK_SHUTDOWN will prevent shutdown until that task or thread
@@ -792,16 +797,16 @@ void SequencedWorkerPool::Inner::DidRunWorkerTask(const SequencedTask& task) {
     blocking_shutdown_thread_count_--;
   }
 
-  if (task.sequence_token_id)
-    current_sequences_.erase(task.sequence_token_id);
-}
-
-bool SequencedWorkerPool::Inner::IsSequenceTokenRunnable(
-    int sequence_token_id) const {
-  lock_.AssertAcquired();
-  return !sequence_token_id ||
-      current_sequences_.find(sequence_token_id) ==
-          current_sequences_.end();
+  // The next task of the sequence may run now.
+  if (task.sequence_token_id) {
+    SequenceMap::iterator found = sequences_.find(task.sequence_token_id);
+    DCHECK(found != sequences_.end());
+    found->second.running = false;
+    if (found->second.tasks.empty())
+      sequences_.erase(found);
+    else
+      runnable_sequences_.push_back(task.sequence_token_id);
+  }
 }
 
 int SequencedWorkerPool::Inner::PrepareToStartAdditionalThreadIfHelpful() {
@@ -838,16 +843,12 @@ int SequencedWorkerPool::Inner::PrepareToStartAdditionalThreadIfHelpful() {
   if (!shutdown_called_ &&
       !thread_being_created_ &&
       threads_.size() < max_threads_ &&
-      waiting_thread_count_ == 0) {
-    // We could use an additional thread if there's work to be done.
-    for (std::list<SequencedTask>::iterator i = pending_tasks_.begin();
-         i != pending_tasks_.end(); ++i) {
-      if (IsSequenceTokenRunnable(i->sequence_token_id)) {
-        // Found a runnable task, mark the thread as being started.
-        thread_being_created_ = true;
-        return static_cast<int>(threads_.size() + 1);
-      }
-    }
+      waiting_thread_count_ == 0 &&
+      !runnable_sequences_.empty()) {
+    // We could use an additional thread since there's a runnable task, mark
+    // the thread as being started.
+    thread_being_created_ = true;
+    return static_cast<int>(threads_.size() + 1);
   }
   return 0;
 }
@@ -0,0 +1,158 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/threading/task_graph.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/sys_info.h"
+#include "base/threading/work_stealing_thread_pool.h"
+
+namespace base {
+
+struct TaskGraph::Node {
+  Node(const std::string& task_name, const Closure& closure)
+      : name(task_name),
+        task(closure),
+        num_prerequisites(0),
+        remaining(0) {
+  }
+
+  std::string name;
+  Closure task;
+  std::vector<TaskId> dependents;
+  int num_prerequisites;
+  // Prerequisites that have not finished yet in the current Run().
+  std::atomic<int> remaining;
+  TimeTicks start;
+  TimeDelta duration;
+};
+
+TaskGraph::TaskGraph(const std::string& name_prefix, int num_threads)
+    : name_prefix_(name_prefix),
+      num_threads_(num_threads),
+      pool_(NULL) {
+  if (num_threads_ <= 0)
+    num_threads_ = SysInfo::NumberOfProcessors();
+}
+
+TaskGraph::~TaskGraph() {
+  DCHECK(!pool_);
+  STLDeleteElements(&nodes_);
+}
+
+TaskGraph::TaskId TaskGraph::AddTask(const std::string& name,
+                                     const Closure& task) {
+  DCHECK(!pool_);
+  nodes_.push_back(new Node(name, task));
+  return nodes_.size() - 1;
+}
+
+void TaskGraph::AddDependency(TaskId task, TaskId prerequisite) {
+  DCHECK(!pool_);
+  DCHECK_LT(task, nodes_.size());
+  DCHECK_LT(prerequisite, nodes_.size());
+  DCHECK_NE(task, prerequisite);
+  nodes_[prerequisite]->dependents.push_back(task);
+  nodes_[task]->num_prerequisites++;
+}
+
+bool TaskGraph::Run() {
+  DCHECK(!pool_);
+  if (!IsAcyclic()) {
+    DLOG(ERROR) << "TaskGraph " << name_prefix_ << " has a dependency cycle";
+    return false;
+  }
+
+  std::vector<TaskId> ready;
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    Node* node = nodes_[i];
+    node->remaining.store(node->num_prerequisites, std::memory_order_relaxed);
+    node->duration = TimeDelta();
+    if (node->num_prerequisites == 0)
+      ready.push_back(i);
+  }
+
+  WorkStealingThreadPool pool(name_prefix_, num_threads_, 0);
+  pool_ = &pool;
+  run_start_ = TimeTicks::HighResNow();
+  Schedule(ready);
+  pool.Start();
+  pool.JoinAll();
+  pool_ = NULL;
+  return true;
+}
+
+void TaskGraph::GetTimings(std::vector<TaskTiming>* timings) const {
+  timings->clear();
+  timings->reserve(nodes_.size());
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    const Node* node = nodes_[i];
+    TaskTiming timing;
+    timing.name = node->name;
+    if (!node->start.is_null())
+      timing.start = node->start - run_start_;
+    timing.duration = node->duration;
+    timings->push_back(timing);
+  }
+}
+
+bool TaskGraph::IsAcyclic() const {
+  std::vector<int> remaining(nodes_.size());
+  std::vector<TaskId> ready;
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    remaining[i] = nodes_[i]->num_prerequisites;
+    if (remaining[i] == 0)
+      ready.push_back(i);
+  }
+
+  size_t visited = 0;
+  while (!ready.empty()) {
+    TaskId id = ready.back();
+    ready.pop_back();
+    visited++;
+    const std::vector<TaskId>& dependents = nodes_[id]->dependents;
+    for (size_t i = 0; i < dependents.size(); i++) {
+      if (--remaining[dependents[i]] == 0)
+        ready.push_back(dependents[i]);
+    }
+  }
+  return visited == nodes_.size();
+}
+
+void TaskGraph::Schedule(const std::vector<TaskId>& ready) {
+  if (ready.empty())
+    return;
+
+  size_t slots = static_cast<size_t>(num_threads_) * kBatchesPerThread;
+  size_t batch_size = std::max<size_t>(1, (ready.size() + slots - 1) / slots);
+  for (size_t i = 0; i < ready.size(); i += batch_size) {
+    size_t end = std::min(ready.size(), i + batch_size);
+    std::vector<TaskId> batch(ready.begin() + i, ready.begin() + end);
+    pool_->PostTask(Bind(&TaskGraph::RunBatch, Unretained(this), batch));
+  }
+}
+
+void TaskGraph::RunBatch(const std::vector<TaskId>& batch) {
+  std::vector<TaskId> ready;
+  for (size_t i = 0; i < batch.size(); i++) {
+    Node* node = nodes_[batch[i]];
+    node->start = TimeTicks::HighResNow();
+    node->task.Run();
+    node->duration = TimeTicks::HighResNow() - node->start;
+
+    for (size_t j = 0; j < node->dependents.size(); j++) {
+      TaskId dependent = node->dependents[j];
+      if (nodes_[dependent]->remaining.fetch_sub(1,
+              std::memory_order_acq_rel) == 1)
+        ready.push_back(dependent);
+    }
+  }
+  Schedule(ready);
+}
+
+}  // namespace base
@@ -0,0 +1,97 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// TaskGraph runs a set of Closures with explicit dependencies between them on
+// a WorkStealingThreadPool.  A task is started once every task it depends on
+// has finished.  Tasks that become runnable together are grouped into a few
+// batches per worker, so a large number of small tasks does not pay one thread
+// handoff each.  The graph records when and for how long every task ran.
+//
+// Example:
+//
+//   base::TaskGraph graph("codegen", 0);
+//   base::TaskGraph::TaskId a = graph.AddTask("a.c", base::Bind(&BuildA));
+//   base::TaskGraph::TaskId b = graph.AddTask("b.c", base::Bind(&BuildB));
+//   base::TaskGraph::TaskId m = graph.AddTask("Makefile", base::Bind(&Make));
+//   graph.AddDependency(m, a);
+//   graph.AddDependency(m, b);
+//   graph.Run();  // Runs a.c and b.c in parallel, then Makefile.
+
+#ifndef BASE_THREADING_TASK_GRAPH_H_
+#define BASE_THREADING_TASK_GRAPH_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/base_time.h"
+#include "base/callback.h"
+
+namespace base {
+
+class WorkStealingThreadPool;
+
+class BASE_EXPORT TaskGraph {
+ public:
+  typedef size_t TaskId;
+
+  struct TaskTiming {
+    std::string name;
+    // Time from the start of Run() to the start of the task.
+    TimeDelta start;
+    TimeDelta duration;
+  };
+
+  // Runs the tasks on |num_threads| workers, or one worker per processor if
+  // |num_threads| is not positive.
+  TaskGraph(const std::string& name_prefix, int num_threads);
+  ~TaskGraph();
+
+  // Adds a task, |name| is only used for the timing report.
+  TaskId AddTask(const std::string& name, const Closure& task);
+
+  // |task| is not started before |prerequisite| has finished.
+  void AddDependency(TaskId task, TaskId prerequisite);
+
+  // Runs every task and blocks until all of them have finished.  Returns false
+  // without running anything if the dependencies contain a cycle.
+  bool Run();
+
+  // Timings of the last Run(), indexed by TaskId.
+  void GetTimings(std::vector<TaskTiming>* timings) const;
+
+  size_t size() const { return nodes_.size(); }
+  int num_threads() const { return num_threads_; }
+
+ private:
+  struct Node;
+
+  // Number of batches per worker a set of runnable tasks is split into.
+  enum { kBatchesPerThread = 4 };
+
+  // Returns true if every task can be reached in dependency order.
+  bool IsAcyclic() const;
+
+  // Splits |ready| into batches and posts them to |pool_|.
+  void Schedule(const std::vector<TaskId>& ready);
+
+  // Runs the tasks of |batch| in order and schedules the tasks they unblock.
+  void RunBatch(const std::vector<TaskId>& batch);
+
+  const std::string name_prefix_;
+  int num_threads_;
+  std::vector<Node*> nodes_;
+
+  // Valid while Run() is in progress.
+  WorkStealingThreadPool* pool_;
+  TimeTicks run_start_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskGraph);
+};
+
+}  // namespace base
+
+#endif  // BASE_THREADING_TASK_GRAPH_H_
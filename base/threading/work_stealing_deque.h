@@ -0,0 +1,163 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// WorkStealingDeque is a Chase-Lev deque of pointers.  Its owner thread
+// pushes and pops at the bottom without a lock, any thread may steal from
+// the top.  Only the last element is raced for, by a compare-and-swap on
+// the top index.  The array doubles when it is full; the old arrays are
+// kept until the deque is deleted since a thief may still read one.
+//
+// The memory orders are those of "Correct and Efficient Work-Stealing for
+// Weak Memory Models" (Le et al., PPoPP 2013), with the fences folded into
+// sequentially consistent accesses.  The push ends with a sequentially
+// consistent store, so a thread parking after it checked IsEmpty() and a
+// pusher checking for parked threads afterwards can't miss each other.
+//
+// Example:
+//
+//   // Owner thread.
+//   deque.Push(item);
+//   Item* mine = deque.Pop();
+//
+//   // Any thread.
+//   Item* stolen = deque.Steal();
+
+#ifndef BASE_THREADING_WORK_STEALING_DEQUE_H_
+#define BASE_THREADING_WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/stl_util.h"
+
+namespace base {
+
+template <typename T>
+class WorkStealingDeque {
+ public:
+  // |initial_capacity| must be a power of two.
+  explicit WorkStealingDeque(int64 initial_capacity = 256)
+      : top_(0),
+        bottom_(0),
+        array_(new Array(initial_capacity)) {
+    DCHECK_EQ(0, initial_capacity & (initial_capacity - 1));
+  }
+
+  // The elements left are not deleted.
+  ~WorkStealingDeque() {
+    delete array_.load(std::memory_order_relaxed);
+    STLDeleteElements(&retired_);
+  }
+
+  // Owner thread only.
+  void Push(T* item) {
+    int64 bottom = bottom_.load(std::memory_order_relaxed);
+    int64 top = top_.load(std::memory_order_acquire);
+    Array* array = array_.load(std::memory_order_relaxed);
+    if (bottom - top > array->capacity() - 1)
+      array = Grow(array, top, bottom);
+    array->Put(bottom, item);
+    bottom_.store(bottom + 1, std::memory_order_seq_cst);
+  }
+
+  // Owner thread only.  Takes the newest element, NULL if there is none.
+  T* Pop() {
+    int64 bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* array = array_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_seq_cst);
+    int64 top = top_.load(std::memory_order_seq_cst);
+
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return NULL;
+    }
+
+    T* item = array->Get(bottom);
+    if (top == bottom) {
+      // The last element, a thief may be taking it too.
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed))
+        item = NULL;
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // Any thread.  Takes the oldest element, NULL if there is none or if
+  // another thread took it first.
+  T* Steal() {
+    int64 top = top_.load(std::memory_order_seq_cst);
+    int64 bottom = bottom_.load(std::memory_order_seq_cst);
+    if (top >= bottom)
+      return NULL;
+
+    Array* array = array_.load(std::memory_order_acquire);
+    T* item = array->Get(top);
+    if (!top_.compare_exchange_strong(top, top + 1,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return NULL;
+    return item;
+  }
+
+  // Any thread.  The result may be stale as soon as it returns.
+  bool IsEmpty() const {
+    int64 top = top_.load(std::memory_order_seq_cst);
+    int64 bottom = bottom_.load(std::memory_order_seq_cst);
+    return top >= bottom;
+  }
+
+ private:
+  class Array {
+   public:
+    explicit Array(int64 capacity)
+        : mask_(capacity - 1),
+          items_(new std::atomic<T*>[capacity]) {
+    }
+
+    int64 capacity() const { return mask_ + 1; }
+
+    T* Get(int64 index) const {
+      return items_[index & mask_].load(std::memory_order_relaxed);
+    }
+
+    void Put(int64 index, T* item) {
+      items_[index & mask_].store(item, std::memory_order_relaxed);
+    }
+
+   private:
+    const int64 mask_;
+    scoped_array<std::atomic<T*> > items_;
+
+    DISALLOW_COPY_AND_ASSIGN(Array);
+  };
+
+  Array* Grow(Array* array, int64 top, int64 bottom) {
+    Array* grown = new Array(array->capacity() * 2);
+    for (int64 i = top; i < bottom; i++)
+      grown->Put(i, array->Get(i));
+    retired_.push_back(array);
+    array_.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+  // The owner and the thieves write different ends, keep them apart.
+  std::atomic<int64> top_;
+  char pad_[64 - sizeof(std::atomic<int64>)];
+  std::atomic<int64> bottom_;
+  std::atomic<Array*> array_;
+
+  // Arrays replaced by Grow(), owner thread only.
+  std::vector<Array*> retired_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+}  // namespace base
+
+#endif  // BASE_THREADING_WORK_STEALING_DEQUE_H_
@@ -0,0 +1,282 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/threading/work_stealing_thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/stl_util.h"
+#include "base/sys_info.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/threading/thread_local.h"
+#include "base/threading/work_stealing_deque.h"
+
+namespace base {
+
+namespace {
+
+// The Worker running on the current thread, NULL on non-worker threads.
+LazyInstance<ThreadLocalPointer<void> >::Leaky
+    g_current_worker = LAZY_INSTANCE_INITIALIZER;
+
+// A worker with tasks of its own takes one from the injection queue first
+// once every so many tasks.
+const unsigned int kInjectionInterval = 61;
+
+// Rounds of stealing attempts before a worker out of work parks.
+const int kSpinRounds = 64;
+
+}  // namespace
+
+class WorkStealingThreadPool::Worker : public DelegateSimpleThread::Delegate {
+ public:
+  Worker(WorkStealingThreadPool* pool, int index)
+      : pool_(pool),
+        index_(index),
+        tasks_taken_(0) {
+  }
+
+  virtual ~Worker() {
+    while (OnceClosure* task = deque_.Pop())
+      delete task;
+  }
+
+  virtual void Run() OVERRIDE {
+    g_current_worker.Get().Set(this);
+    pool_->WorkerMain(this);
+    g_current_worker.Get().Set(NULL);
+  }
+
+  WorkStealingThreadPool* pool() const { return pool_; }
+  int index() const { return index_; }
+
+  // The owner side of the deque is only used from the worker thread.
+  WorkStealingDeque<OnceClosure>* deque() { return &deque_; }
+
+  // Whether the injection queue should go first this time.
+  bool ShouldTakeInjectedTask() {
+    return ++tasks_taken_ % kInjectionInterval == 0;
+  }
+
+  scoped_ptr<DelegateSimpleThread> thread;
+
+ private:
+  WorkStealingThreadPool* const pool_;
+  const int index_;
+  WorkStealingDeque<OnceClosure> deque_;
+  unsigned int tasks_taken_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(const std::string& name_prefix,
+                                               int num_threads,
+                                               size_t max_pending_tasks)
+    : name_prefix_(name_prefix),
+      max_pending_tasks_(max_pending_tasks),
+      pending_tasks_(0),
+      outstanding_tasks_(0),
+      num_idle_workers_(0),
+      num_spinning_workers_(0),
+      num_injected_tasks_(0),
+      work_available_cv_(&lock_),
+      all_done_cv_(&lock_),
+      started_(false),
+      shutdown_(false) {
+  if (num_threads <= 0)
+    num_threads = SysInfo::NumberOfProcessors();
+  for (int i = 0; i < num_threads; ++i)
+    workers_.push_back(new Worker(this, i));
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  if (started_ && !shutdown_)
+    JoinAll();
+  STLDeleteElements(&workers_);
+  STLDeleteElements(&injected_tasks_);
+}
+
+void WorkStealingThreadPool::Start() {
+  DCHECK(!started_);
+  started_ = true;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker* worker = workers_[i];
+    worker->thread.reset(new DelegateSimpleThread(worker, name_prefix_));
+    worker->thread->Start();
+  }
+}
+
+void WorkStealingThreadPool::PostTask(const Closure& task) {
+  PostTask(OnceClosure(task));
+}
+
+void WorkStealingThreadPool::PostTask(OnceClosure task) {
+  DCHECK(!task.is_null());
+
+  if (max_pending_tasks_ != 0) {
+    // Too much queued work, let the producer do this one itself.
+    if (pending_tasks_ >= max_pending_tasks_) {
+      task.Run();
+      return;
+    }
+    ++pending_tasks_;
+  }
+
+  ++outstanding_tasks_;
+  Worker* worker = CurrentWorker();
+  if (worker != NULL) {
+    worker->deque()->Push(new OnceClosure(std::move(task)));
+  } else {
+    AutoLock locker(injection_lock_);
+    injected_tasks_.push_back(new OnceClosure(std::move(task)));
+    ++num_injected_tasks_;
+  }
+
+  // Both the push and the counters are sequentially consistent, so either a
+  // parking worker sees the task in HasWork() or the task sees it parked.
+  // A spinning worker will find the task, or wake the next one up.
+  if (num_spinning_workers_ == 0)
+    WakeUpWorker();
+}
+
+void WorkStealingThreadPool::Wait() {
+  DCHECK(CurrentWorker() == NULL) << "Wait() would deadlock on a worker";
+  AutoLock locker(lock_);
+  while (outstanding_tasks_ > 0)
+    all_done_cv_.Wait();
+}
+
+void WorkStealingThreadPool::JoinAll() {
+  DCHECK(started_);
+  Wait();
+  {
+    AutoLock locker(lock_);
+    shutdown_ = true;
+    work_available_cv_.Broadcast();
+  }
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->thread->Join();
+    workers_[i]->thread.reset();
+  }
+}
+
+// static
+WorkStealingThreadPool* WorkStealingThreadPool::Current() {
+  Worker* worker = static_cast<Worker*>(g_current_worker.Get().Get());
+  return worker != NULL ? worker->pool() : NULL;
+}
+
+void WorkStealingThreadPool::WorkerMain(Worker* self) {
+  for (;;) {
+    OnceClosure* task = FindTask(self);
+    if (task == NULL)
+      task = Spin(self);
+    if (task != NULL) {
+      RunTask(task);
+      continue;
+    }
+
+    AutoLock locker(lock_);
+    if (shutdown_)
+      return;
+    ++num_idle_workers_;
+    if (!HasWork())
+      work_available_cv_.Wait();
+    --num_idle_workers_;
+  }
+}
+
+OnceClosure* WorkStealingThreadPool::FindTask(Worker* self) {
+  OnceClosure* task = NULL;
+  if (self->ShouldTakeInjectedTask())
+    task = TakeInjectedTask();
+  if (task == NULL)
+    task = self->deque()->Pop();
+  if (task == NULL)
+    task = TakeInjectedTask();
+
+  const size_t count = workers_.size();
+  for (size_t i = 1; task == NULL && i < count; ++i)
+    task = workers_[(self->index() + i) % count]->deque()->Steal();
+
+  if (task != NULL && max_pending_tasks_ != 0)
+    --pending_tasks_;
+  return task;
+}
+
+OnceClosure* WorkStealingThreadPool::Spin(Worker* self) {
+  // Half of the workers spinning find the work as well as all of them.
+  int max_spinning = std::max(1, num_threads() / 2);
+  if (++num_spinning_workers_ > max_spinning) {
+    --num_spinning_workers_;
+    return NULL;
+  }
+
+  for (int i = 0; i < kSpinRounds; ++i) {
+    OnceClosure* task = FindTask(self);
+    if (task != NULL) {
+      // There may be more where this one came from, and posters count on
+      // the spinners to wake the others.
+      if (--num_spinning_workers_ == 0)
+        WakeUpWorker();
+      return task;
+    }
+    PlatformThread::YieldCurrentThread();
+  }
+
+  --num_spinning_workers_;
+  return NULL;
+}
+
+OnceClosure* WorkStealingThreadPool::TakeInjectedTask() {
+  if (num_injected_tasks_.load(std::memory_order_relaxed) == 0)
+    return NULL;
+  AutoLock locker(injection_lock_);
+  if (injected_tasks_.empty())
+    return NULL;
+  OnceClosure* task = injected_tasks_.front();
+  injected_tasks_.pop_front();
+  --num_injected_tasks_;
+  return task;
+}
+
+bool WorkStealingThreadPool::HasWork() const {
+  if (num_injected_tasks_ > 0)
+    return true;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (!workers_[i]->deque()->IsEmpty())
+      return true;
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::WakeUpWorker() {
+  if (num_idle_workers_ > 0) {
+    AutoLock locker(lock_);
+    work_available_cv_.Signal();
+  }
+}
+
+void WorkStealingThreadPool::RunTask(OnceClosure* task) {
+  task->Run();
+  delete task;
+  if (--outstanding_tasks_ == 0) {
+    AutoLock locker(lock_);
+    all_done_cv_.Broadcast();
+  }
+}
+
+WorkStealingThreadPool::Worker* WorkStealingThreadPool::CurrentWorker() const {
+  Worker* worker = static_cast<Worker*>(g_current_worker.Get().Get());
+  if (worker != NULL && worker->pool() == this)
+    return worker;
+  return NULL;
+}
+
+}  // namespace base
@@ -0,0 +1,139 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// WorkStealingThreadPool runs Closures on a fixed set of joinable worker
+// threads.  Every worker owns a lock-free Chase-Lev deque of tasks: tasks
+// posted from a worker thread go to the bottom of its own deque and are
+// popped LIFO by that worker, while idle workers steal from the top of the
+// other deques.  Tasks posted from any other thread go to a shared injection
+// queue, which every worker also checks now and then while it has work of
+// its own so that those tasks aren't starved.
+//
+// A worker out of work spins a little, looking for tasks to steal, before it
+// parks on a condition variable.  Posting only wakes a parked worker when no
+// other is spinning, and a spinner which finds work wakes the next one, so
+// a burst of tasks doesn't pay a wake up per task.
+//
+// Unlike DelegateSimpleThreadPool, running tasks may post more tasks, so a
+// recursive job (such as walking a directory tree) fans out over all the
+// workers without a central queue.  The number of queued tasks may be bounded,
+// once the bound is reached PostTask() runs the task on the calling thread,
+// which throttles the producer without ever blocking a worker.
+//
+// Example:
+//
+//   base::WorkStealingThreadPool pool("scan", 0, 0);
+//   pool.Start();
+//   pool.PostTask(base::Bind(&ScanDirectory, root));
+//   pool.JoinAll();  // Waits for ScanDirectory and all the work it posted.
+
+#ifndef BASE_THREADING_WORK_STEALING_THREAD_POOL_H_
+#define BASE_THREADING_WORK_STEALING_THREAD_POOL_H_
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/once_closure.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+
+namespace base {
+
+class BASE_EXPORT WorkStealingThreadPool {
+ public:
+  // Creates a pool of |num_threads| workers, or one worker per processor if
+  // |num_threads| is not positive.  At most |max_pending_tasks| tasks are
+  // queued at once, 0 means unbounded.  Threads are created by Start().
+  WorkStealingThreadPool(const std::string& name_prefix,
+                         int num_threads,
+                         size_t max_pending_tasks);
+
+  // Calls JoinAll() if the pool was started and not joined yet.
+  ~WorkStealingThreadPool();
+
+  // Starts all of the worker threads.  It is safe to PostTask() before.
+  void Start();
+
+  // Queues |task|.  Safe to call from any thread, including from a task
+  // running on this pool.
+  void PostTask(const Closure& task);
+  void PostTask(OnceClosure task);
+
+  // Blocks until every posted task has finished, including the tasks posted
+  // by running tasks.
+  void Wait();
+
+  // Wait()s, then stops and joins all of the worker threads.
+  void JoinAll();
+
+  int num_threads() const { return static_cast<int>(workers_.size()); }
+
+  // Returns the pool running a task on the current thread, NULL if the
+  // thread isn't a worker.
+  static WorkStealingThreadPool* Current();
+
+ private:
+  class Worker;
+
+  // Body of every worker thread.
+  void WorkerMain(Worker* self);
+
+  // Takes a task from |self|'s deque or the injection queue, or steals one
+  // from another worker.  Returns NULL if none was found.
+  OnceClosure* FindTask(Worker* self);
+
+  // FindTask() for a while, unless enough workers are spinning already.
+  OnceClosure* Spin(Worker* self);
+
+  OnceClosure* TakeInjectedTask();
+
+  // Whether a task is queued anywhere.  Only reliable with |lock_| held and
+  // after incrementing |num_idle_workers_|, then a task posted later wakes
+  // the worker up.
+  bool HasWork() const;
+
+  // Signals a parked worker, if any.
+  void WakeUpWorker();
+
+  void RunTask(OnceClosure* task);
+
+  // Returns the worker of this pool running on the current thread, or NULL.
+  Worker* CurrentWorker() const;
+
+  const std::string name_prefix_;
+  const size_t max_pending_tasks_;
+  std::vector<Worker*> workers_;
+
+  // Queued tasks, only counted if |max_pending_tasks_| isn't 0.
+  std::atomic<size_t> pending_tasks_;
+  // Tasks posted and not finished yet.
+  std::atomic<size_t> outstanding_tasks_;
+  // Workers parked on |work_available_cv_|.
+  std::atomic<int> num_idle_workers_;
+  // Workers looking for a task before they park.
+  std::atomic<int> num_spinning_workers_;
+
+  // Tasks posted from outside the pool.
+  Lock injection_lock_;
+  std::deque<OnceClosure*> injected_tasks_;
+  // Size of |injected_tasks_|, read without the lock.
+  std::atomic<size_t> num_injected_tasks_;
+
+  Lock lock_;  // Protects the variables below and guards the conditions.
+  ConditionVariable work_available_cv_;
+  ConditionVariable all_done_cv_;
+  bool started_;
+  bool shutdown_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+};
+
+}  // namespace base
+
+#endif  // BASE_THREADING_WORK_STEALING_THREAD_POOL_H_
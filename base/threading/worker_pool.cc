@@ -4,6 +4,8 @@
 
 #include "base/threading/worker_pool.h"
 
+#include <utility>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/lazy_instance.h"
@@ -41,6 +43,9 @@ class WorkerPoolTaskRunner : public TaskRunner {
   virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
                                const Closure& task,
                                TimeDelta delay) OVERRIDE;
+  virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
+                               OnceClosure task,
+                               TimeDelta delay) OVERRIDE;
   virtual bool RunsTasksOnCurrentThread() const OVERRIDE;
 
  private:
@@ -50,7 +55,7 @@ class WorkerPoolTaskRunner : public TaskRunner {
   // zero because non-zero delays are not supported.
   bool PostDelayedTaskAssertZeroDelay(
       const tracked_objects::Location& from_here,
-      const Closure& task,
+      OnceClosure task,
       base::TimeDelta delay);
 
   const bool tasks_are_slow_;
@@ -72,17 +77,24 @@ bool WorkerPoolTaskRunner::PostDelayedTask(
   return PostDelayedTaskAssertZeroDelay(from_here, task, delay);
 }
 
+bool WorkerPoolTaskRunner::PostDelayedTask(
+    const tracked_objects::Location& from_here,
+    OnceClosure task,
+    TimeDelta delay) {
+  return PostDelayedTaskAssertZeroDelay(from_here, std::move(task), delay);
+}
+
 bool WorkerPoolTaskRunner::RunsTasksOnCurrentThread() const {
   return WorkerPool::RunsTasksOnCurrentThread();
 }
 
 bool WorkerPoolTaskRunner::PostDelayedTaskAssertZeroDelay(
     const tracked_objects::Location& from_here,
-    const Closure& task,
+    OnceClosure task,
     base::TimeDelta delay) {
   DCHECK_EQ(delay.InMillisecondsRoundedUp(), 0)
       << "WorkerPoolTaskRunner does not support non-zero delays";
-  return WorkerPool::PostTask(from_here, task, tasks_are_slow_);
+  return WorkerPool::PostTask(from_here, std::move(task), tasks_are_slow_);
 }
 
 struct TaskRunnerHolder {
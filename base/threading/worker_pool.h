@@ -8,6 +8,7 @@
 #include "base/base_export.h"
 #include "base/callback_forward.h"
 #include "base/memory/ref_counted.h"
+#include "base/once_closure.h"
 
 class Task;
 
@@ -36,6 +37,10 @@ class BASE_EXPORT WorkerPool {
   static bool PostTask(const tracked_objects::Location& from_here,
                        const base::Closure& task, bool task_is_slow);
 
+  // The same for a move-only task, see base/once_closure.h.
+  static bool PostTask(const tracked_objects::Location& from_here,
+                       OnceClosure task, bool task_is_slow);
+
   // Just like MessageLoopProxy::PostTaskAndReply, except the destination
   // for |task| is a worker thread and you can specify |task_is_slow| just
   // like you can for PostTask above.
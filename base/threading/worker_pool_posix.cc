@@ -4,6 +4,9 @@
 
 #include "base/threading/worker_pool_posix.h"
 
+#include <atomic>
+#include <utility>
+
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/lazy_instance.h"
@@ -12,6 +15,7 @@
 #include "base/stringprintf.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread_local.h"
+#include "base/threading/work_stealing_thread_pool.h"
 #include "base/threading/worker_pool.h"
 
 namespace base {
@@ -31,21 +35,35 @@ const int kWorkerThreadStackSize = 256 * 1024;
 const int kWorkerThreadStackSize = 128 * 1024;
 #endif
 
+// Short tasks run on a work-stealing pool with one thread per processor, so
+// that a fan-out of small tasks doesn't serialize on a single queue.  Slow
+// tasks may block for a long time, they keep the dynamic pool which adds
+// threads on demand and never holds up the short ones.
+// The work-stealing pool of WorkerPoolImpl, NULL until it is created.
+std::atomic<base::WorkStealingThreadPool*> g_fast_pool(NULL);
+
 class WorkerPoolImpl {
  public:
   WorkerPoolImpl();
   ~WorkerPoolImpl();
 
   void PostTask(const tracked_objects::Location& from_here,
-                const base::Closure& task, bool task_is_slow);
+                base::OnceClosure task, bool task_is_slow);
 
  private:
   scoped_refptr<base::PosixDynamicThreadPool> pool_;
+
+  // Never deleted: like the threads of |pool_|, its workers aren't joined
+  // so that exiting doesn't wait for their tasks.
+  base::WorkStealingThreadPool* fast_pool_;
 };
 
 WorkerPoolImpl::WorkerPoolImpl()
     : pool_(new base::PosixDynamicThreadPool("WorkerPool",
-                                             kIdleSecondsBeforeExit)) {
+                                             kIdleSecondsBeforeExit)),
+      fast_pool_(new base::WorkStealingThreadPool("WorkerPool", 0, 0)) {
+  fast_pool_->Start();
+  g_fast_pool.store(fast_pool_, std::memory_order_release);
 }
 
 WorkerPoolImpl::~WorkerPoolImpl() {
@@ -53,8 +71,11 @@ WorkerPoolImpl::~WorkerPoolImpl() {
 }
 
 void WorkerPoolImpl::PostTask(const tracked_objects::Location& from_here,
-                              const base::Closure& task, bool task_is_slow) {
-  pool_->PostTask(from_here, task);
+                              base::OnceClosure task, bool task_is_slow) {
+  if (task_is_slow)
+    pool_->PostTask(from_here, std::move(task));
+  else
+    fast_pool_->PostTask(std::move(task));
 }
 
 base::LazyInstance<WorkerPoolImpl> g_lazy_worker_pool =
@@ -100,13 +121,24 @@ void WorkerThread::ThreadMain() {
 // static
 bool WorkerPool::PostTask(const tracked_objects::Location& from_here,
                           const base::Closure& task, bool task_is_slow) {
-  g_lazy_worker_pool.Pointer()->PostTask(from_here, task, task_is_slow);
+  return PostTask(from_here, OnceClosure(task), task_is_slow);
+}
+
+// static
+bool WorkerPool::PostTask(const tracked_objects::Location& from_here,
+                          OnceClosure task, bool task_is_slow) {
+  g_lazy_worker_pool.Pointer()->PostTask(from_here, std::move(task),
+                                         task_is_slow);
   return true;
 }
 
 // static
 bool WorkerPool::RunsTasksOnCurrentThread() {
-  return g_worker_pool_running_on_this_thread.Get().Get();
+  if (g_worker_pool_running_on_this_thread.Get().Get())
+    return true;
+  WorkStealingThreadPool* current = WorkStealingThreadPool::Current();
+  return current != NULL &&
+         current == g_fast_pool.load(std::memory_order_acquire);
 }
 
 PosixDynamicThreadPool::PosixDynamicThreadPool(
@@ -135,8 +167,8 @@ void PosixDynamicThreadPool::Terminate() {
 
 void PosixDynamicThreadPool::PostTask(
     const tracked_objects::Location& from_here,
-    const base::Closure& task) {
-  PendingTask pending_task(from_here, task);
+    OnceClosure task) {
+  PendingTask pending_task(from_here, std::move(task));
   AddTask(&pending_task);
 }
 
@@ -145,8 +177,7 @@ void PosixDynamicThreadPool::AddTask(PendingTask* pending_task) {
   DCHECK(!terminated_) <<
       "This thread pool is already terminated.  Do not post new tasks.";
 
-  pending_tasks_.push(*pending_task);
-  pending_task->task.Reset();
+  pending_tasks_.push(std::move(*pending_task));
 
   // We have enough worker threads.
   if (static_cast<size_t>(num_idle_threads_) >= pending_tasks_.size()) {
@@ -164,7 +195,7 @@ PendingTask PosixDynamicThreadPool::WaitForTask() {
   AutoLock locked(lock_);
 
   if (terminated_)
-    return PendingTask(FROM_HERE, base::Closure());
+    return PendingTask(FROM_HERE, OnceClosure());
 
   if (pending_tasks_.empty()) {  // No work available, wait for work.
     num_idle_threads_++;
@@ -178,11 +209,11 @@ PendingTask PosixDynamicThreadPool::WaitForTask() {
     if (pending_tasks_.empty()) {
       // We waited for work, but there's still no work.  Return NULL to signal
       // the thread to terminate.
-      return PendingTask(FROM_HERE, base::Closure());
+      return PendingTask(FROM_HERE, OnceClosure());
     }
   }
 
-  PendingTask pending_task = pending_tasks_.front();
+  PendingTask pending_task = std::move(pending_tasks_.front());
   pending_tasks_.pop();
   return pending_task;
 }
@@ -58,7 +58,7 @@ class BASE_EXPORT PosixDynamicThreadPool
 
   // Adds |task| to the thread pool.
   void PostTask(const tracked_objects::Location& from_here,
-                const Closure& task);
+                OnceClosure task);
 
   // Worker thread method to wait for up to |idle_seconds_before_exit| for more
   // work from the thread pool.  Returns NULL if no work is available.
@@ -70,7 +70,7 @@ class BASE_EXPORT PosixDynamicThreadPool
 
   ~PosixDynamicThreadPool();
 
-  // Adds pending_task to the thread pool.  This function will clear
+  // Moves pending_task to the thread pool.  This function will clear
   // |pending_task->task|.
   void AddTask(PendingTask* pending_task);
 
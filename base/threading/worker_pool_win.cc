@@ -4,6 +4,8 @@
 
 #include "base/threading/worker_pool.h"
 
+#include <utility>
+
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/logging.h"
@@ -52,6 +54,13 @@ bool WorkerPool::PostTask(const tracked_objects::Location& from_here,
   return PostTaskInternal(pending_task, task_is_slow);
 }
 
+// static
+bool WorkerPool::PostTask(const tracked_objects::Location& from_here,
+                          OnceClosure task, bool task_is_slow) {
+  PendingTask* pending_task = new PendingTask(from_here, std::move(task));
+  return PostTaskInternal(pending_task, task_is_slow);
+}
+
 // static
 bool WorkerPool::RunsTasksOnCurrentThread() {
   return g_worker_pool_running_on_this_thread.Get().Get();
@@ -5,6 +5,8 @@
 #include "base/timer.h"
 
 #include "base/logging.h"
+#include "base/message_loop.h"
+#include "base/pending_task.h"
 #include "base/single_thread_task_runner.h"
 #include "base/thread_task_runner_handle.h"
 #include "base/threading/platform_thread.h"
@@ -56,8 +58,39 @@ class BaseTimerTaskInternal {
   Timer* timer_;
 };
 
+// TimerWheelTask is the task of a Timer in the timer wheel of its MessageLoop.
+// The Timer owns it and moves it instead of posting a new one.
+class TimerWheelTask : public WheelPendingTask {
+ public:
+  explicit TimerWheelTask(Timer* timer)
+      : WheelPendingTask(PendingTask(FROM_HERE, base::OnceClosure())),
+        timer_(timer) {
+  }
+
+  virtual bool IsOwnedByLoop() const OVERRIDE {
+    return false;
+  }
+
+  // The task stays for the next time the Timer fires.
+  virtual PendingTask TakePendingTask() OVERRIDE {
+    return PendingTask(pending_task.posted_from,
+                       base::BindOnce(&Timer::RunScheduledTask, timer_),
+                       pending_task.delayed_run_time,
+                       pending_task.nestable);
+  }
+
+  // The MessageLoop is going away, like a deleted BaseTimerTaskInternal.
+  virtual void Drop() OVERRIDE {
+    timer_->Stop();
+  }
+
+ private:
+  Timer* timer_;
+};
+
 Timer::Timer(bool retain_user_task, bool is_repeating)
     : scheduled_task_(NULL),
+      wheel_task_(NULL),
       thread_id_(0),
       is_repeating_(is_repeating),
       retain_user_task_(retain_user_task),
@@ -69,6 +102,7 @@ Timer::Timer(const tracked_objects::Location& posted_from,
              const base::Closure& user_task,
              bool is_repeating)
     : scheduled_task_(NULL),
+      wheel_task_(NULL),
       posted_from_(posted_from),
       delay_(delay),
       user_task_(user_task),
@@ -80,6 +114,7 @@ Timer::Timer(const tracked_objects::Location& posted_from,
 
 Timer::~Timer() {
   StopAndAbandon();
+  delete wheel_task_;
 }
 
 void Timer::Start(const tracked_objects::Location& posted_from,
@@ -91,6 +126,9 @@ void Timer::Start(const tracked_objects::Location& posted_from,
 
 void Timer::Stop() {
   is_running_ = false;
+  // Unlike a posted task, the one in the timer wheel can be taken out.
+  if (wheel_task_ && wheel_task_->IsScheduled())
+    wheel_task_->wheel()->Cancel(wheel_task_);
   if (!retain_user_task_)
     user_task_.Reset();
 }
@@ -130,11 +168,21 @@ void Timer::SetTaskInfo(const tracked_objects::Location& posted_from,
 void Timer::PostNewScheduledTask(TimeDelta delay) {
   DCHECK(scheduled_task_ == NULL);
   is_running_ = true;
-  scheduled_task_ = new BaseTimerTaskInternal(this);
-  ThreadTaskRunnerHandle::Get()->PostDelayedTask(posted_from_,
-      base::Bind(&BaseTimerTaskInternal::Run, base::Owned(scheduled_task_)),
-      delay);
-  scheduled_run_time_ = desired_run_time_ = TimeTicks::Now() + delay;
+  MessageLoop* loop = MessageLoop::current();
+  if (loop && loop->delayed_task_backend() == MessageLoop::DELAYED_TASK_WHEEL) {
+    // Reset() always ends here, the task is moved in place.
+    if (!wheel_task_)
+      wheel_task_ = new TimerWheelTask(this);
+    wheel_task_->pending_task.posted_from = posted_from_;
+    scheduled_run_time_ = desired_run_time_ = TimeTicks::Now() + delay;
+    loop->ScheduleWheelTask(wheel_task_, scheduled_run_time_);
+  } else {
+    scheduled_task_ = new BaseTimerTaskInternal(this);
+    ThreadTaskRunnerHandle::Get()->PostDelayedTask(posted_from_,
+        base::Bind(&BaseTimerTaskInternal::Run, base::Owned(scheduled_task_)),
+        delay);
+    scheduled_run_time_ = desired_run_time_ = TimeTicks::Now() + delay;
+  }
   // Remember the thread ID that posts the first task -- this will be verified
   // later when the task is abandoned to detect misuse from multiple threads.
   if (!thread_id_)
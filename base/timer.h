@@ -61,12 +61,16 @@ class MessageLoop;
 namespace base {
 
 class BaseTimerTaskInternal;
+class TimerWheelTask;
 
 //-----------------------------------------------------------------------------
 // This class wraps MessageLoop::PostDelayedTask to manage delayed and repeating
 // tasks. It must be destructed on the same thread that starts tasks. There are
 // DCHECKs in place to verify this.
 //
+// On a MessageLoop whose delayed tasks wait in a timer wheel, the timer keeps
+// a single task there and moves it on Reset() or cancels it on Stop().
+//
 class BASE_EXPORT Timer {
  public:
   // Construct a timer in repeating or one-shot mode. Start or SetTaskInfo must
@@ -118,10 +122,12 @@ class BASE_EXPORT Timer {
 
  private:
   friend class BaseTimerTaskInternal;
+  friend class TimerWheelTask;
 
   // Allocates a new scheduled_task_ and posts it on the current MessageLoop
   // with the given |delay|. scheduled_task_ must be NULL. scheduled_run_time_
-  // and desired_run_time_ are reset to Now() + delay.
+  // and desired_run_time_ are reset to Now() + delay. If the MessageLoop has
+  // a timer wheel, wheel_task_ is moved there instead.
   void PostNewScheduledTask(TimeDelta delay);
 
   // Disable scheduled_task_ and abandon it so that it no longer refers back to
@@ -141,6 +147,10 @@ class BASE_EXPORT Timer {
   // RunScheduledTask() at scheduled_run_time_.
   BaseTimerTaskInternal* scheduled_task_;
 
+  // The task in the timer wheel of the MessageLoop, created the first time it
+  // is needed and reused afterwards.  It waits there while it is scheduled.
+  TimerWheelTask* wheel_task_;
+
   // Location in user code.
   tracked_objects::Location posted_from_;
   // Delay requested by user.
@@ -0,0 +1,256 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/timer_wheel.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/bits.h"
+#include "base/logging.h"
+
+namespace base {
+
+TimerWheel::Entry::Entry()
+    : wheel_(NULL),
+      tick_(0),
+      sequence_(0),
+      slot_(-1) {
+}
+
+TimerWheel::Entry::~Entry() {
+  if (wheel_)
+    wheel_->Cancel(this);
+}
+
+TimerWheel::TimerWheel(TimeTicks origin, TimeDelta resolution)
+    : origin_(origin),
+      resolution_(resolution),
+      current_(0),
+      next_sequence_(0),
+      size_(0) {
+  DCHECK(resolution > TimeDelta());
+  memset(occupied_, 0, sizeof(occupied_));
+}
+
+TimerWheel::~TimerWheel() {
+  std::vector<Entry*> entries;
+  Clear(&entries);
+}
+
+void TimerWheel::Schedule(Entry* entry, TimeTicks deadline) {
+  DCHECK(entry->wheel_ == NULL || entry->wheel_ == this);
+  if (entry->wheel_) {
+    Unlink(entry);
+  } else {
+    entry->wheel_ = this;
+    size_++;
+  }
+
+  entry->deadline_ = deadline;
+  entry->sequence_ = next_sequence_++;
+  entry->tick_ = TickCeil(deadline);
+  if (entry->tick_ < current_) {
+    // Its tick is processed already.
+    entry->slot_ = kExpiredSlot;
+    expired_.Append(entry);
+    return;
+  }
+  Link(entry);
+}
+
+void TimerWheel::Cancel(Entry* entry) {
+  if (!entry->wheel_)
+    return;
+  DCHECK_EQ(this, entry->wheel_);
+  Unlink(entry);
+  entry->wheel_ = NULL;
+  size_--;
+}
+
+void TimerWheel::Advance(TimeTicks now) {
+  uint64 target = TickFloor(now);
+  while (current_ <= target) {
+    uint64 tick = NextEventTick();
+    if (tick > target) {
+      current_ = target + 1;
+      break;
+    }
+    current_ = tick;
+    ProcessTick(tick);
+    current_ = tick + 1;
+  }
+}
+
+TimerWheel::Entry* TimerWheel::PopExpired() {
+  if (!HasExpired())
+    return NULL;
+  Entry* entry = expired_.head()->value();
+  entry->RemoveFromList();
+  entry->wheel_ = NULL;
+  size_--;
+  return entry;
+}
+
+TimeTicks TimerWheel::NextWakeUp() const {
+  uint64 tick = NextEventTick();
+  if (tick == kuint64max)
+    return TimeTicks();
+  return origin_ + resolution_ * static_cast<int64>(tick);
+}
+
+void TimerWheel::Clear(std::vector<Entry*>* entries) {
+  size_t first = entries->size();
+  while (HasExpired())
+    entries->push_back(PopExpired());
+  for (int slot = 0; slot < kSlots; slot++) {
+    LinkedList<Entry>& list = slots_[slot];
+    while (list.head() != list.end()) {
+      Entry* entry = list.head()->value();
+      entry->RemoveFromList();
+      entry->wheel_ = NULL;
+      entries->push_back(entry);
+    }
+  }
+  memset(occupied_, 0, sizeof(occupied_));
+  size_ = 0;
+  std::sort(entries->begin() + first, entries->end(), RunsBefore);
+}
+
+// static
+bool TimerWheel::RunsBefore(const Entry* a, const Entry* b) {
+  if (a->deadline_ != b->deadline_)
+    return a->deadline_ < b->deadline_;
+  return a->sequence_ < b->sequence_;
+}
+
+uint64 TimerWheel::TickFloor(TimeTicks time) const {
+  if (time <= origin_)
+    return 0;
+  return (time - origin_).ToInternalValue() / resolution_.ToInternalValue();
+}
+
+uint64 TimerWheel::TickCeil(TimeTicks time) const {
+  if (time <= origin_)
+    return 0;
+  int64 resolution = resolution_.ToInternalValue();
+  return ((time - origin_).ToInternalValue() + resolution - 1) / resolution;
+}
+
+void TimerWheel::Link(Entry* entry) {
+  DCHECK_GE(entry->tick_, current_);
+  uint64 tick = entry->tick_;
+  uint64 delta = tick - current_;
+  int slot;
+
+  if (delta < kLevel0Slots) {
+    slot = static_cast<int>(tick & (kLevel0Slots - 1));
+  } else {
+    int level = 1;
+    while (level < kLevels &&
+           delta >= (GG_UINT64_C(1) << LevelShift(level + 1)))
+      level++;
+    if (level == kLevels) {
+      // Too far, wait in the farthest slot.
+      level = kLevels - 1;
+      tick = current_ + (GG_UINT64_C(1) << LevelShift(kLevels)) - 1;
+    }
+    slot = kLevel0Slots + (level - 1) * kLevelSlots +
+        static_cast<int>((tick >> LevelShift(level)) & (kLevelSlots - 1));
+  }
+
+  entry->slot_ = slot;
+  slots_[slot].Append(entry);
+  MarkSlot(slot);
+}
+
+void TimerWheel::Unlink(Entry* entry) {
+  entry->RemoveFromList();
+  int slot = entry->slot_;
+  if (slot != kExpiredSlot && slots_[slot].head() == slots_[slot].end())
+    ClearSlot(slot);
+}
+
+uint64 TimerWheel::NextEventTick() const {
+  uint64 next = kuint64max;
+
+  // Level 0 holds the ticks current_ to current_ + 255, look for the first
+  // one from current_ around the ring.
+  int pos = static_cast<int>(current_ & (kLevel0Slots - 1));
+  const int level0_words = kLevel0Slots / 64;
+  for (int i = 0; i <= level0_words; i++) {
+    int index = ((pos / 64) + i) % level0_words;
+    uint64 word = occupied_[index];
+    if (i == 0)
+      word &= ~GG_UINT64_C(0) << (pos % 64);
+    else if (i == level0_words)
+      word &= (GG_UINT64_C(1) << (pos % 64)) - 1;
+    if (word) {
+      int slot = index * 64 + bits::CountTrailingZeros64(word);
+      next = current_ + ((slot - pos) & (kLevel0Slots - 1));
+      break;
+    }
+  }
+
+  // A slot of a higher level is due when the time reaches its start.
+  for (int level = 1; level < kLevels; level++) {
+    uint64 word = occupied_[level0_words + level - 1];
+    if (!word)
+      continue;
+    int shift = LevelShift(level);
+    uint64 start = (current_ + (GG_UINT64_C(1) << shift) - 1) >> shift;
+    int first = static_cast<int>(start & (kLevelSlots - 1));
+    uint64 rotated = word >> first;
+    if (first)
+      rotated |= word << (64 - first);
+    uint64 tick = (start + bits::CountTrailingZeros64(rotated)) << shift;
+    next = std::min(next, tick);
+  }
+  return next;
+}
+
+void TimerWheel::ProcessTick(uint64 tick) {
+  // A level starts a new slot only when the levels below it wrap around.
+  for (int level = 1; level < kLevels; level++) {
+    int shift = LevelShift(level);
+    if (tick & ((GG_UINT64_C(1) << shift) - 1))
+      break;
+    int slot = kLevel0Slots + (level - 1) * kLevelSlots +
+        static_cast<int>((tick >> shift) & (kLevelSlots - 1));
+    LinkedList<Entry>& list = slots_[slot];
+    while (list.head() != list.end()) {
+      Entry* entry = list.head()->value();
+      entry->RemoveFromList();
+      Link(entry);
+      DCHECK_NE(slot, entry->slot_);
+    }
+    ClearSlot(slot);
+  }
+  ExpireSlot(static_cast<int>(tick & (kLevel0Slots - 1)));
+}
+
+void TimerWheel::ExpireSlot(int slot) {
+  LinkedList<Entry>& list = slots_[slot];
+  if (list.head() == list.end())
+    return;
+
+  sort_buffer_.clear();
+  while (list.head() != list.end()) {
+    Entry* entry = list.head()->value();
+    entry->RemoveFromList();
+    sort_buffer_.push_back(entry);
+  }
+  ClearSlot(slot);
+
+  // The slot is one tick, cascades may have mixed the order of its entries.
+  if (sort_buffer_.size() > 1)
+    std::sort(sort_buffer_.begin(), sort_buffer_.end(), RunsBefore);
+  for (size_t i = 0; i < sort_buffer_.size(); i++) {
+    sort_buffer_[i]->slot_ = kExpiredSlot;
+    expired_.Append(sort_buffer_[i]);
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,181 @@
+// Copyright (c) 2025 wtcat. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// TimerWheel keeps timers in a hashed hierarchical timing wheel.  Adding,
+// cancelling and moving a timer are O(1) however many timers are pending,
+// and a timer which fires costs O(1) plus its share of the cascades.
+//
+// Time is counted in ticks of |resolution| since |origin|, and a deadline is
+// rounded up to its tick: a timer never fires early, but up to one tick
+// late.  Level 0 has a slot for each of the next 256 ticks, every further
+// level has 64 slots, each 64 times as wide as a slot of the level below.
+// When the time reaches a slot of a higher level its timers are spread over
+// the lower levels.  Timers beyond the last level (2^32 ticks, 49 days at
+// the default resolution) wait in its farthest slot until they fit.
+//
+// The timers are intrusive, nothing is allocated per timer.  The wheel isn't
+// thread safe.
+//
+// Example:
+//
+//   TimerWheel wheel(TimeTicks::Now());
+//   wheel.Schedule(&entry, TimeTicks::Now() + delay);
+//   ...
+//   wheel.Advance(TimeTicks::Now());
+//   while (TimerWheel::Entry* expired = wheel.PopExpired())
+//     Fire(expired);
+
+#ifndef BASE_TIMER_WHEEL_H_
+#define BASE_TIMER_WHEEL_H_
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/base_time.h"
+#include "base/basictypes.h"
+#include "base/linked_list.h"
+
+namespace base {
+
+class BASE_EXPORT TimerWheel {
+ public:
+  // A timer.  Embed it in the object to be notified, it is cancelled when
+  // destroyed.
+  class BASE_EXPORT Entry : public LinkNode<Entry> {
+   public:
+    Entry();
+    ~Entry();
+
+    // True from Schedule() until the entry is cancelled or popped.
+    bool IsScheduled() const { return wheel_ != NULL; }
+
+    // The deadline given to the last Schedule().
+    TimeTicks deadline() const { return deadline_; }
+
+    // The wheel the entry is scheduled in, NULL if it isn't.
+    TimerWheel* wheel() const { return wheel_; }
+
+   private:
+    friend class TimerWheel;
+
+    TimerWheel* wheel_;
+    TimeTicks deadline_;
+    uint64 tick_;
+    // Orders the entries which have the same deadline.
+    uint64 sequence_;
+    // Index of the slot the entry is linked in, or kExpiredSlot.
+    int slot_;
+
+    DISALLOW_COPY_AND_ASSIGN(Entry);
+  };
+
+  explicit TimerWheel(TimeTicks origin,
+                      TimeDelta resolution = TimeDelta::FromMilliseconds(1));
+
+  // The entries still scheduled are only unlinked, they belong to their
+  // owners.
+  ~TimerWheel();
+
+  // Schedules |entry| to expire at |deadline|.  An entry already scheduled
+  // in this wheel, expired or not, is moved.  A deadline before the last
+  // Advance() expires right away, after the entries already expired.
+  void Schedule(Entry* entry, TimeTicks deadline);
+
+  // Unschedules |entry|, expired or not.  No-op if it isn't scheduled.
+  void Cancel(Entry* entry);
+
+  // Moves the timers due at |now| to the expired list, sorted by deadline.
+  // Timers with the same deadline keep the order they were scheduled in.
+  void Advance(TimeTicks now);
+
+  // Takes the first expired entry, NULL if there is none.
+  Entry* PopExpired();
+
+  bool HasExpired() const { return expired_.head() != expired_.end(); }
+
+  // When Advance() has work to do next, null if no timer is waiting.  It is
+  // the earliest deadline rounded up to its tick, or the start of the first
+  // slot of a higher level to cascade when that is earlier.  The expired
+  // entries aren't counted.
+  TimeTicks NextWakeUp() const;
+
+  // Unschedules every entry, the expired ones included, and appends them to
+  // |entries| ordered by deadline.
+  void Clear(std::vector<Entry*>* entries);
+
+  // Number of scheduled entries, the expired ones included.
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  TimeDelta resolution() const { return resolution_; }
+
+ private:
+  enum {
+    kLevels = 5,
+    kLevel0Bits = 8,
+    kLevelBits = 6,
+    kLevel0Slots = 1 << kLevel0Bits,
+    kLevelSlots = 1 << kLevelBits,
+    kSlots = kLevel0Slots + (kLevels - 1) * kLevelSlots,
+    kExpiredSlot = kSlots,
+    kWords = kSlots / 64,
+  };
+
+  // Ticks covered by a slot of |level|, as a shift.
+  static int LevelShift(int level) {
+    return level == 0 ? 0 : kLevel0Bits + (level - 1) * kLevelBits;
+  }
+
+  // Orders by deadline, then by the order of the Schedule() calls.
+  static bool RunsBefore(const Entry* a, const Entry* b);
+
+  uint64 TickFloor(TimeTicks time) const;
+  uint64 TickCeil(TimeTicks time) const;
+
+  // Links |entry| in the slot for its tick, relative to current_.
+  void Link(Entry* entry);
+  void Unlink(Entry* entry);
+
+  // The first tick from current_ at which a slot must be processed,
+  // kuint64max if none.
+  uint64 NextEventTick() const;
+
+  // Processes the slots due at |tick|: cascades the higher levels which
+  // start a slot there and expires the timers of level 0.
+  void ProcessTick(uint64 tick);
+
+  // Moves the entries of |slot| to the expired list in order.
+  void ExpireSlot(int slot);
+
+  void MarkSlot(int slot) {
+    occupied_[slot / 64] |= GG_UINT64_C(1) << (slot % 64);
+  }
+  void ClearSlot(int slot) {
+    occupied_[slot / 64] &= ~(GG_UINT64_C(1) << (slot % 64));
+  }
+
+  const TimeTicks origin_;
+  const TimeDelta resolution_;
+
+  // The next tick to process, every tick before it is.
+  uint64 current_;
+
+  uint64 next_sequence_;
+  size_t size_;
+
+  LinkedList<Entry> slots_[kSlots];
+  // One bit per slot, set if the slot isn't empty.
+  uint64 occupied_[kWords];
+
+  LinkedList<Entry> expired_;
+
+  // Reused by ExpireSlot() to sort.
+  std::vector<Entry*> sort_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace base
+
+#endif  // BASE_TIMER_WHEEL_H_